@@ -1,3 +1,4 @@
+#include <chrono>
 #include <iostream>
 #include <iomanip>
 #include <vector>
@@ -45,6 +46,9 @@ bool parseOptions (int argc, char** argv, Arguments &info)
             "      Extract a file from the input archive.\n\n"
             "  bsatool extractall archivefile [output_directory]\n"
             "      Extract all files from the input archive.\n\n"
+            "  bsatool benchmark archivefile\n"
+            "      Read all files from the input archive through file streams and through a memory mapping,\n"
+            "      and compare the time taken.\n\n"
             "Allowed options");
 
     desc.add_options()
@@ -104,7 +108,7 @@ bool parseOptions (int argc, char** argv, Arguments &info)
     }
 
     info.mode = variables["mode"].as<std::string>();
-    if (!(info.mode == "list" || info.mode == "extract" || info.mode == "extractall"))
+    if (!(info.mode == "list" || info.mode == "extract" || info.mode == "extractall" || info.mode == "benchmark"))
     {
         std::cout << std::endl << "ERROR: invalid mode \"" << info.mode << "\"\n\n"
             << desc << std::endl;
@@ -147,6 +151,7 @@ bool parseOptions (int argc, char** argv, Arguments &info)
 int list(Bsa::BSAFile& bsa, Arguments& info);
 int extract(Bsa::BSAFile& bsa, Arguments& info);
 int extractAll(Bsa::BSAFile& bsa, Arguments& info);
+int benchmark(Arguments& info);
 
 int main(int argc, char** argv)
 {
@@ -156,6 +161,9 @@ int main(int argc, char** argv)
         if(!parseOptions (argc, argv, info))
             return 1;
 
+        if (info.mode == "benchmark")
+            return benchmark(info);
+
         // Open file
         Bsa::BSAFile bsa;
         bsa.open(info.filename);
@@ -289,3 +297,64 @@ int extractAll(Bsa::BSAFile& bsa, Arguments& info)
 
     return 0;
 }
+
+namespace
+{
+    /// Read every file in the archive to the end, the way resource loaders consume the streams
+    std::size_t readAll(Bsa::BSAFile& bsa)
+    {
+        std::size_t total = 0;
+        char buffer[4096];
+        const Bsa::BSAFile::FileList& list = bsa.getList();
+        for (Bsa::BSAFile::FileList::const_iterator it = list.begin(); it != list.end(); ++it)
+        {
+            Files::IStreamPtr data = bsa.getFile(&*it);
+            while (data->read(buffer, sizeof(buffer)) || data->gcount() > 0)
+                total += static_cast<std::size_t>(data->gcount());
+        }
+        return total;
+    }
+
+    void printResult(const std::string& name, std::size_t files, std::size_t bytes, std::chrono::steady_clock::duration time)
+    {
+        const double seconds = std::chrono::duration<double>(time).count();
+        std::ios::fmtflags f(std::cout.flags());
+        std::cout << std::setw(16) << std::left << name
+                  << std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms, "
+                  << std::setprecision(1) << (seconds > 0 ? files / seconds : 0) << " files/s, "
+                  << std::setprecision(1) << (seconds > 0 ? bytes / seconds / (1024 * 1024) : 0) << " MiB/s" << std::endl;
+        std::cout.flags(f);
+    }
+}
+
+int benchmark(Arguments& info)
+{
+    std::size_t files = 0;
+    std::size_t bytes = 0;
+
+    {
+        const auto start = std::chrono::steady_clock::now();
+        Bsa::BSAFile bsa;
+        bsa.open(info.filename);
+        files = bsa.getList().size();
+        std::cout << "Reading " << files << " files from " << info.filename << std::endl;
+        bytes = readAll(bsa);
+        printResult("file streams:", files, bytes, std::chrono::steady_clock::now() - start);
+    }
+
+    {
+        const auto start = std::chrono::steady_clock::now();
+        Bsa::BSAFile bsa;
+        bsa.open(info.filename, true);
+        const std::size_t mappedBytes = readAll(bsa);
+        printResult("memory mapped:", files, mappedBytes, std::chrono::steady_clock::now() - start);
+
+        if (mappedBytes != bytes)
+        {
+            std::cout << "ERROR: memory mapped archive returned " << mappedBytes << " bytes, expected " << bytes << std::endl;
+            return 3;
+        }
+    }
+
+    return 0;
+}
@@ -1,8 +1,10 @@
 ///Program to test .nif files both on the FileSystem and in BSA archives.
 
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
+#include <sstream>
 
 #include <components/nif/niffile.hpp>
 #include <components/files/constrainedfilestream.hpp>
@@ -43,6 +45,55 @@ bool isBSA(const std::string & filename)
     return hasExtension(filename,"bsa");
 }
 
+/// Totals over all nif files parsed in benchmark mode
+struct BenchmarkStats
+{
+    std::size_t mFiles = 0;
+    std::size_t mBytes = 0;
+    std::chrono::steady_clock::duration mParseTime = std::chrono::steady_clock::duration::zero();
+};
+
+/// Number of times every nif file is parsed, 0 to only check the files
+int benchmarkIterations = 0;
+BenchmarkStats benchmarkStats;
+
+/// Parse a nif file. In benchmark mode, the file is read into memory first
+/// and parsed repeatedly, so only the parsing is timed.
+void readNIF(Files::IStreamPtr stream, const std::string& name)
+{
+    if (benchmarkIterations <= 0)
+    {
+        Nif::NIFFile temp_nif(stream,name);
+        return;
+    }
+
+    std::stringstream contents;
+    contents << stream->rdbuf();
+    const std::string data = contents.str();
+
+    for (int i = 0; i < benchmarkIterations; ++i)
+    {
+        Files::IStreamPtr memoryStream = std::make_shared<std::istringstream>(data);
+        const auto start = std::chrono::steady_clock::now();
+        Nif::NIFFile temp_nif(memoryStream,name);
+        benchmarkStats.mParseTime += std::chrono::steady_clock::now() - start;
+    }
+
+    ++benchmarkStats.mFiles;
+    benchmarkStats.mBytes += data.size();
+}
+
+void printBenchmarkStats()
+{
+    const double seconds = std::chrono::duration<double>(benchmarkStats.mParseTime).count();
+    const double megabytes = double(benchmarkStats.mBytes) * benchmarkIterations / (1024 * 1024);
+    std::cout << "Parsed " << benchmarkStats.mFiles << " nif files (" << benchmarkStats.mBytes << " bytes) "
+              << benchmarkIterations << " times in " << seconds << " s" << std::endl;
+    if (seconds > 0)
+        std::cout << "Throughput: " << megabytes / seconds << " MiB/s, "
+                  << benchmarkStats.mFiles * benchmarkIterations / seconds << " files/s" << std::endl;
+}
+
 /// Check all the nif files in a given VFS::Archive
 /// \note Takes ownership!
 /// \note Can not read a bsa file inside of a bsa file.
@@ -61,7 +112,7 @@ void readVFS(VFS::Archive* anArchive,std::string archivePath = "")
             if(isNIF(name))
             {
             //           std::cout << "Decoding: " << name << std::endl;
-                Nif::NIFFile temp_nif(myManager.get(name),archivePath+name);
+                readNIF(myManager.get(name),archivePath+name);
             }
             else if(isBSA(name))
             {
@@ -85,10 +136,13 @@ bool parseOptions (int argc, char** argv, std::vector<std::string>& files)
     bpo::options_description desc("Ensure that OpenMW can use the provided NIF and BSA files\n\n"
         "Usages:\n"
         "  niftool <nif files, BSA files, or directories>\n"
-        "      Scan the file or directories for nif errors.\n\n"
+        "      Scan the file or directories for nif errors.\n"
+        "  niftool --benchmark <iterations> <nif files, BSA files, or directories>\n"
+        "      Parse every nif file the given number of times and report the parse throughput.\n\n"
         "Allowed options");
     desc.add_options()
         ("help,h", "print help message.")
+        ("benchmark,b", bpo::value<int>(&benchmarkIterations)->default_value(0), "parse every nif file this many times and report the parse throughput.")
         ("input-file", bpo::value< std::vector<std::string> >(), "input file")
         ;
 
@@ -143,7 +197,7 @@ int main(int argc, char **argv)
             if(isNIF(name))
             {
                 //std::cout << "Decoding: " << name << std::endl;
-                Nif::NIFFile temp_nif(Files::openConstrainedFileStream(name.c_str()),name);
+                readNIF(Files::openConstrainedFileStream(name.c_str()),name);
              }
              else if(isBSA(name))
              {
@@ -165,5 +219,8 @@ int main(int argc, char **argv)
             std::cerr << "ERROR, an exception has occurred:  " << e.what() << std::endl;
         }
      }
+
+     if (benchmarkIterations > 0)
+         printBenchmarkStats();
      return 0;
 }
@@ -27,6 +27,8 @@
 #include <components/compiler/extensions0.hpp>
 
 #include <components/sceneutil/workqueue.hpp>
+#include <components/sceneutil/skinning.hpp>
+#include <components/sceneutil/geometryupdatequeue.hpp>
 
 #include <components/files/configurationmanager.hpp>
 
@@ -44,6 +46,7 @@
 #include "mwworld/class.hpp"
 #include "mwworld/player.hpp"
 #include "mwworld/worldimp.hpp"
+#include "mwworld/contentfilekey.hpp"
 
 #include "mwrender/vismask.hpp"
 
@@ -188,6 +191,12 @@ bool OMW::Engine::frame(float frametime)
         stats->setAttribute(frameNumber, "physics_time_taken", osg::Timer::instance()->delta_s(beforePhysicsTick, afterPhysicsTick));
         stats->setAttribute(frameNumber, "physics_time_end", osg::Timer::instance()->delta_s(mStartTick, afterPhysicsTick));
 
+        if (mEnvironment.getStateManager()->getState()!=
+            MWBase::StateManager::State_NoGame)
+        {
+            mEnvironment.getWorld()->reportStats(frameNumber, *stats, mStartTick);
+        }
+
         stats->setAttribute(frameNumber, "world_time_begin", osg::Timer::instance()->delta_s(mStartTick, beforeWorldTick));
         stats->setAttribute(frameNumber, "world_time_taken", osg::Timer::instance()->delta_s(beforeWorldTick, afterWorldTick));
         stats->setAttribute(frameNumber, "world_time_end", osg::Timer::instance()->delta_s(mStartTick, afterWorldTick));
@@ -200,6 +209,18 @@ bool OMW::Engine::frame(float frametime)
             stats->setAttribute(frameNumber, "WorkThread", mWorkQueue->getNumActiveThreads());
         }
 
+        mEnvironment.getSoundManager()->reportStats(frameNumber, *stats);
+
+        // Geometries are updated while the previous frame was culled
+        if (mGeometryUpdateQueue && frameNumber > 0)
+        {
+            stats->setAttribute(frameNumber - 1, "skinning_time_begin", osg::Timer::instance()->delta_s(mStartTick, mGeometryUpdateQueue->getBeginTick()));
+            stats->setAttribute(frameNumber - 1, "skinning_time_taken", mGeometryUpdateQueue->getUpdateTime());
+            stats->setAttribute(frameNumber - 1, "skinning_time_end", osg::Timer::instance()->delta_s(mStartTick, mGeometryUpdateQueue->getEndTick()));
+            if (stats->collectStats("resource"))
+                stats->setAttribute(frameNumber - 1, "Geometry Update", mGeometryUpdateQueue->getNumUpdates());
+        }
+
     }
     catch (const std::exception& e)
     {
@@ -252,6 +273,9 @@ OMW::Engine::~Engine()
 
     mWorkQueue = nullptr;
 
+    SceneUtil::setGeometryUpdateQueue(nullptr);
+    mGeometryUpdateQueue = nullptr;
+
     mResourceSystem.reset();
 
     mViewer = nullptr;
@@ -466,7 +490,8 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
 
     mVFS.reset(new VFS::Manager(mFSStrict));
 
-    VFS::registerArchives(mVFS.get(), mFileCollections, mArchives, true);
+    VFS::registerArchives(mVFS.get(), mFileCollections, mArchives, true,
+        Settings::Manager::getBool("memory mapped archives", "General"));
 
     mResourceSystem.reset(new Resource::ResourceSystem(mVFS.get()));
     mResourceSystem->getSceneManager()->setUnRefImageDataAfterApply(false); // keep to Off for now to allow better state sharing
@@ -476,12 +501,23 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
         Settings::Manager::getString("texture mipmap", "General"),
         Settings::Manager::getInt("anisotropy", "General")
     );
+    if (Settings::Manager::getBool("converted scene cache", "General"))
+        mResourceSystem->getSceneManager()->setConvertedSceneCachePath((mCfgMgr.getCachePath() / "scenes").string());
+    SceneUtil::selectSkinningKernel(Settings::Manager::getString("skinning kernel", "General"));
 
     int numThreads = Settings::Manager::getInt("preload num threads", "Cells");
     if (numThreads <= 0)
         throw std::runtime_error("Invalid setting: 'preload num threads' must be >0");
     mWorkQueue = new SceneUtil::WorkQueue(numThreads);
 
+    int numSkinningThreads = Settings::Manager::getInt("skinning threads", "General");
+    if (numSkinningThreads > 0)
+    {
+        mGeometryUpdateQueue = new SceneUtil::GeometryUpdateQueue(numSkinningThreads);
+        mViewer->getCamera()->addCullCallback(new SceneUtil::GeometryUpdateQueue::JoinCallback(mGeometryUpdateQueue));
+        SceneUtil::setGeometryUpdateQueue(mGeometryUpdateQueue);
+    }
+
     // Create input and UI first to set up a bootstrapping environment for
     // showing a loading screen and keeping the window responsive while doing so
 
@@ -564,8 +600,14 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
     mScriptContext = new MWScript::CompilerContext (MWScript::CompilerContext::Type_Full);
     mScriptContext->setExtensions (&mExtensions);
 
-    mEnvironment.setScriptManager (new MWScript::ScriptManager (mEnvironment.getWorld()->getStore(), *mScriptContext, mWarningsMode,
-        mScriptBlacklistUse ? mScriptBlacklist : std::vector<std::string>()));
+    MWScript::ScriptManager* scriptManager = new MWScript::ScriptManager (mEnvironment.getWorld()->getStore(), *mScriptContext, mWarningsMode,
+        mScriptBlacklistUse ? mScriptBlacklist : std::vector<std::string>(),
+        std::max(1, Settings::Manager::getInt("script compile threads", "General")));
+    if (Settings::Manager::getBool("script cache", "General"))
+        scriptManager->setCache (std::unique_ptr<MWScript::ScriptCache> (new MWScript::ScriptCache (
+            (mCfgMgr.getUserDataPath() / "scripts.cache").string(), MWWorld::ContentFileKey (mFileCollections, mContentFiles,
+                Version::getOpenmwVersionDescription(mResDir.string())))));
+    mEnvironment.setScriptManager (scriptManager);
 
     // Create game mechanics system
     MWMechanics::MechanicsManager* mechanics = new MWMechanics::MechanicsManager;
@@ -576,7 +618,7 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
     mEnvironment.setDialogueManager (new MWDialogue::DialogueManager (mExtensions, mTranslationDataStorage));
 
     // scripts
-    if (mCompileAll)
+    if (mCompileAll || Settings::Manager::getBool("precompile scripts", "General"))
     {
         std::pair<int, int> result = mEnvironment.getScriptManager()->compileAll();
         if (result.first)
@@ -686,6 +728,10 @@ void OMW::Engine::go()
                                    "mechanics_time_taken", 1000.0, true, false, "mechanics_time_begin", "mechanics_time_end", 10000);
     statshandler->addUserStatsLine("Phys", osg::Vec4f(1.f, 1.f, 1.f, 1.f), osg::Vec4f(1.f, 1.f, 1.f, 1.f),
                                    "physics_time_taken", 1000.0, true, false, "physics_time_begin", "physics_time_end", 10000);
+    statshandler->addUserStatsLine("Move", osg::Vec4f(1.f, 1.f, 1.f, 1.f), osg::Vec4f(1.f, 1.f, 1.f, 1.f),
+                                   "physics_movement_time_taken", 1000.0, true, false, "physics_movement_time_begin", "physics_movement_time_end", 10000);
+    statshandler->addUserStatsLine("Skin", osg::Vec4f(1.f, 1.f, 1.f, 1.f), osg::Vec4f(1.f, 1.f, 1.f, 1.f),
+                                   "skinning_time_taken", 1000.0, true, false, "skinning_time_begin", "skinning_time_end", 10000);
     statshandler->addUserStatsLine("World", osg::Vec4f(1.f, 1.f, 1.f, 1.f), osg::Vec4f(1.f, 1.f, 1.f, 1.f),
                                    "world_time_taken", 1000.0, true, false, "world_time_begin", "world_time_end", 10000);
 
@@ -752,6 +798,9 @@ void OMW::Engine::go()
         mEnvironment.limitFrameRate(frameTimer.time_s());
     }
 
+    // A saved game that is still being written updates the settings and may fail
+    mEnvironment.getStateManager()->waitForSaving();
+
     // Save user settings
     settings.saveUser(settingspath);
 
@@ -60,6 +60,9 @@ namespace MWBase
             virtual void updateCell(const MWWorld::Ptr &old, const MWWorld::Ptr &ptr) = 0;
             ///< Moves an object to a new cell
 
+            virtual void updatePosition(const MWWorld::Ptr& ptr, const osg::Vec3f& oldPosition) = 0;
+            ///< \a ptr was moved from \a oldPosition other than by physics, e.g. teleported
+
             virtual void drop (const MWWorld::CellStore *cellStore) = 0;
             ///< Deregister all objects in the given cell.
 
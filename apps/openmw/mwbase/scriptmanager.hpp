@@ -49,6 +49,10 @@ namespace MWBase
             virtual const Compiler::Locals& getLocals (const std::string& name) = 0;
             ///< Return locals for script \a name.
 
+            virtual int getLocalIndex (const std::string& scriptId, const std::string& variable, char type) = 0;
+            ///< Return index of local variable \a variable of type \a type in script \a scriptId
+            /// (-1: variable does not exist). Resolved once per script and variable.
+
             virtual MWScript::GlobalScripts& getGlobalScripts() = 0;
    };
 }
@@ -12,6 +12,11 @@ namespace MWWorld
     class CellStore;
 }
 
+namespace osg
+{
+    class Stats;
+}
+
 namespace MWSound
 {
     class Sound;
@@ -175,6 +180,13 @@ namespace MWBase
             virtual void updatePtr(const MWWorld::ConstPtr& old, const MWWorld::ConstPtr& updated) = 0;
 
             virtual void clear() = 0;
+
+            virtual void preloadSounds(const MWWorld::CellStore *cell) = 0;
+            ///< Start loading the sounds that are likely to be played in the given cell,
+            /// so that they don't have to be decoded the first time they are played.
+
+            virtual void reportStats(unsigned int frameNumber, osg::Stats& stats) = 0;
+            ///< Report the sound loading stats since the last report.
     };
 }
 
@@ -64,6 +64,9 @@ namespace MWBase
             ///
             /// \note Slot must belong to the current character.
 
+            virtual void waitForSaving() = 0;
+            ///< Wait until a saved game that is being written is on the disk, and publish its slot.
+
             virtual void loadGame (const std::string& filepath) = 0;
             ///< Load a saved game directly from the given file path. This will search the CharacterManager
             /// for a Character containing this save file, and set this Character current if one was found.
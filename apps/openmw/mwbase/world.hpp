@@ -6,6 +6,8 @@
 #include <set>
 #include <deque>
 
+#include <osg/Timer>
+
 #include <components/esm/cellid.hpp>
 
 #include "../mwworld/ptr.hpp"
@@ -18,6 +20,7 @@ namespace osg
     class Matrixf;
     class Quat;
     class Image;
+    class Stats;
 }
 
 namespace Loading
@@ -376,6 +379,9 @@ namespace MWBase
             virtual void update (float duration, bool paused) = 0;
             virtual void updatePhysics (float duration, bool paused) = 0;
 
+            virtual void reportStats (unsigned int frameNumber, osg::Stats& stats, osg::Timer_t startTick) const = 0;
+            ///< Report the times of the phases of updatePhysics, relative to \a startTick.
+
             virtual void updateWindowManager () = 0;
 
             virtual MWWorld::Ptr placeObject (const MWWorld::ConstPtr& object, float cursorX, float cursorY, int amount) = 0;
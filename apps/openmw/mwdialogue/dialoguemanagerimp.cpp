@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <list>
 
+#include <osg/Timer>
+
 #include <components/debug/debuglog.hpp>
 
 #include <components/esm/loaddial.hpp>
@@ -60,6 +62,17 @@ namespace MWDialogue
         mIsInChoice = false;
         mGoodbye = false;
         mCompilerContext.setExtensions (&extensions);
+
+        const osg::Timer_t startTick = osg::Timer::instance()->tick();
+
+        const MWWorld::Store<ESM::Dialogue> &dialogs =
+            MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
+
+        for (MWWorld::Store<ESM::Dialogue>::iterator iter = dialogs.begin(); iter != dialogs.end(); ++iter)
+            mFilterIndex.add (*iter);
+
+        Log(Debug::Verbose) << "Indexed " << mFilterIndex.getNumInfos() << " dialogue infos in "
+            << osg::Timer::instance()->delta_m(startTick, osg::Timer::instance()->tick()) << " ms";
     }
 
     void DialogueManager::clear()
@@ -104,6 +117,8 @@ namespace MWDialogue
 
     bool DialogueManager::startDialogue (const MWWorld::Ptr& actor, ResponseCallback* callback)
     {
+        const osg::Timer_t startTick = osg::Timer::instance()->tick();
+
         updateGlobals();
 
         // Dialogue with dead actor (e.g. through script) should not be allowed.
@@ -130,7 +145,7 @@ namespace MWDialogue
         const MWWorld::Store<ESM::Dialogue> &dialogs =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
 
-        Filter filter (actor, mChoice, mTalkedTo);
+        Filter filter (actor, mChoice, mTalkedTo, &mFilterIndex);
 
         for (MWWorld::Store<ESM::Dialogue>::iterator it = dialogs.begin(); it != dialogs.end(); ++it)
         {
@@ -153,6 +168,9 @@ namespace MWDialogue
 
                     parseText (info->mResponse);
 
+                    Log(Debug::Verbose) << "Started dialogue with " << actor.getCellRef().getRefId() << " in "
+                        << osg::Timer::instance()->delta_m(startTick, osg::Timer::instance()->tick()) << " ms";
+
                     return true;
                 }
             }
@@ -235,7 +253,7 @@ namespace MWDialogue
 
     void DialogueManager::executeTopic (const std::string& topic, ResponseCallback* callback)
     {
-        Filter filter (mActor, mChoice, mTalkedTo);
+        Filter filter (mActor, mChoice, mTalkedTo, &mFilterIndex);
 
         const MWWorld::Store<ESM::Dialogue> &dialogues =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
@@ -308,7 +326,7 @@ namespace MWDialogue
         const MWWorld::Store<ESM::Dialogue> &dialogs =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
 
-        Filter filter (mActor, -1, mTalkedTo);
+        Filter filter (mActor, -1, mTalkedTo, &mFilterIndex);
 
         for (MWWorld::Store<ESM::Dialogue>::iterator iter = dialogs.begin(); iter != dialogs.end(); ++iter)
         {
@@ -382,7 +400,7 @@ namespace MWDialogue
         const ESM::Dialogue* dialogue = searchDialogue(mLastTopic);
         if (dialogue)
         {
-            Filter filter (mActor, mChoice, mTalkedTo);
+            Filter filter (mActor, mChoice, mTalkedTo, &mFilterIndex);
 
             if (dialogue->mType == ESM::Dialogue::Topic || dialogue->mType == ESM::Dialogue::Greeting)
             {
@@ -515,7 +533,7 @@ namespace MWDialogue
 
     bool DialogueManager::checkServiceRefused(ResponseCallback* callback)
     {
-        Filter filter (mActor, mChoice, mTalkedTo);
+        Filter filter (mActor, mChoice, mTalkedTo, &mFilterIndex);
 
         const MWWorld::Store<ESM::Dialogue> &dialogues =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
@@ -567,7 +585,7 @@ namespace MWDialogue
         const ESM::Dialogue *dial = store.get<ESM::Dialogue>().find(topic);
 
         const MWMechanics::CreatureStats& creatureStats = actor.getClass().getCreatureStats(actor);
-        Filter filter(actor, 0, creatureStats.hasTalkedToPlayer());
+        Filter filter(actor, 0, creatureStats.hasTalkedToPlayer(), &mFilterIndex);
         const ESM::DialInfo *info = filter.search(*dial, false);
         if(info != nullptr)
         {
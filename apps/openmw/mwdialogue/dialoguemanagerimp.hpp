@@ -14,6 +14,8 @@
 
 #include "../mwscript/compilercontext.hpp"
 
+#include "filterindex.hpp"
+
 namespace ESM
 {
     struct Dialogue;
@@ -31,6 +33,8 @@ namespace MWDialogue
 
             std::set<std::string, Misc::StringUtils::CiComp> mActorKnownTopics;
 
+            FilterIndex mFilterIndex;
+
             Translation::Storage& mTranslationDataStorage;
             MWScript::CompilerContext mCompilerContext;
             std::ostream mErrorStream;
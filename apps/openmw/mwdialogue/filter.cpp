@@ -148,9 +148,9 @@ bool MWDialogue::Filter::testPlayer (const ESM::DialInfo& info) const
     return true;
 }
 
-bool MWDialogue::Filter::testSelectStructs (const ESM::DialInfo& info) const
+bool MWDialogue::Filter::testSelectStructs (const FilterIndex::Info& info) const
 {
-    for (std::vector<ESM::DialInfo::SelectStruct>::const_iterator iter (info.mSelects.begin());
+    for (std::vector<SelectWrapper>::const_iterator iter (info.mSelects.begin());
         iter != info.mSelects.end(); ++iter)
         if (!testSelectStruct (*iter))
             return false;
@@ -612,9 +612,36 @@ bool MWDialogue::Filter::hasFactionRankReputationRequirements (const MWWorld::Pt
     return stats.getFactionReputation (factionId)>=faction.mData.mRankData[rank].mFactReaction;
 }
 
-MWDialogue::Filter::Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer)
-: mActor (actor), mChoice (choice), mTalkedToPlayer (talkedToPlayer)
-{}
+MWDialogue::Filter::Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer, const FilterIndex* index)
+: mActor (actor), mChoice (choice), mTalkedToPlayer (talkedToPlayer), mIndex (index)
+{
+    mIndexActor.mIsCreature = (mActor.getTypeName() != typeid (ESM::NPC).name());
+    mIndexActor.mId = Misc::StringUtils::lowerCase (mActor.getCellRef().getRefId());
+
+    if (!mIndexActor.mIsCreature)
+    {
+        const ESM::NPC* npc = mActor.get<ESM::NPC>()->mBase;
+        mIndexActor.mRace = Misc::StringUtils::lowerCase (npc->mRace);
+        mIndexActor.mClass = Misc::StringUtils::lowerCase (npc->mClass);
+        mIndexActor.mFaction = Misc::StringUtils::lowerCase (mActor.getClass().getPrimaryFaction (mActor));
+    }
+}
+
+std::vector<const MWDialogue::FilterIndex::Info *> MWDialogue::Filter::getCandidates (const ESM::Dialogue& dialogue) const
+{
+    std::vector<const FilterIndex::Info *> candidates;
+
+    if (mIndex && mIndex->getCandidates (dialogue, mIndexActor, candidates))
+        return candidates;
+
+    if (!mLocalIndex.getCandidates (dialogue, mIndexActor, candidates))
+    {
+        mLocalIndex.add (dialogue);
+        mLocalIndex.getCandidates (dialogue, mIndexActor, candidates);
+    }
+
+    return candidates;
+}
 
 const ESM::DialInfo* MWDialogue::Filter::search (const ESM::Dialogue& dialogue, const bool fallbackToInfoRefusal) const
 {
@@ -629,10 +656,10 @@ const ESM::DialInfo* MWDialogue::Filter::search (const ESM::Dialogue& dialogue,
 std::vector<const ESM::DialInfo *> MWDialogue::Filter::listAll (const ESM::Dialogue& dialogue) const
 {
     std::vector<const ESM::DialInfo *> infos;
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin(); iter!=dialogue.mInfo.end(); ++iter)
+    for (const FilterIndex::Info* candidate : getCandidates (dialogue))
     {
-        if (testActor (*iter))
-            infos.push_back(&*iter);
+        if (testActor (*candidate->mInfo))
+            infos.push_back(candidate->mInfo);
     }
     return infos;
 }
@@ -645,13 +672,13 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
     bool infoRefusal = false;
 
     // Iterate over topic responses to find a matching one
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin();
-        iter!=dialogue.mInfo.end(); ++iter)
+    for (const FilterIndex::Info* candidate : getCandidates (dialogue))
     {
-        if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter))
+        const ESM::DialInfo& info = *candidate->mInfo;
+        if (testActor (info) && testPlayer (info) && testSelectStructs (*candidate))
         {
-            if (testDisposition (*iter, invertDisposition)) {
-                infos.push_back(&*iter);
+            if (testDisposition (info, invertDisposition)) {
+                infos.push_back(&info);
                 if (!searchAll)
                     break;
             }
@@ -670,13 +697,15 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
 
         const ESM::Dialogue& infoRefusalDialogue = *dialogues.find ("Info Refusal");
 
-        for (ESM::Dialogue::InfoContainer::const_iterator iter = infoRefusalDialogue.mInfo.begin();
-            iter!=infoRefusalDialogue.mInfo.end(); ++iter)
-            if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter) && testDisposition(*iter, invertDisposition)) {
-                infos.push_back(&*iter);
+        for (const FilterIndex::Info* candidate : getCandidates (infoRefusalDialogue))
+        {
+            const ESM::DialInfo& info = *candidate->mInfo;
+            if (testActor (info) && testPlayer (info) && testSelectStructs (*candidate) && testDisposition(info, invertDisposition)) {
+                infos.push_back(&info);
                 if (!searchAll)
                     break;
             }
+        }
     }
 
     return infos;
@@ -684,10 +713,10 @@ std::vector<const ESM::DialInfo *> MWDialogue::Filter::list (const ESM::Dialogue
 
 bool MWDialogue::Filter::responseAvailable (const ESM::Dialogue& dialogue) const
 {
-    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin();
-        iter!=dialogue.mInfo.end(); ++iter)
+    for (const FilterIndex::Info* candidate : getCandidates (dialogue))
     {
-        if (testActor (*iter) && testPlayer (*iter) && testSelectStructs (*iter))
+        const ESM::DialInfo& info = *candidate->mInfo;
+        if (testActor (info) && testPlayer (info) && testSelectStructs (*candidate))
             return true;
     }
 
@@ -5,6 +5,8 @@
 
 #include "../mwworld/ptr.hpp"
 
+#include "filterindex.hpp"
+
 namespace ESM
 {
     struct DialInfo;
@@ -20,6 +22,12 @@ namespace MWDialogue
             MWWorld::Ptr mActor;
             int mChoice;
             bool mTalkedToPlayer;
+            const FilterIndex* mIndex;
+            FilterIndex::Actor mIndexActor;
+            mutable FilterIndex mLocalIndex; // Dialogues missing from mIndex
+
+            std::vector<const FilterIndex::Info *> getCandidates (const ESM::Dialogue& dialogue) const;
+            ///< Infos of \a dialogue that might be used on the actor, in their order.
 
             bool testActor (const ESM::DialInfo& info) const;
             ///< Is this the right actor for this \a info?
@@ -27,7 +35,7 @@ namespace MWDialogue
             bool testPlayer (const ESM::DialInfo& info) const;
             ///< Do the player and the cell the player is currently in match \a info?
 
-            bool testSelectStructs (const ESM::DialInfo& info) const;
+            bool testSelectStructs (const FilterIndex::Info& info) const;
             ///< Are all select structs matching?
 
             bool testDisposition (const ESM::DialInfo& info, bool invert=false) const;
@@ -53,7 +61,8 @@ namespace MWDialogue
 
         public:
 
-            Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer);
+            Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer, const FilterIndex* index = nullptr);
+            ///< \param index Infos to test, all infos of a dialogue are tested if it is not indexed.
 
             std::vector<const ESM::DialInfo *> list (const ESM::Dialogue& dialogue,
                 bool fallbackToInfoRefusal, bool searchAll, bool invertDisposition=false) const;
@@ -0,0 +1,89 @@
+#include "filterindex.hpp"
+
+#include <algorithm>
+
+#include <components/esm/loaddial.hpp>
+#include <components/misc/stringops.hpp>
+
+namespace
+{
+    void addCandidates (const std::unordered_map<std::string, std::vector<std::size_t> >& buckets, const std::string& key,
+        std::vector<std::size_t>& indices)
+    {
+        if (key.empty())
+            return;
+
+        auto found = buckets.find (key);
+        if (found != buckets.end())
+            indices.insert (indices.end(), found->second.begin(), found->second.end());
+    }
+}
+
+void MWDialogue::FilterIndex::add (const ESM::Dialogue& dialogue)
+{
+    Topic& topic = mTopics[&dialogue];
+    topic = Topic();
+    topic.mInfos.reserve (dialogue.mInfo.size());
+
+    for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin(); iter != dialogue.mInfo.end(); ++iter)
+    {
+        const ESM::DialInfo& info = *iter;
+        const std::size_t index = topic.mInfos.size();
+
+        Info indexed;
+        indexed.mInfo = &info;
+        indexed.mSelects.assign (info.mSelects.begin(), info.mSelects.end());
+        topic.mInfos.push_back (std::move (indexed));
+
+        if (!info.mActor.empty())
+            topic.mByActor[Misc::StringUtils::lowerCase (info.mActor)].push_back (index);
+        else if (!info.mRace.empty())
+            topic.mByRace[Misc::StringUtils::lowerCase (info.mRace)].push_back (index);
+        else if (!info.mClass.empty())
+            topic.mByClass[Misc::StringUtils::lowerCase (info.mClass)].push_back (index);
+        else if (!info.mFactionLess && !info.mFaction.empty())
+            topic.mByFaction[Misc::StringUtils::lowerCase (info.mFaction)].push_back (index);
+        else
+            topic.mAnyNpc.push_back (index);
+    }
+
+    mNumInfos += topic.mInfos.size();
+}
+
+bool MWDialogue::FilterIndex::getCandidates (const ESM::Dialogue& dialogue, const Actor& actor,
+    std::vector<const Info *>& candidates) const
+{
+    candidates.clear();
+
+    auto found = mTopics.find (&dialogue);
+    if (found == mTopics.end())
+        return false;
+
+    const Topic& topic = found->second;
+
+    // Every info is in one bucket only, so there are no duplicates
+    std::vector<std::size_t> indices;
+    addCandidates (topic.mByActor, actor.mId, indices);
+
+    // Creatures must not have topics aside of those specific to their id
+    if (!actor.mIsCreature)
+    {
+        addCandidates (topic.mByRace, actor.mRace, indices);
+        addCandidates (topic.mByClass, actor.mClass, indices);
+        addCandidates (topic.mByFaction, actor.mFaction, indices);
+        indices.insert (indices.end(), topic.mAnyNpc.begin(), topic.mAnyNpc.end());
+    }
+
+    std::sort (indices.begin(), indices.end());
+
+    candidates.reserve (indices.size());
+    for (std::size_t index : indices)
+        candidates.push_back (&topic.mInfos[index]);
+
+    return true;
+}
+
+std::size_t MWDialogue::FilterIndex::getNumInfos() const
+{
+    return mNumInfos;
+}
@@ -0,0 +1,73 @@
+#ifndef GAME_MWDIALOGUE_FILTERINDEX_H
+#define GAME_MWDIALOGUE_FILTERINDEX_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "selectwrapper.hpp"
+
+namespace ESM
+{
+    struct DialInfo;
+    struct Dialogue;
+}
+
+namespace MWDialogue
+{
+    /// \brief Buckets the infos of every dialogue by the conditions on the speaker that can't change
+    /// during a game, and keeps their select structs decoded.
+    ///
+    /// An info is bucketed by its actor ID if it has one, otherwise by race, class or faction, in this order.
+    /// Infos the speaker can't possibly get are skipped, all candidates still have to be tested in full.
+    class FilterIndex
+    {
+        public:
+
+            struct Info
+            {
+                const ESM::DialInfo* mInfo;
+                std::vector<SelectWrapper> mSelects;
+            };
+
+            /// Case-smashed properties of a speaker.
+            struct Actor
+            {
+                bool mIsCreature;
+                std::string mId;
+                std::string mRace;
+                std::string mClass;
+                std::string mFaction;
+            };
+
+            void add (const ESM::Dialogue& dialogue);
+            ///< Index all infos of \a dialogue. \a dialogue must outlive the index.
+
+            bool getCandidates (const ESM::Dialogue& dialogue, const Actor& actor,
+                std::vector<const Info *>& candidates) const;
+            ///< Replace \a candidates with the infos of \a dialogue that \a actor might get, in the order of the dialogue.
+            /// \return Was \a dialogue indexed?
+
+            std::size_t getNumInfos() const;
+
+        private:
+
+            typedef std::unordered_map<std::string, std::vector<std::size_t> > Buckets;
+
+            struct Topic
+            {
+                std::vector<Info> mInfos;
+                // Indices into mInfos
+                Buckets mByActor;
+                Buckets mByRace;
+                Buckets mByClass;
+                Buckets mByFaction;
+                std::vector<std::size_t> mAnyNpc;
+            };
+
+            std::unordered_map<const ESM::Dialogue *, Topic> mTopics;
+            std::size_t mNumInfos = 0;
+    };
+}
+
+#endif
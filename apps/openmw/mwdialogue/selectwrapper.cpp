@@ -23,29 +23,13 @@ namespace
 
         throw std::runtime_error ("unknown compare type in dialogue info select");
     }
-
-    template<typename T>
-    bool selectCompareImp (const ESM::DialInfo::SelectStruct& select, T value1)
-    {
-        if (select.mValue.getType()==ESM::VT_Int)
-        {
-            return selectCompareImp (select.mSelectRule[4], value1, select.mValue.getInteger());
-        }
-        else if (select.mValue.getType()==ESM::VT_Float)
-        {
-            return selectCompareImp (select.mSelectRule[4], value1, select.mValue.getFloat());
-        }
-        else
-            throw std::runtime_error (
-                "unsupported variable type in dialogue info select");
-    }
 }
 
-MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::decodeFunction() const
+MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::decodeFunction (const std::string& rule) const
 {
     int index = 0;
 
-    std::istringstream (mSelect.mSelectRule.substr(2,2)) >> index;
+    std::istringstream (rule.substr(2,2)) >> index;
 
     switch (index)
     {
@@ -94,39 +78,88 @@ MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::decodeFunction()
     return Function_False;
 }
 
-MWDialogue::SelectWrapper::SelectWrapper (const ESM::DialInfo::SelectStruct& select) : mSelect (select) {}
-
-MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::getFunction() const
+MWDialogue::SelectWrapper::SelectWrapper (const ESM::DialInfo::SelectStruct& select)
+: mFunction (Function_None), mArgument (0), mType (Type_None), mNpcOnly (false), mComparison (' '),
+  mValueType (select.mValue.getType()), mIntegerValue (0), mFloatValue (0)
 {
-    char type = mSelect.mSelectRule[1];
+    const std::string& rule = select.mSelectRule;
 
-    switch (type)
+    switch (rule.size() > 1 ? rule[1] : ' ')
+    {
+        case '1': mFunction = decodeFunction (rule); break;
+        case '2': mFunction = Function_Global; break;
+        case '3': mFunction = Function_Local; break;
+        case '4': mFunction = Function_Journal; break;
+        case '5': mFunction = Function_Item; break;
+        case '6': mFunction = Function_Dead; break;
+        case '7': mFunction = Function_NotId; break;
+        case '8': mFunction = Function_NotFaction; break;
+        case '9': mFunction = Function_NotClass; break;
+        case 'A': mFunction = Function_NotRace; break;
+        case 'B': mFunction = Function_NotCell; break;
+        case 'C': mFunction = Function_NotLocal; break;
+    }
+
+    mArgument = decodeArgument (rule);
+    mType = decodeType();
+    mNpcOnly = decodeNpcOnly();
+
+    if (rule.size() > 4)
+        mComparison = rule[4];
+    if (rule.size() > 5)
+        mName = Misc::StringUtils::lowerCase (rule.substr (5));
+
+    if (mValueType==ESM::VT_Int)
+        mIntegerValue = select.mValue.getInteger();
+    else if (mValueType==ESM::VT_Float)
+        mFloatValue = select.mValue.getFloat();
+}
+
+template<typename T>
+bool MWDialogue::SelectWrapper::selectCompareImp (T value) const
+{
+    if (mValueType==ESM::VT_Int)
+    {
+        return ::selectCompareImp (mComparison, value, mIntegerValue);
+    }
+    else if (mValueType==ESM::VT_Float)
     {
-        case '1': return decodeFunction();
-        case '2': return Function_Global;
-        case '3': return Function_Local;
-        case '4': return Function_Journal;
-        case '5': return Function_Item;
-        case '6': return Function_Dead;
-        case '7': return Function_NotId;
-        case '8': return Function_NotFaction;
-        case '9': return Function_NotClass;
-        case 'A': return Function_NotRace;
-        case 'B': return Function_NotCell;
-        case 'C': return Function_NotLocal;
+        return ::selectCompareImp (mComparison, value, mFloatValue);
     }
+    else
+        throw std::runtime_error (
+            "unsupported variable type in dialogue info select");
+}
 
-    return Function_None;
+MWDialogue::SelectWrapper::Function MWDialogue::SelectWrapper::getFunction() const
+{
+    return mFunction;
 }
 
 int MWDialogue::SelectWrapper::getArgument() const
 {
-    if (mSelect.mSelectRule[1]!='1')
+    return mArgument;
+}
+
+MWDialogue::SelectWrapper::Type MWDialogue::SelectWrapper::getType() const
+{
+    return mType;
+}
+
+bool MWDialogue::SelectWrapper::isNpcOnly() const
+{
+    return mNpcOnly;
+}
+
+int MWDialogue::SelectWrapper::decodeArgument (const std::string& rule) const
+{
+    if (rule.size() < 2 || rule[1]!='1')
         return 0;
 
     int index = 0;
 
-    std::istringstream (mSelect.mSelectRule.substr(2,2)) >> index;
+    std::istringstream (rule.substr(2,2)) >> index;
+
 
     switch (index)
     {
@@ -184,7 +217,7 @@ int MWDialogue::SelectWrapper::getArgument() const
     return 0;
 }
 
-MWDialogue::SelectWrapper::Type MWDialogue::SelectWrapper::getType() const
+MWDialogue::SelectWrapper::Type MWDialogue::SelectWrapper::decodeType() const
 {
     static const Function integerFunctions[] =
     {
@@ -233,7 +266,7 @@ MWDialogue::SelectWrapper::Type MWDialogue::SelectWrapper::getType() const
         Function_None // end marker
     };
 
-    Function function = getFunction();
+    Function function = mFunction;
 
     for (int i=0; integerFunctions[i]!=Function_None; ++i)
         if (integerFunctions[i]==function)
@@ -254,7 +287,7 @@ MWDialogue::SelectWrapper::Type MWDialogue::SelectWrapper::getType() const
     return Type_None;
 }
 
-bool MWDialogue::SelectWrapper::isNpcOnly() const
+bool MWDialogue::SelectWrapper::decodeNpcOnly() const
 {
     static const Function functions[] =
     {
@@ -267,7 +300,7 @@ bool MWDialogue::SelectWrapper::isNpcOnly() const
         Function_None // end marker
     };
 
-    Function function = getFunction();
+    Function function = mFunction;
 
     for (int i=0; functions[i]!=Function_None; ++i)
         if (functions[i]==function)
@@ -278,20 +311,20 @@ bool MWDialogue::SelectWrapper::isNpcOnly() const
 
 bool MWDialogue::SelectWrapper::selectCompare (int value) const
 {
-    return selectCompareImp (mSelect, value);
+    return selectCompareImp (value);
 }
 
 bool MWDialogue::SelectWrapper::selectCompare (float value) const
 {
-    return selectCompareImp (mSelect, value);
+    return selectCompareImp (value);
 }
 
 bool MWDialogue::SelectWrapper::selectCompare (bool value) const
 {
-    return selectCompareImp (mSelect, static_cast<int> (value));
+    return selectCompareImp (static_cast<int> (value));
 }
 
-std::string MWDialogue::SelectWrapper::getName() const
+const std::string& MWDialogue::SelectWrapper::getName() const
 {
-    return Misc::StringUtils::lowerCase (mSelect.mSelectRule.substr (5));
+    return mName;
 }
@@ -5,10 +5,9 @@
 
 namespace MWDialogue
 {
+    /// A select struct of a dialogue info, decoded once.
     class SelectWrapper
     {
-            const ESM::DialInfo::SelectStruct& mSelect;
-
         public:
 
             enum Function
@@ -57,7 +56,26 @@ namespace MWDialogue
 
         private:
 
-            Function decodeFunction() const;
+            Function mFunction;
+            int mArgument;
+            Type mType;
+            bool mNpcOnly;
+            char mComparison;
+            ESM::VarType mValueType;
+            int mIntegerValue;
+            float mFloatValue;
+            std::string mName;
+
+            Function decodeFunction (const std::string& rule) const;
+
+            int decodeArgument (const std::string& rule) const;
+
+            Type decodeType() const;
+
+            bool decodeNpcOnly() const;
+
+            template<typename T>
+            bool selectCompareImp (T value) const;
 
         public:
 
@@ -78,7 +96,7 @@ namespace MWDialogue
 
             bool selectCompare (bool value) const;
 
-            std::string getName() const;
+            const std::string& getName() const;
             ///< Return case-smashed name.
     };
 }
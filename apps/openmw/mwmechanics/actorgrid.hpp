@@ -0,0 +1,212 @@
+#ifndef GAME_MWMECHANICS_ACTORGRID_H
+#define GAME_MWMECHANICS_ACTORGRID_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <osg/Vec3f>
+
+namespace MWMechanics
+{
+    /// @brief Uniform grid over the horizontal positions of actors, to find the actors near a point
+    /// without looking at every actor.
+    /// @par The grid is rebuilt from scratch with add() and build() whenever the positions may have
+    /// changed. Queries compare against the positions given to add().
+    template <class T>
+    class ActorGrid
+    {
+        public:
+            explicit ActorGrid(float cellSize) : mCellSize(cellSize) {}
+
+            void clear()
+            {
+                mEntries.clear();
+                mCells.clear();
+            }
+
+            /// Add \a value at \a position. The grid can't be queried until build() is called.
+            void add(const osg::Vec3f& position, const T& value)
+            {
+                const int x = getCellIndex(position.x());
+                const int y = getCellIndex(position.y());
+                mEntries.push_back(Entry {getKey(x, y), position, value});
+            }
+
+            /// Sort the added values by cell. Values in the same cell keep the order they were added in.
+            void build()
+            {
+                std::stable_sort(mEntries.begin(), mEntries.end(),
+                    [] (const Entry& lhs, const Entry& rhs) { return lhs.mKey < rhs.mKey; });
+
+                mCells.clear();
+                for (std::size_t i = 0; i < mEntries.size(); ++i)
+                {
+                    if (mCells.empty() || mCells.back().mKey != mEntries[i].mKey)
+                        mCells.push_back(Cell {mEntries[i].mKey, i, i});
+                    ++mCells.back().mEnd;
+                }
+            }
+
+            std::size_t size() const { return mEntries.size(); }
+
+            /// Call \a function with every value closer than \a radius to \a position, until it returns false.
+            /// @return Did \a function return false?
+            template <class Function>
+            bool forEachInRange(const osg::Vec3f& position, float radius, Function function) const
+            {
+                const int minX = getCellIndex(position.x() - radius);
+                const int maxX = getCellIndex(position.x() + radius);
+                const int minY = getCellIndex(position.y() - radius);
+                const int maxY = getCellIndex(position.y() + radius);
+                const float sqrRadius = radius * radius;
+
+                // With a large radius and few actors, it is cheaper to look at every occupied cell
+                const std::size_t cellCount = static_cast<std::size_t>(maxX - minX + 1) * static_cast<std::size_t>(maxY - minY + 1);
+                if (cellCount > mCells.size())
+                {
+                    for (const Cell& cell : mCells)
+                    {
+                        const int x = getCellX(cell.mKey);
+                        const int y = getCellY(cell.mKey);
+                        if (x >= minX && x <= maxX && y >= minY && y <= maxY && !visitCell(cell, position, sqrRadius, function))
+                            return true;
+                    }
+                    return false;
+                }
+
+                for (int x = minX; x <= maxX; ++x)
+                {
+                    for (int y = minY; y <= maxY; ++y)
+                    {
+                        const std::uint64_t key = getKey(x, y);
+                        const auto cell = std::lower_bound(mCells.begin(), mCells.end(), key,
+                            [] (const Cell& cell, std::uint64_t key) { return cell.mKey < key; });
+                        if (cell != mCells.end() && cell->mKey == key && !visitCell(*cell, position, sqrRadius, function))
+                            return true;
+                    }
+                }
+                return false;
+            }
+
+        private:
+            struct Entry
+            {
+                std::uint64_t mKey;
+                osg::Vec3f mPosition;
+                T mValue;
+            };
+
+            struct Cell
+            {
+                std::uint64_t mKey;
+                std::size_t mBegin;
+                std::size_t mEnd;
+            };
+
+            float mCellSize;
+            std::vector<Entry> mEntries;
+            std::vector<Cell> mCells;
+
+            int getCellIndex(float coordinate) const
+            {
+                return static_cast<int>(std::floor(coordinate / mCellSize));
+            }
+
+            // Keys sort by X first, then by Y
+            static std::uint64_t getKey(int x, int y)
+            {
+                return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x) ^ 0x80000000u) << 32)
+                    | (static_cast<std::uint32_t>(y) ^ 0x80000000u);
+            }
+
+            static int getCellX(std::uint64_t key)
+            {
+                return static_cast<int>(static_cast<std::uint32_t>(key >> 32) ^ 0x80000000u);
+            }
+
+            static int getCellY(std::uint64_t key)
+            {
+                return static_cast<int>(static_cast<std::uint32_t>(key) ^ 0x80000000u);
+            }
+
+            template <class Function>
+            bool visitCell(const Cell& cell, const osg::Vec3f& position, float sqrRadius, Function& function) const
+            {
+                for (std::size_t i = cell.mBegin; i < cell.mEnd; ++i)
+                    if ((mEntries[i].mPosition - position).length2() <= sqrRadius && !function(mEntries[i].mValue))
+                        return false;
+                return true;
+            }
+    };
+
+    /// @brief ActorGrid that stays valid while the values move by less than a margin from the positions
+    /// they were added at.
+    /// @par Queries widen the radius by the margin and check the current positions given by a functor.
+    /// Half of the margin covers the regular movement since build(), the other half the moves reported
+    /// with moved(). Once those add up to more, the grid is dirty and has to be rebuilt.
+    template <class T>
+    class MovingActorGrid
+    {
+        public:
+            MovingActorGrid(float cellSize, float margin)
+                : mGrid(cellSize)
+                , mMargin(margin)
+                , mMoved(0)
+                , mDirty(true)
+            {}
+
+            bool isDirty() const { return mDirty; }
+
+            /// Values were added or removed, or moved by an unknown distance
+            void setDirty() { mDirty = true; }
+
+            void clear()
+            {
+                mGrid.clear();
+                mDirty = true;
+            }
+
+            void add(const osg::Vec3f& position, const T& value) { mGrid.add(position, value); }
+
+            void build()
+            {
+                mGrid.build();
+                mMoved = 0;
+                mDirty = false;
+            }
+
+            /// A value was moved other than by the regular movement, e.g. teleported
+            void moved(const osg::Vec3f& from, const osg::Vec3f& to)
+            {
+                mMoved += (to - from).length();
+                if (mMoved > mMargin / 2)
+                    mDirty = true;
+            }
+
+            std::size_t size() const { return mGrid.size(); }
+
+            /// Call \a function with every value which \a getPosition puts closer than \a radius to \a position,
+            /// until it returns false. The grid must not be dirty.
+            /// @return Did \a function return false?
+            template <class GetPosition, class Function>
+            bool forEachInRange(const osg::Vec3f& position, float radius, GetPosition getPosition, Function function) const
+            {
+                return mGrid.forEachInRange(position, radius + mMargin, [&] (const T& value)
+                {
+                    if ((getPosition(value) - position).length2() > radius*radius)
+                        return true;
+                    return function(value);
+                });
+            }
+
+        private:
+            ActorGrid<T> mGrid;
+            float mMargin;
+            float mMoved;
+            bool mDirty;
+    };
+}
+
+#endif
@@ -143,6 +143,26 @@ void getRestorationPerHourOfSleep (const MWWorld::Ptr& ptr, float& health, float
     }
 }
 
+float getMaxHeadTrackDistance (const MWWorld::Ptr& actor)
+{
+    static const float fMaxHeadTrackDistance = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
+            .find("fMaxHeadTrackDistance")->mValue.getFloat();
+    static const float fInteriorHeadTrackMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
+            .find("fInteriorHeadTrackMult")->mValue.getFloat();
+    float maxDistance = fMaxHeadTrackDistance;
+    const ESM::Cell* currentCell = actor.getCell()->getCell();
+    if (!currentCell->isExterior() && !(currentCell->mData.mFlags & ESM::Cell::QuasiEx))
+        maxDistance *= fInteriorHeadTrackMult;
+    return maxDistance;
+}
+
+// Half an exterior cell, so a query in AI processing range looks at about 4x4 grid cells
+const float sActorGridCellSize = 4096.f;
+
+// The grid is built once per frame, actors moving less than half of this since then are still found by
+// queries. Teleports are tracked separately against the other half.
+const float sActorGridMargin = 1024.f;
+
 }
 
 namespace MWMechanics
@@ -315,14 +335,7 @@ namespace MWMechanics
         if (targetActor.getClass().getCreatureStats(targetActor).isDead())
             return;
 
-        static const float fMaxHeadTrackDistance = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                .find("fMaxHeadTrackDistance")->mValue.getFloat();
-        static const float fInteriorHeadTrackMult = MWBase::Environment::get().getWorld()->getStore().get<ESM::GameSetting>()
-                .find("fInteriorHeadTrackMult")->mValue.getFloat();
-        float maxDistance = fMaxHeadTrackDistance;
-        const ESM::Cell* currentCell = actor.getCell()->getCell();
-        if (!currentCell->isExterior() && !(currentCell->mData.mFlags & ESM::Cell::QuasiEx))
-            maxDistance *= fInteriorHeadTrackMult;
+        const float maxDistance = getMaxHeadTrackDistance(actor);
 
         const osg::Vec3f actor1Pos(actor.getRefData().getPosition().asVec3());
         const osg::Vec3f actor2Pos(targetActor.getRefData().getPosition().asVec3());
@@ -1158,6 +1171,7 @@ namespace MWMechanics
     }
 
     Actors::Actors()
+        : mActorGrid(sActorGridCellSize, sActorGridMargin)
     {
         mTimerDisposeSummonsCorpses = 0.2f; // We should add a delay between summoned creature death and its corpse despawning
 
@@ -1194,6 +1208,7 @@ namespace MWMechanics
         if (!anim)
             return;
         mActors.insert(std::make_pair(ptr, new Actor(ptr, anim)));
+        mActorGrid.setDirty();
 
         CharacterController* ctrl = mActors[ptr]->getCharacterController();
         if (updateImmediately)
@@ -1243,6 +1258,7 @@ namespace MWMechanics
         {
             delete iter->second;
             mActors.erase(iter);
+            mActorGrid.setDirty();
         }
     }
 
@@ -1295,6 +1311,7 @@ namespace MWMechanics
 
             actor->updatePtr(ptr);
             mActors.insert(std::make_pair(ptr, actor));
+            mActorGrid.setDirty();
         }
     }
 
@@ -1307,6 +1324,7 @@ namespace MWMechanics
             {
                 delete iter->second;
                 mActors.erase(iter++);
+                mActorGrid.setDirty();
             }
             else
                 ++iter;
@@ -1356,8 +1374,34 @@ namespace MWMechanics
 
     }
 
+    void Actors::updateActorGrid()
+    {
+        mActorGrid.clear();
+        for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
+            mActorGrid.add(iter->first.getRefData().getPosition().asVec3(), iter->first);
+        mActorGrid.build();
+    }
+
+    void Actors::updatePosition(const MWWorld::Ptr& ptr, const osg::Vec3f& oldPosition)
+    {
+        if (mActors.find(ptr) != mActors.end())
+            mActorGrid.moved(oldPosition, ptr.getRefData().getPosition().asVec3());
+    }
+
+    template <class Function>
+    bool Actors::forEachActorInRange (const osg::Vec3f& position, float radius, Function function)
+    {
+        if (mActorGrid.isDirty())
+            updateActorGrid();
+
+        return mActorGrid.forEachInRange(position, radius,
+            [] (const MWWorld::Ptr& actor) { return actor.getRefData().getPosition().asVec3(); }, function);
+    }
+
     void Actors::update (float duration, bool paused)
     {
+        updateActorGrid();
+
         if(!paused)
         {
             static float timerUpdateAITargets = 0;
@@ -1443,11 +1487,17 @@ namespace MWMechanics
                             if (!isPlayer)
                                 adjustCommandedActor(iter->first);
 
-                            for(PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
+                            // engageCombat ignores actors outside of AI processing range
+                            if (!isPlayer) // player is not AI-controlled
                             {
-                                if (it->first == iter->first || isPlayer) // player is not AI-controlled
-                                    continue;
-                                engageCombat(iter->first, it->first, cachedAllies, it->first == player);
+                                const MWWorld::Ptr actor1 = iter->first;
+                                forEachActorInRange(actor1.getRefData().getPosition().asVec3(), mActorsProcessingRange,
+                                    [&] (const MWWorld::Ptr& actor2)
+                                {
+                                    if (actor2 != actor1)
+                                        engageCombat(actor1, actor2, cachedAllies, actor2 == player);
+                                    return true;
+                                });
                             }
                         }
                         if (timerUpdateHeadTrack == 0)
@@ -1466,12 +1516,14 @@ namespace MWMechanics
                                 !stats.getAiSequence().hasPackage(AiPackage::TypeIdPursue) &&
                                 !firstPersonPlayer)
                             {
-                                for(PtrActorMap::iterator it(mActors.begin()); it != mActors.end(); ++it)
+                                const MWWorld::Ptr actor = iter->first;
+                                forEachActorInRange(actor.getRefData().getPosition().asVec3(), getMaxHeadTrackDistance(actor),
+                                    [&] (const MWWorld::Ptr& target)
                                 {
-                                    if (it->first == iter->first)
-                                        continue;
-                                    updateHeadTracking(iter->first, it->first, headTrackTarget, sqrHeadTrackDistance);
-                                }
+                                    if (target != actor)
+                                        updateHeadTracking(actor, target, headTrackTarget, sqrHeadTrackDistance);
+                                    return true;
+                                });
                             }
 
                             ctrl->setHeadTrackTarget(headTrackTarget);
@@ -1872,22 +1924,16 @@ namespace MWMechanics
 
     void Actors::getObjectsInRange(const osg::Vec3f& position, float radius, std::vector<MWWorld::Ptr>& out)
     {
-        for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
+        forEachActorInRange(position, radius, [&] (const MWWorld::Ptr& actor)
         {
-            if ((iter->first.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
-                out.push_back(iter->first);
-        }
+            out.push_back(actor);
+            return true;
+        });
     }
 
     bool Actors::isAnyObjectInRange(const osg::Vec3f& position, float radius)
     {
-        for (PtrActorMap::iterator iter = mActors.begin(); iter != mActors.end(); ++iter)
-        {
-            if ((iter->first.getRefData().getPosition().asVec3() - position).length2() <= radius*radius)
-                return true;
-        }
-
-        return false;
+        return forEachActorInRange(position, radius, [] (const MWWorld::Ptr&) { return false; });
     }
 
     std::list<MWWorld::Ptr> Actors::getActorsSidingWith(const MWWorld::Ptr& actor)
@@ -2099,6 +2145,7 @@ namespace MWMechanics
             it->second = nullptr;
         }
         mActors.clear();
+        mActorGrid.clear();
         mDeathCount.clear();
     }
 
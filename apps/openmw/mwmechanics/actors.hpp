@@ -7,6 +7,10 @@
 #include <list>
 #include <map>
 
+#include "../mwworld/ptr.hpp"
+
+#include "actorgrid.hpp"
+
 namespace ESM
 {
     class ESMReader;
@@ -25,7 +29,6 @@ namespace Loading
 
 namespace MWWorld
 {
-    class Ptr;
     class CellStore;
 }
 
@@ -97,6 +100,9 @@ namespace MWMechanics
             void updateActor(const MWWorld::Ptr &old, const MWWorld::Ptr& ptr);
             ///< Updates an actor with a new Ptr
 
+            void updatePosition(const MWWorld::Ptr& ptr, const osg::Vec3f& oldPosition);
+            ///< \a ptr was moved from \a oldPosition other than by physics, e.g. teleported
+
             void dropActors (const MWWorld::CellStore *cellStore, const MWWorld::Ptr& ignore);
             ///< Deregister all actors (except for \a ignore) in the given cell.
 
@@ -190,7 +196,14 @@ namespace MWMechanics
     private:
         void updateVisibility (const MWWorld::Ptr& ptr, CharacterController* ctrl);
 
+        void updateActorGrid();
+
+        /// Call \a function with every actor closer than \a radius to \a position, until it returns false.
+        template <class Function>
+        bool forEachActorInRange (const osg::Vec3f& position, float radius, Function function);
+
         PtrActorMap mActors;
+        MovingActorGrid<MWWorld::Ptr> mActorGrid;
         float mTimerDisposeSummonsCorpses;
         float mActorsProcessingRange;
 
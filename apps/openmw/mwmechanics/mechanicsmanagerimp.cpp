@@ -274,6 +274,12 @@ namespace MWMechanics
             mObjects.updateObject(old, ptr);
     }
 
+    void MechanicsManager::updatePosition(const MWWorld::Ptr& ptr, const osg::Vec3f& oldPosition)
+    {
+        if(ptr.getClass().isActor())
+            mActors.updatePosition(ptr, oldPosition);
+    }
+
 
     void MechanicsManager::drop(const MWWorld::CellStore *cellStore)
     {
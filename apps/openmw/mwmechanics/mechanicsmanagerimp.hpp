@@ -65,6 +65,9 @@ namespace MWMechanics
             virtual void updateCell(const MWWorld::Ptr &old, const MWWorld::Ptr &ptr) override;
             ///< Moves an object to a new cell
 
+            virtual void updatePosition(const MWWorld::Ptr& ptr, const osg::Vec3f& oldPosition) override;
+            ///< \a ptr was moved from \a oldPosition other than by physics, e.g. teleported
+
             virtual void drop(const MWWorld::CellStore *cellStore) override;
             ///< Deregister all objects in the given cell.
 
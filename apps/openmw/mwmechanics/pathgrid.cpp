@@ -1,10 +1,8 @@
 #include "pathgrid.hpp"
 
-#include "../mwbase/world.hpp"
-#include "../mwbase/environment.hpp"
-
-#include "../mwworld/cellstore.hpp"
-#include "../mwworld/esmstore.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <list>
 
 namespace
 {
@@ -49,18 +47,6 @@ namespace
 
 namespace MWMechanics
 {
-    PathgridGraph::PathgridGraph(const MWWorld::CellStore *cell)
-        : mCell(nullptr)
-        , mPathgrid(nullptr)
-        , mIsExterior(0)
-        , mGraph(0)
-        , mIsGraphConstructed(false)
-        , mSCCId(0)
-        , mSCCIndex(0)
-    {
-        load(cell);
-    }
-
     /*
      * mGraph is populated with the cost of each allowed edge.
      *
@@ -97,20 +83,15 @@ namespace MWMechanics
      *    +---------------->
      *      high cost
      */
-    bool PathgridGraph::load(const MWWorld::CellStore *cell)
+    PathgridGraph::PathgridGraph(const ESM::Pathgrid* pathgrid, std::size_t maxCachedPaths)
+        : mPathgrid(pathgrid)
+        , mGraph(0)
+        , mMaxCachedPaths(maxCachedPaths)
+        , mSCCId(0)
+        , mSCCIndex(0)
     {
-        if(!cell)
-            return false;
-
-        if(mIsGraphConstructed)
-            return true;
-
-        mCell = cell->getCell();
-        mIsExterior = cell->getCell()->isExterior();
-        mPathgrid = MWBase::Environment::get().getWorld()->getStore().get<ESM::Pathgrid>().search(*cell->getCell());
         if(!mPathgrid)
-            return false;
-
+            return;
 
         mGraph.resize(mPathgrid->mPoints.size());
         for(int i = 0; i < static_cast<int> (mPathgrid->mEdges.size()); i++)
@@ -127,8 +108,6 @@ namespace MWMechanics
             //mGraph[mPathgrid->mEdges[i].mV1].edges.push_back(neighbour);
         }
         buildConnectedPoints();
-        mIsGraphConstructed = true;
-        return true;
     }
 
     const ESM::Pathgrid *PathgridGraph::getPathgrid() const
@@ -230,6 +209,32 @@ namespace MWMechanics
         }
     }
 
+    std::deque<ESM::Pathgrid::Point> PathgridGraph::aStarSearch(const int start, const int goal) const
+    {
+        std::deque<ESM::Pathgrid::Point> path;
+        if(!isPointConnected(start, goal))
+        {
+            return path; // there is no path, return an empty path
+        }
+
+        const std::size_t key = static_cast<std::size_t>(start) * mGraph.size() + static_cast<std::size_t>(goal);
+        auto cached = mCachedPaths.find(key);
+        if(cached == mCachedPaths.end())
+        {
+            std::vector<int> found = findPath(start, goal);
+            for(int index : found)
+                path.push_back(mPathgrid->mPoints[index]);
+            // Wandering actors keep using paths between the same few points, so keep the first ones when full
+            if(mCachedPaths.size() < mMaxCachedPaths)
+                mCachedPaths.emplace(key, std::move(found));
+            return path;
+        }
+
+        for(int index : cached->second)
+            path.push_back(mPathgrid->mPoints[index]);
+        return path;
+    }
+
     /*
      * NOTE: Based on buildPath2(), please check git history if interested
      *       Should consider using a 3rd party library version (e.g. boost)
@@ -238,45 +243,37 @@ namespace MWMechanics
      * Uses mGraph which has pre-computed costs for allowed edges.  It is assumed
      * that mGraph is already constructed.
      *
-     * Should be possible to make this MT safe.
-     *
-     * Returns path which may be empty.  path contains pathgrid points in local
-     * cell coordinates (indoors) or world coordinates (external).
+     * Returns path which may be empty.  path contains pathgrid point indexes
+     * including start and goal.
      *
      * Input params:
      *   start, goal - pathgrid point indexes (for this cell)
      *
      * Variables:
      *   openset - point indexes to be traversed, lowest cost at the front
-     *   closedset - point indexes already traversed
+     *   isInOpenSet - whether point index is in openset
+     *   isInClosedSet - whether point index is already traversed
      *   gScore - past accumulated costs vector indexed by point index
      *   fScore - future estimated costs vector indexed by point index
-     *
-     * TODO: An intersting exercise might be to cache the paths created for a
-     *       start/goal pair.  To cache the results the paths need to be in
-     *       pathgrid points form (currently they are converted to world
-     *       coordinates).  Essentially trading speed w/ memory.
      */
-    std::deque<ESM::Pathgrid::Point> PathgridGraph::aStarSearch(const int start, const int goal) const
+    std::vector<int> PathgridGraph::findPath(const int start, const int goal) const
     {
-        std::deque<ESM::Pathgrid::Point> path;
-        if(!isPointConnected(start, goal))
-        {
-            return path; // there is no path, return an empty path
-        }
+        std::vector<int> path;
 
         int graphSize = static_cast<int> (mGraph.size());
         std::vector<float> gScore (graphSize, -1);
         std::vector<float> fScore (graphSize, -1);
         std::vector<int> graphParent (graphSize, -1);
+        std::vector<bool> isInOpenSet (graphSize, false);
+        std::vector<bool> isInClosedSet (graphSize, false);
 
         // gScore & fScore keep costs for each pathgrid point in mPoints
         gScore[start] = 0;
         fScore[start] = costAStar(mPathgrid->mPoints[start], mPathgrid->mPoints[goal]);
 
         std::list<int> openset;
-        std::list<int> closedset;
         openset.push_back(start);
+        isInOpenSet[start] = true;
 
         int current = -1;
 
@@ -284,30 +281,29 @@ namespace MWMechanics
         {
             current = openset.front(); // front has the lowest cost
             openset.pop_front();
+            isInOpenSet[current] = false;
 
             if(current == goal)
                 break;
 
-            closedset.push_back(current); // remember we've been here
+            isInClosedSet[current] = true; // remember we've been here
 
             // check all edges for the current point index
             for(int j = 0; j < static_cast<int> (mGraph[current].edges.size()); j++)
             {
-                if(std::find(closedset.begin(), closedset.end(), mGraph[current].edges[j].index) ==
-                   closedset.end())
+                int dest = mGraph[current].edges[j].index;
+                if(!isInClosedSet[dest])
                 {
                     // not in closedset - i.e. have not traversed this edge destination
-                    int dest = mGraph[current].edges[j].index;
                     float tentative_g = gScore[current] + mGraph[current].edges[j].cost;
-                    bool isInOpenSet = std::find(openset.begin(), openset.end(), dest) != openset.end();
-                    if(!isInOpenSet
+                    if(!isInOpenSet[dest]
                         || tentative_g < gScore[dest])
                     {
                         graphParent[dest] = current;
                         gScore[dest] = tentative_g;
                         fScore[dest] = tentative_g + costAStar(mPathgrid->mPoints[dest],
                                                                mPathgrid->mPoints[goal]);
-                        if(!isInOpenSet)
+                        if(!isInOpenSet[dest])
                         {
                             // add this edge to openset, lowest cost goes to the front
                             // TODO: if this causes performance problems a hash table may help
@@ -318,6 +314,7 @@ namespace MWMechanics
                                     break;
                             }
                             openset.insert(it, dest);
+                            isInOpenSet[dest] = true;
                         }
                     }
                 } // if in closedset, i.e. traversed this edge already, try the next edge
@@ -327,16 +324,16 @@ namespace MWMechanics
         if(current != goal)
             return path; // for some reason couldn't build a path
 
-        // reconstruct path to return, using local coordinates
+        // reconstruct path to return
         while(graphParent[current] != -1)
         {
-            path.push_front(mPathgrid->mPoints[current]);
+            path.push_back(current);
             current = graphParent[current];
         }
 
         // add first node to path explicitly
-        path.push_front(mPathgrid->mPoints[start]);
+        path.push_back(start);
+        std::reverse(path.begin(), path.end());
         return path;
     }
 }
-
@@ -1,28 +1,21 @@
 #ifndef GAME_MWMECHANICS_PATHGRID_H
 #define GAME_MWMECHANICS_PATHGRID_H
 
+#include <cstddef>
 #include <deque>
+#include <unordered_map>
+#include <vector>
 
 #include <components/esm/loadpgrd.hpp>
 
-namespace ESM
-{
-    struct Cell;
-}
-
-namespace MWWorld
-{
-    class CellStore;
-}
-
 namespace MWMechanics
 {
     class PathgridGraph
     {
         public:
-            PathgridGraph(const MWWorld::CellStore* cell);
-
-            bool load(const MWWorld::CellStore *cell);
+            /// @param pathgrid may be null for cells without pathgrid
+            /// @param maxCachedPaths limits number of aStarSearch results kept for repeated queries, 0 disables the cache
+            explicit PathgridGraph(const ESM::Pathgrid* pathgrid, std::size_t maxCachedPaths = 4096);
 
             const ESM::Pathgrid* getPathgrid() const;
 
@@ -38,13 +31,12 @@ namespace MWMechanics
             // cells) coordinates
             //
             // NOTE: if start equals end an empty path is returned
+            // NOTE: found paths are cached by start and end, the cache is not thread safe
             std::deque<ESM::Pathgrid::Point> aStarSearch(const int start, const int end) const;
 
         private:
 
-            const ESM::Cell *mCell;
             const ESM::Pathgrid *mPathgrid;
-            bool mIsExterior;
 
             struct ConnectedPoint // edge
             {
@@ -68,7 +60,11 @@ namespace MWMechanics
             //   all other pathgrid points are the third set
             //
             std::vector<Node> mGraph;
-            bool mIsGraphConstructed;
+
+            // pathgrid point indexes of found paths by start * mGraph.size() + end,
+            // pathgrids never change during runtime so the cache is never invalidated
+            const std::size_t mMaxCachedPaths;
+            mutable std::unordered_map<std::size_t, std::vector<int>> mCachedPaths;
 
             // variables used to calculate connected components
             int mSCCId;
@@ -79,6 +75,8 @@ namespace MWMechanics
             // methods used to calculate connected components
             void recursiveStrongConnect(int v);
             void buildConnectedPoints();
+
+            std::vector<int> findPath(const int start, const int goal) const;
     };
 }
 
@@ -1,6 +1,7 @@
 ﻿#include "physicssystem.hpp"
 
 #include <osg/Group>
+#include <osg/Stats>
 
 #include <BulletCollision/CollisionShapes/btConeShape.h>
 #include <BulletCollision/CollisionShapes/btSphereShape.h>
@@ -44,6 +45,7 @@
 #include "trace.h"
 #include "object.hpp"
 #include "heightfield.hpp"
+#include "workerpool.hpp"
 
 namespace MWPhysics
 {
@@ -270,7 +272,7 @@ namespace MWPhysics
 
         static osg::Vec3f move(osg::Vec3f position, const MWWorld::Ptr &ptr, Actor* physicActor, const osg::Vec3f &movement, float time,
                                   bool isFlying, float waterlevel, float slowFall, const btCollisionWorld* collisionWorld,
-                               std::map<MWWorld::Ptr, MWWorld::Ptr>& standingCollisionTracker)
+                               MWWorld::Ptr& standingOnTracker)
         {
             const ESM::Position& refpos = ptr.getRefData().getPosition();
             // Early-out for totally static creatures
@@ -444,7 +446,7 @@ namespace MWPhysics
                     const btCollisionObject* standingOn = tracer.mHitObject;
                     PtrHolder* ptrHolder = static_cast<PtrHolder*>(standingOn->getUserPointer());
                     if (ptrHolder)
-                        standingCollisionTracker[ptr] = ptrHolder->getPtr();
+                        standingOnTracker = ptrHolder->getPtr();
 
                     if (standingOn->getBroadphaseHandle()->m_collisionFilterGroup == CollisionType_Water)
                         physicActor->setWalkingOnWater(true);
@@ -502,7 +504,7 @@ namespace MWPhysics
     // ---------------------------------------------------------------
 
 
-    PhysicsSystem::PhysicsSystem(Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> parentNode)
+    PhysicsSystem::PhysicsSystem(Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> parentNode, std::size_t numThreads)
         : mShapeManager(new Resource::BulletShapeManager(resourceSystem->getVFS(), resourceSystem->getSceneManager(), resourceSystem->getNifFileManager()))
         , mResourceSystem(resourceSystem)
         , mDebugDrawEnabled(false)
@@ -511,12 +513,37 @@ namespace MWPhysics
         , mWaterEnabled(false)
         , mParentNode(parentNode)
         , mPhysicsDt(1.f / 60.f)
+        , mMovementBeginTick(0)
+        , mMovementEndTick(0)
+        , mNumMovedActors(0)
+        , mNumIndependentActors(0)
     {
         mResourceSystem->addResourceManager(mShapeManager.get());
 
         mCollisionConfiguration = new btDefaultCollisionConfiguration();
         mDispatcher = new btCollisionDispatcher(mCollisionConfiguration);
-        mBroadphase = new btDbvtBroadphase();
+        btDbvtBroadphase* broadphase = new btDbvtBroadphase();
+        mBroadphase = broadphase;
+
+        if (numThreads > 0)
+        {
+#if BT_BULLET_VERSION >= 287
+            // Sweep tests share the traversal stacks of the broadphase, Bullet built with BT_THREADSAFE has one per thread.
+            // The calling thread solves movement as well.
+            const std::size_t maxThreads = static_cast<std::size_t>(broadphase->m_rayTestStacks.size()) - 1;
+#else
+            // Before 2.87 the broadphase has a single traversal stack shared by all sweep tests
+            const std::size_t maxThreads = 0;
+#endif
+            if (numThreads > maxThreads)
+            {
+                Log(Debug::Warning) << "Warning: Bullet supports " << maxThreads << " threads for solving actor movement, "
+                    << numThreads << " were requested";
+                numThreads = maxThreads;
+            }
+        }
+        if (numThreads > 0)
+            mWorkerPool.reset(new WorkerPool(numThreads));
 
         mCollisionWorld = new btCollisionWorld(mDispatcher, mBroadphase, mCollisionConfiguration);
 
@@ -1231,6 +1258,7 @@ namespace MWPhysics
     const PtrVelocityList& PhysicsSystem::applyQueuedMovement(float dt)
     {
         mMovementResults.clear();
+        mMovementBeginTick = osg::Timer::instance()->tick();
 
         mTimeAccum += dt;
 
@@ -1248,6 +1276,7 @@ namespace MWPhysics
 
         const MWWorld::Ptr player = MWMechanics::getPlayer();
         const MWBase::World *world = MWBase::Environment::get().getWorld();
+        mActorMovements.clear();
         PtrVelocityList::iterator iter = mMovementQueue.begin();
         for(;iter != mMovementQueue.end();++iter)
         {
@@ -1277,47 +1306,159 @@ namespace MWPhysics
             }
             physicActor->setCanWaterWalk(waterCollision);
 
+            ActorMovement movement;
+            movement.mPtr = iter->first;
+            movement.mActor = physicActor;
+            movement.mVelocity = iter->second;
+            movement.mWaterLevel = waterlevel;
             // Slow fall reduces fall speed by a factor of (effect magnitude / 200)
-            float slowFall = 1.f - std::max(0.f, std::min(1.f, effects.get(ESM::MagicEffect::SlowFall).getMagnitude() * 0.005f));
+            movement.mSlowFall = 1.f - std::max(0.f, std::min(1.f, effects.get(ESM::MagicEffect::SlowFall).getMagnitude() * 0.005f));
+            movement.mFlying = world->isFlying(iter->first);
+            movement.mSwimming = world->isSwimming(iter->first);
+            movement.mWasOnGround = physicActor->getOnGround();
+            movement.mIndependent = false;
+            movement.mPreviousPosition = physicActor->getPreviousPosition();
+            movement.mPosition = physicActor->getPosition();
+            movement.mPositionChanged = false;
+            mActorMovements.push_back(movement);
+        }
 
-            bool flying = world->isFlying(iter->first);
-            bool swimming = world->isSwimming(iter->first);
+        // Solve the actors that can't run into another moving actor on all threads first. The others are solved
+        // one after another in the queued order, against the new positions of the actors before them.
+        std::vector<std::size_t> independent;
+        if (mWorkerPool && numSteps > 0)
+        {
+            findIndependentMovements(mActorMovements, numSteps);
+            for (std::size_t i = 0; i < mActorMovements.size(); ++i)
+                if (mActorMovements[i].mIndependent)
+                    independent.push_back(i);
+            mWorkerPool->run(independent.size(), [&] (std::size_t i) { solveMovement(mActorMovements[independent[i]], numSteps); });
+        }
 
-            bool wasOnGround = physicActor->getOnGround();
-            osg::Vec3f position = physicActor->getPosition();
-            float oldHeight = position.z();
-            bool positionChanged = false;
-            for (int i=0; i<numSteps; ++i)
-            {
-                position = MovementSolver::move(position, physicActor->getPtr(), physicActor, iter->second, mPhysicsDt,
-                                                flying, waterlevel, slowFall, mCollisionWorld, mStandingCollisions);
-                if (position != physicActor->getPosition())
-                    positionChanged = true;
-                physicActor->setPosition(position); // always set even if unchanged to make sure interpolation is correct
-            }
-            if (positionChanged)
+        for (ActorMovement& movement : mActorMovements)
+        {
+            Actor* physicActor = movement.mActor;
+            const float oldHeight = physicActor->getPosition().z();
+
+            if (!movement.mIndependent)
+                solveMovement(movement, numSteps);
+
+            // always set even if unchanged to make sure interpolation is correct
+            if (numSteps > 1)
+                physicActor->setPosition(movement.mPreviousPosition);
+            if (numSteps > 0)
+                physicActor->setPosition(movement.mPosition);
+            if (movement.mPositionChanged)
                 mCollisionWorld->updateSingleAabb(physicActor->getCollisionObject());
+            if (!movement.mStandingOn.isEmpty())
+                mStandingCollisions[movement.mPtr] = movement.mStandingOn;
 
+            const osg::Vec3f position = physicActor->getPosition();
             float interpolationFactor = mTimeAccum / mPhysicsDt;
             osg::Vec3f interpolated = position * interpolationFactor + physicActor->getPreviousPosition() * (1.f - interpolationFactor);
 
             float heightDiff = position.z() - oldHeight;
 
-            MWMechanics::CreatureStats& stats = iter->first.getClass().getCreatureStats(iter->first);
-            bool isStillOnGround = (numSteps > 0 && wasOnGround && physicActor->getOnGround());
-            if (isStillOnGround || flying || swimming || slowFall < 1)
-                stats.land(iter->first == player && (flying || swimming));
+            MWMechanics::CreatureStats& stats = movement.mPtr.getClass().getCreatureStats(movement.mPtr);
+            bool isStillOnGround = (numSteps > 0 && movement.mWasOnGround && physicActor->getOnGround());
+            if (isStillOnGround || movement.mFlying || movement.mSwimming || movement.mSlowFall < 1)
+                stats.land(movement.mPtr == player && (movement.mFlying || movement.mSwimming));
             else if (heightDiff < 0)
                 stats.addToFallHeight(-heightDiff);
 
-            mMovementResults.push_back(std::make_pair(iter->first, interpolated));
+            mMovementResults.push_back(std::make_pair(movement.mPtr, interpolated));
         }
 
         mMovementQueue.clear();
 
+        mNumMovedActors = mActorMovements.size();
+        mNumIndependentActors = independent.size();
+        mMovementEndTick = osg::Timer::instance()->tick();
+
         return mMovementResults;
     }
 
+    void PhysicsSystem::solveMovement(ActorMovement& movement, int numSteps) const
+    {
+        for (int i = 0; i < numSteps; ++i)
+        {
+            movement.mPreviousPosition = movement.mPosition;
+            movement.mPosition = MovementSolver::move(movement.mPosition, movement.mActor->getPtr(), movement.mActor,
+                movement.mVelocity, mPhysicsDt, movement.mFlying, movement.mWaterLevel, movement.mSlowFall,
+                mCollisionWorld, movement.mStandingOn);
+            if (movement.mPosition != movement.mPreviousPosition)
+                movement.mPositionChanged = true;
+        }
+    }
+
+    void PhysicsSystem::findIndependentMovements(std::vector<ActorMovement>& movements, int numSteps) const
+    {
+        const float time = numSteps * mPhysicsDt;
+        const float gravity = Constants::GravityConst * Constants::UnitsPerMeter;
+
+        // Bounds of everything the collision shape of each actor may touch during this frame
+        std::vector<std::pair<btVector3, btVector3> > bounds;
+        bounds.reserve(movements.size());
+        for (ActorMovement& movement : movements)
+        {
+            const btCollisionObject* object = movement.mActor->getCollisionObject();
+            btVector3 aabbMin, aabbMax;
+            object->getCollisionShape()->getAabb(object->getWorldTransform(), aabbMin, aabbMax);
+
+            // MovementSolver sweeps the shape from the actor position raised by the half height, not from the
+            // collision object position
+            const btVector3 sweepOffset = Misc::Convert::toBullet(movement.mPosition
+                + osg::Vec3f(0.f, 0.f, movement.mActor->getHalfExtents().z()) - movement.mActor->getCollisionObjectPosition());
+
+            // Upper bound of the distance moved, see MovementSolver::move. Dead actors float up with 25 units per second.
+            const float speed = movement.mVelocity.length() + movement.mActor->getInertialForce().length() + gravity * time + 25.f;
+            const float reach = speed * time + sStepSizeUp + sStepSizeDown + 2 * sGroundOffset;
+
+            btVector3 min = aabbMin;
+            min.setMin(aabbMin + sweepOffset);
+            btVector3 max = aabbMax;
+            max.setMax(aabbMax + sweepOffset);
+            bounds.push_back(std::make_pair(min - btVector3(reach, reach, reach), max + btVector3(reach, reach, reach)));
+
+            movement.mIndependent = true;
+        }
+
+        // Sweep and prune along the X axis
+        std::vector<std::size_t> order(movements.size());
+        for (std::size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(),
+            [&] (std::size_t lhs, std::size_t rhs) { return bounds[lhs].first.x() < bounds[rhs].first.x(); });
+
+        for (std::size_t i = 0; i < order.size(); ++i)
+        {
+            const std::pair<btVector3, btVector3>& first = bounds[order[i]];
+            for (std::size_t j = i + 1; j < order.size() && bounds[order[j]].first.x() <= first.second.x(); ++j)
+            {
+                const std::pair<btVector3, btVector3>& second = bounds[order[j]];
+                if (first.first.y() <= second.second.y() && second.first.y() <= first.second.y()
+                    && first.first.z() <= second.second.z() && second.first.z() <= first.second.z())
+                {
+                    movements[order[i]].mIndependent = false;
+                    movements[order[j]].mIndependent = false;
+                }
+            }
+        }
+    }
+
+    void PhysicsSystem::reportStats(unsigned int frameNumber, osg::Stats& stats, osg::Timer_t startTick) const
+    {
+        stats.setAttribute(frameNumber, "physics_movement_time_begin", osg::Timer::instance()->delta_s(startTick, mMovementBeginTick));
+        stats.setAttribute(frameNumber, "physics_movement_time_taken", osg::Timer::instance()->delta_s(mMovementBeginTick, mMovementEndTick));
+        stats.setAttribute(frameNumber, "physics_movement_time_end", osg::Timer::instance()->delta_s(startTick, mMovementEndTick));
+
+        if (stats.collectStats("resource"))
+        {
+            stats.setAttribute(frameNumber, "Physics Actor", mNumMovedActors);
+            stats.setAttribute(frameNumber, "Physics Parallel", mNumIndependentActors);
+        }
+    }
+
     void PhysicsSystem::stepSimulation(float dt)
     {
         for (std::set<Object*>::iterator it = mAnimatedObjects.begin(); it != mAnimatedObjects.end(); ++it)
@@ -7,6 +7,7 @@
 #include <algorithm>
 
 #include <osg/Quat>
+#include <osg/Timer>
 #include <osg/ref_ptr>
 
 #include "../mwworld/ptr.hpp"
@@ -17,6 +18,7 @@ namespace osg
 {
     class Group;
     class Object;
+    class Stats;
 }
 
 namespace MWRender
@@ -49,6 +51,7 @@ namespace MWPhysics
     class HeightField;
     class Object;
     class Actor;
+    class WorkerPool;
 
     static const float sMaxSlope = 49.0f;
     static const float sStepSizeUp = 34.0f;
@@ -56,7 +59,8 @@ namespace MWPhysics
     class PhysicsSystem
     {
         public:
-            PhysicsSystem (Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> parentNode);
+            /// @param numThreads Number of threads solving actor movement, 0 to solve it on the calling thread.
+            PhysicsSystem (Resource::ResourceSystem* resourceSystem, osg::ref_ptr<osg::Group> parentNode, std::size_t numThreads = 0);
             ~PhysicsSystem ();
 
             void setUnrefQueue(SceneUtil::UnrefQueue* unrefQueue);
@@ -179,6 +183,10 @@ namespace MWPhysics
 
             bool isOnSolidGround (const MWWorld::Ptr& actor) const;
 
+            /// Report the time and number of actors of the last applyQueuedMovement.
+            /// @param startTick Tick the other frame times are measured from.
+            void reportStats(unsigned int frameNumber, osg::Stats& stats, osg::Timer_t startTick) const;
+
             void updateAnimatedCollisionShape(const MWWorld::Ptr& object);
 
             template <class Function>
@@ -189,8 +197,32 @@ namespace MWPhysics
 
         private:
 
+            /// Movement of an actor during one frame
+            struct ActorMovement
+            {
+                MWWorld::Ptr mPtr;
+                Actor* mActor;
+                osg::Vec3f mVelocity;
+                float mWaterLevel;
+                float mSlowFall;
+                bool mFlying;
+                bool mSwimming;
+                bool mWasOnGround;
+                bool mIndependent; // Can't collide with other moving actors, so it can be solved in parallel
+                osg::Vec3f mPreviousPosition; // Position before the last step
+                osg::Vec3f mPosition;
+                bool mPositionChanged;
+                MWWorld::Ptr mStandingOn;
+            };
+
             void updateWater();
 
+            /// Solve the movement of every step of this frame, without moving the collision object of the actor.
+            void solveMovement(ActorMovement& movement, int numSteps) const;
+
+            /// Mark the movements that can't collide with another moving actor as independent.
+            void findIndependentMovements(std::vector<ActorMovement>& movements, int numSteps) const;
+
             osg::ref_ptr<SceneUtil::UnrefQueue> mUnrefQueue;
 
             btBroadphaseInterface* mBroadphase;
@@ -225,6 +257,13 @@ namespace MWPhysics
             PtrVelocityList mMovementQueue;
             PtrVelocityList mMovementResults;
 
+            std::unique_ptr<WorkerPool> mWorkerPool;
+            std::vector<ActorMovement> mActorMovements;
+            osg::Timer_t mMovementBeginTick;
+            osg::Timer_t mMovementEndTick;
+            std::size_t mNumMovedActors;
+            std::size_t mNumIndependentActors;
+
             float mTimeAccum;
 
             float mWaterHeight;
@@ -0,0 +1,91 @@
+#include "workerpool.hpp"
+
+namespace MWPhysics
+{
+    WorkerPool::WorkerPool(std::size_t numThreads)
+        : mShouldStop(false)
+        , mGeneration(0)
+        , mBusyWorkers(0)
+        , mJob(nullptr)
+        , mCount(0)
+        , mNext(0)
+    {
+        for (std::size_t i = 0; i < numThreads; ++i)
+            mThreads.emplace_back([this] { process(); });
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mMutex);
+            mShouldStop = true;
+        }
+        mHasWork.notify_all();
+        for (auto& thread : mThreads)
+            thread.join();
+    }
+
+    void WorkerPool::run(std::size_t count, const std::function<void (std::size_t)>& job)
+    {
+        if (count == 0)
+            return;
+
+        {
+            const std::lock_guard<std::mutex> lock(mMutex);
+            mJob = &job;
+            mCount = count;
+            mNext = 0;
+            mError = nullptr;
+            mBusyWorkers = mThreads.size();
+            ++mGeneration;
+        }
+        mHasWork.notify_all();
+
+        work();
+
+        std::unique_lock<std::mutex> lock(mMutex);
+        mWorkDone.wait(lock, [&] { return mBusyWorkers == 0; });
+        mJob = nullptr;
+
+        if (mError)
+            std::rethrow_exception(mError);
+    }
+
+    void WorkerPool::process()
+    {
+        unsigned generation = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mHasWork.wait(lock, [&] { return mShouldStop || mGeneration != generation; });
+                if (mShouldStop)
+                    return;
+                generation = mGeneration;
+            }
+
+            work();
+
+            const std::lock_guard<std::mutex> lock(mMutex);
+            if (--mBusyWorkers == 0)
+                mWorkDone.notify_all();
+        }
+    }
+
+    void WorkerPool::work()
+    {
+        for (std::size_t index = mNext++; index < mCount; index = mNext++)
+        {
+            try
+            {
+                (*mJob)(index);
+            }
+            catch (...)
+            {
+                const std::lock_guard<std::mutex> lock(mMutex);
+                if (!mError)
+                    mError = std::current_exception();
+            }
+        }
+    }
+}
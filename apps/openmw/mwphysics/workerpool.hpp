@@ -0,0 +1,49 @@
+#ifndef OPENMW_MWPHYSICS_WORKERPOOL_H
+#define OPENMW_MWPHYSICS_WORKERPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MWPhysics
+{
+    /// @brief Threads running the iterations of a loop in parallel.
+    /// @note The thread calling run() works on the loop as well, so a pool without threads runs it sequentially.
+    class WorkerPool
+    {
+        public:
+            explicit WorkerPool(std::size_t numThreads);
+
+            ~WorkerPool();
+
+            std::size_t getNumThreads() const { return mThreads.size(); }
+
+            /// Call \a job for every index from 0 to \a count - 1, in no particular order, and wait until all calls returned.
+            /// @note If a call throws, the first exception is rethrown after the other calls returned.
+            void run(std::size_t count, const std::function<void (std::size_t)>& job);
+
+        private:
+            std::vector<std::thread> mThreads;
+            std::mutex mMutex;
+            std::condition_variable mHasWork;
+            std::condition_variable mWorkDone;
+            bool mShouldStop;
+            unsigned mGeneration; // Incremented for every run(), so workers join each run once
+            std::size_t mBusyWorkers;
+            const std::function<void (std::size_t)>* mJob;
+            std::size_t mCount;
+            std::atomic<std::size_t> mNext;
+            std::exception_ptr mError;
+
+            void process();
+
+            void work();
+    };
+}
+
+#endif
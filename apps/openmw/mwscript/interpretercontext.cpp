@@ -112,8 +112,7 @@ namespace MWScript
     int InterpreterContext::findLocalVariableIndex (const std::string& scriptId,
         const std::string& name, char type) const
     {
-        int index = MWBase::Environment::get().getScriptManager()->getLocals (scriptId).
-            searchIndex (type, name);
+        int index = MWBase::Environment::get().getScriptManager()->getLocalIndex (scriptId, name, type);
 
         if (index!=-1)
             return index;
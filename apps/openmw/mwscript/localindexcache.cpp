@@ -0,0 +1,140 @@
+#include "localindexcache.hpp"
+
+#include <utility>
+
+#include <components/misc/stringops.hpp>
+
+namespace
+{
+    std::uint64_t hash (const std::string& scriptId, const std::string& variable, char type)
+    {
+        // 64-bit FNV-1a over the lowercase characters, with the type as separator
+        std::uint64_t result = 14695981039346656037ull;
+
+        for (char ch : scriptId)
+        {
+            result ^= static_cast<unsigned char> (Misc::StringUtils::toLower (ch));
+            result *= 1099511628211ull;
+        }
+
+        result ^= static_cast<unsigned char> (type);
+        result *= 1099511628211ull;
+
+        for (char ch : variable)
+        {
+            result ^= static_cast<unsigned char> (Misc::StringUtils::toLower (ch));
+            result *= 1099511628211ull;
+        }
+
+        return result;
+    }
+
+    bool equalLowerCase (const std::string& lowerCase, const std::string& string)
+    {
+        if (lowerCase.size()!=string.size())
+            return false;
+
+        for (std::size_t i = 0; i<string.size(); ++i)
+            if (lowerCase[i]!=Misc::StringUtils::toLower (string[i]))
+                return false;
+
+        return true;
+    }
+}
+
+namespace MWScript
+{
+    LocalIndexCache::LocalIndexCache() : mMask (0), mSize (0), mHits (0) {}
+
+    bool LocalIndexCache::search (const std::string& scriptId, const std::string& variable, char type,
+        int& index)
+    {
+        if (mEntries.empty())
+            return false;
+
+        const std::uint64_t keyHash = hash (scriptId, variable, type);
+
+        for (std::size_t slot = static_cast<std::size_t> (keyHash) & mMask; !mEntries[slot].mScriptId.empty();
+            slot = (slot + 1) & mMask)
+        {
+            const Entry& entry = mEntries[slot];
+
+            if (entry.mHash==keyHash && entry.mType==type && equalLowerCase (entry.mScriptId, scriptId)
+                && equalLowerCase (entry.mVariable, variable))
+            {
+                index = entry.mIndex;
+                ++mHits;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void LocalIndexCache::insert (const std::string& scriptId, const std::string& variable, char type,
+        int index)
+    {
+        // Keep the load factor at or below 1/2 so probe sequences stay short
+        if (2 * (mSize + 1) > mEntries.size())
+            rehash (mEntries.empty() ? 64 : 2 * mEntries.size());
+
+        const std::uint64_t keyHash = hash (scriptId, variable, type);
+
+        std::size_t slot = static_cast<std::size_t> (keyHash) & mMask;
+        for (; !mEntries[slot].mScriptId.empty(); slot = (slot + 1) & mMask)
+        {
+            Entry& entry = mEntries[slot];
+
+            if (entry.mHash==keyHash && entry.mType==type && equalLowerCase (entry.mScriptId, scriptId)
+                && equalLowerCase (entry.mVariable, variable))
+            {
+                entry.mIndex = index;
+                return;
+            }
+        }
+
+        Entry& entry = mEntries[slot];
+        entry.mHash = keyHash;
+        entry.mScriptId = Misc::StringUtils::lowerCase (scriptId);
+        entry.mVariable = Misc::StringUtils::lowerCase (variable);
+        entry.mType = type;
+        entry.mIndex = index;
+        ++mSize;
+    }
+
+    void LocalIndexCache::clear()
+    {
+        mEntries.clear();
+        mMask = 0;
+        mSize = 0;
+    }
+
+    std::size_t LocalIndexCache::getSize() const
+    {
+        return mSize;
+    }
+
+    std::size_t LocalIndexCache::getHits() const
+    {
+        return mHits;
+    }
+
+    void LocalIndexCache::rehash (std::size_t capacity)
+    {
+        std::vector<Entry> entries (capacity);
+        mEntries.swap (entries);
+        mMask = capacity - 1;
+
+        for (Entry& entry : entries)
+        {
+            if (entry.mScriptId.empty())
+                continue;
+
+            std::size_t slot = static_cast<std::size_t> (entry.mHash) & mMask;
+            while (!mEntries[slot].mScriptId.empty())
+                slot = (slot + 1) & mMask;
+
+            mEntries[slot] = std::move (entry);
+        }
+    }
+}
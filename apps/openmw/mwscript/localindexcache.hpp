@@ -0,0 +1,76 @@
+#ifndef GAME_SCRIPT_LOCALINDEXCACHE_H
+#define GAME_SCRIPT_LOCALINDEXCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <components/misc/stringops.hpp>
+
+namespace MWScript
+{
+    /// \brief Indices of local variables accessed from other scripts, by script ID, variable name and type
+    ///
+    /// Member accesses like "set object.variable to 1" name the variable in the code, so without
+    /// this cache every access searches the locals of the target script by string. Script IDs and
+    /// variable names are folded to lowercase while hashing and comparing, so lookups never allocate.
+    class LocalIndexCache
+    {
+        public:
+
+            LocalIndexCache();
+
+            bool search (const std::string& scriptId, const std::string& variable, char type, int& index);
+            ///< \return Was the index (-1: variable does not exist) resolved before?
+
+            void insert (const std::string& scriptId, const std::string& variable, char type, int index);
+
+            /// \return Index of \a variable (-1: does not exist), \a getLocals returns the Compiler::Locals
+            /// of \a scriptId and is only called when the index is not cached yet.
+            template <class GetLocals>
+            int getIndex (const std::string& scriptId, const std::string& variable, char type, GetLocals getLocals)
+            {
+                int index = -1;
+
+                if (search (scriptId, variable, type, index))
+                    return index;
+
+                // Locals are declared in lowercase, the cache must not depend on the case of the first access
+                const std::string lowerCaseVariable = Misc::StringUtils::lowerCase (variable);
+                index = getLocals().searchIndex (type, lowerCaseVariable);
+                insert (scriptId, lowerCaseVariable, type, index);
+
+                return index;
+            }
+
+            void clear();
+
+            std::size_t getSize() const;
+
+            std::size_t getHits() const;
+            ///< Number of searches answered by the cache, instead of by searching the locals of a script.
+
+        private:
+
+            struct Entry
+            {
+                std::uint64_t mHash;
+                std::string mScriptId; // lowercase
+                std::string mVariable;
+                char mType;
+                int mIndex;
+
+                Entry() : mHash (0), mType (0), mIndex (-1) {}
+            };
+
+            std::vector<Entry> mEntries;
+            std::size_t mMask;
+            std::size_t mSize;
+            std::size_t mHits;
+
+            void rehash (std::size_t capacity);
+    };
+}
+
+#endif
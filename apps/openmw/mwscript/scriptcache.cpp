@@ -0,0 +1,184 @@
+#include "scriptcache.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <components/debug/debuglog.hpp>
+#include <components/esm/defs.hpp>
+#include <components/esm/esmreader.hpp>
+#include <components/esm/esmwriter.hpp>
+#include <components/files/memorymappedfile.hpp>
+
+namespace
+{
+    const int sKeyRecord = ESM::FourCC<'C','K','E','Y'>::value;
+    const int sScriptRecord = ESM::FourCC<'C','S','C','R'>::value;
+
+    /// Increase when the layout of the cache or the generated code changes
+    const int sCacheFormat = 2;
+
+    const char* const sLocalNames[] = {"LOCS", "LOCL", "LOCF"};
+    const char sLocalTypes[] = {'s', 'l', 'f'};
+
+    std::uint64_t hashText (const std::string& text)
+    {
+        // 64-bit FNV-1a
+        std::uint64_t result = 14695981039346656037ull;
+        for (char ch : text)
+        {
+            result ^= static_cast<unsigned char> (ch);
+            result *= 1099511628211ull;
+        }
+        return result;
+    }
+}
+
+namespace MWScript
+{
+    ScriptCache::ScriptCache (const std::string& path, const MWWorld::ContentFileKey& key)
+    : mPath (path), mKey (key), mChanged (false)
+    {
+        if (boost::filesystem::exists (mPath))
+            read();
+    }
+
+    bool ScriptCache::get (const std::string& name, const std::string& text, CompiledScript& compiled) const
+    {
+        std::map<std::string, Entry>::const_iterator iter = mScripts.find (name);
+
+        if (iter==mScripts.end() || iter->second.mHash!=hashText (text))
+            return false;
+
+        compiled = iter->second.mScript;
+        return true;
+    }
+
+    void ScriptCache::add (const std::string& name, const std::string& text, const CompiledScript& compiled)
+    {
+        Entry& entry = mScripts[name];
+        entry.mHash = hashText (text);
+        entry.mScript = compiled;
+        mChanged = true;
+    }
+
+    void ScriptCache::read()
+    {
+        try
+        {
+            const Files::MemoryMappedFilePtr file (new Files::MemoryMappedFile (mPath));
+
+            ESM::ESMReader reader;
+            reader.open (Files::openMemoryMappedFileStream (file), mPath);
+
+            if (reader.getFormat()!=sCacheFormat || !reader.hasMoreRecs() ||
+                reader.getRecName().intval!=sKeyRecord)
+                return;
+
+            reader.getRecHeader();
+            if (!mKey.matches (reader))
+            {
+                Log(Debug::Info) << "Script cache " << mPath << " is out of date";
+                return;
+            }
+
+            std::map<std::string, Entry> scripts;
+
+            while (reader.hasMoreRecs())
+            {
+                ESM::NAME name = reader.getRecName();
+                reader.getRecHeader();
+
+                if (name.intval!=sScriptRecord)
+                    reader.fail ("Unexpected record in script cache: " + name.toString());
+
+                std::string id = reader.getHNString ("NAME");
+                Entry& entry = scripts[id];
+                reader.getHNT (entry.mHash, "HASH");
+
+                reader.getSubNameIs ("CODE");
+                reader.getSubHeader();
+                entry.mScript.first.resize (reader.getSubSize() / sizeof (Interpreter::Type_Code));
+                if (!entry.mScript.first.empty())
+                    reader.getExact (&entry.mScript.first[0],
+                        entry.mScript.first.size() * sizeof (Interpreter::Type_Code));
+
+                for (int i=0; i<3; ++i)
+                    while (reader.isNextSub (sLocalNames[i]))
+                        entry.mScript.second.declare (sLocalTypes[i], reader.getHString());
+            }
+
+            mScripts.swap (scripts);
+            Log(Debug::Info) << "Loaded " << mScripts.size() << " compiled scripts from cache " << mPath;
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to read script cache " << mPath << ": " << e.what();
+        }
+    }
+
+    void ScriptCache::write()
+    {
+        if (!mChanged)
+            return;
+
+        const std::string tempPath = mPath + ".tmp";
+
+        try
+        {
+            boost::filesystem::ofstream stream (tempPath, std::ios::binary);
+
+            ESM::ESMWriter writer;
+            writer.setFormat (sCacheFormat);
+            writer.setVersion();
+            writer.setType (0);
+            writer.setAuthor ("");
+            writer.setDescription ("");
+            writer.save (stream);
+
+            writer.startRecord (sKeyRecord);
+            mKey.save (writer);
+            writer.endRecord (sKeyRecord);
+
+            for (std::map<std::string, Entry>::const_iterator iter (mScripts.begin());
+                iter!=mScripts.end(); ++iter)
+            {
+                const CompiledScript& script = iter->second.mScript;
+
+                writer.startRecord (sScriptRecord);
+                writer.writeHNString ("NAME", iter->first);
+                writer.writeHNT ("HASH", iter->second.mHash);
+
+                writer.startSubRecord ("CODE");
+                if (!script.first.empty())
+                    writer.write (reinterpret_cast<const char *> (&script.first[0]),
+                        script.first.size() * sizeof (Interpreter::Type_Code));
+                writer.endRecord ("CODE");
+
+                for (int i=0; i<3; ++i)
+                {
+                    const std::vector<std::string>& locals = script.second.get (sLocalTypes[i]);
+                    for (std::vector<std::string>::const_iterator local (locals.begin()); local!=locals.end(); ++local)
+                        writer.writeHNString (sLocalNames[i], *local);
+                }
+
+                writer.endRecord (sScriptRecord);
+            }
+
+            writer.close();
+            stream.close();
+
+            if (stream.fail())
+                throw std::runtime_error ("write error");
+
+            // Replace the old cache only once the new one is complete
+            boost::filesystem::rename (tempPath, mPath);
+            mChanged = false;
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to write script cache " << mPath << ": " << e.what();
+            boost::system::error_code ec;
+            boost::filesystem::remove (tempPath, ec);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef GAME_SCRIPT_SCRIPTCACHE_H
+#define GAME_SCRIPT_SCRIPTCACHE_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <components/compiler/locals.hpp>
+
+#include <components/interpreter/types.hpp>
+
+#include "../mwworld/contentfilekey.hpp"
+
+namespace MWScript
+{
+    /// \brief Compiled code and local variables of scripts, kept on disk between sessions
+    ///
+    /// Scripts are looked up by name and by a hash of their text. The whole cache is dropped when
+    /// the content files change, because the code also depends on global variables, IDs and the
+    /// local variables of other scripts.
+    class ScriptCache
+    {
+        public:
+
+            typedef std::pair<std::vector<Interpreter::Type_Code>, Compiler::Locals> CompiledScript;
+
+            ScriptCache (const std::string& path, const MWWorld::ContentFileKey& key);
+            ///< Read the cache from \a path, if it was written for the same content files.
+
+            bool get (const std::string& name, const std::string& text, CompiledScript& compiled) const;
+            ///< \return Was code compiled from \a text found?
+
+            void add (const std::string& name, const std::string& text, const CompiledScript& compiled);
+
+            void write();
+            ///< Write the cache to disk, if scripts were added since it was read.
+
+        private:
+
+            struct Entry
+            {
+                std::uint64_t mHash;
+                CompiledScript mScript;
+            };
+
+            std::string mPath;
+            MWWorld::ContentFileKey mKey;
+            std::map<std::string, Entry> mScripts;
+            bool mChanged;
+
+            void read();
+    };
+}
+
+#endif
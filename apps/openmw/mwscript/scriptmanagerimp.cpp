@@ -1,9 +1,11 @@
 #include "scriptmanagerimp.hpp"
 
+#include <atomic>
 #include <cassert>
 #include <sstream>
 #include <exception>
 #include <algorithm>
+#include <thread>
 
 #include <components/debug/debuglog.hpp>
 
@@ -24,10 +26,11 @@ namespace MWScript
 {
     ScriptManager::ScriptManager (const MWWorld::ESMStore& store,
         Compiler::Context& compilerContext, int warningsMode,
-        const std::vector<std::string>& scriptBlacklist)
+        const std::vector<std::string>& scriptBlacklist, std::size_t compileThreads)
     : mErrorHandler (std::cerr), mStore (store),
       mCompilerContext (compilerContext), mParser (mErrorHandler, mCompilerContext),
-      mOpcodesInstalled (false), mGlobalScripts (store)
+      mOpcodesInstalled (false), mWarningsMode (warningsMode),
+      mCompileThreads (std::max<std::size_t> (compileThreads, 1)), mGlobalScripts (store)
     {
         mErrorHandler.setWarningsMode (warningsMode);
 
@@ -38,50 +41,82 @@ namespace MWScript
         std::sort (mScriptBlacklist.begin(), mScriptBlacklist.end());
     }
 
-    bool ScriptManager::compile (const std::string& name)
+    ScriptManager::~ScriptManager()
     {
-        mParser.reset();
-        mErrorHandler.reset();
+        // Keep the scripts that were compiled on demand for the next session
+        if (mCache)
+            mCache->write();
 
-        if (const ESM::Script *script = mStore.get<ESM::Script>().find (name))
-        {
-            mErrorHandler.setContext(name);
+        Log(Debug::Verbose) << "Resolved " << mLocalIndices.getSize() << " member variables of other scripts, "
+            << mLocalIndices.getHits() << " accesses avoided searching them by name";
+    }
 
-            bool Success = true;
-            try
-            {
-                std::istringstream input (script->mScriptText);
+    void ScriptManager::setCache (std::unique_ptr<ScriptCache> cache)
+    {
+        mCache = std::move (cache);
+    }
 
-                Compiler::Scanner scanner (mErrorHandler, input, mCompilerContext.getExtensions());
+    bool ScriptManager::compile (const ESM::Script& script, Compiler::FileParser& parser,
+        Compiler::StreamErrorHandler& errorHandler, CompiledScript& compiled) const
+    {
+        parser.reset();
+        errorHandler.reset();
+        errorHandler.setContext(script.mId);
 
-                scanner.scan (mParser);
+        bool Success = true;
+        try
+        {
+            std::istringstream input (script.mScriptText);
 
-                if (!mErrorHandler.isGood())
-                    Success = false;
-            }
-            catch (const Compiler::SourceException&)
-            {
-                // error has already been reported via error handler
-                Success = false;
-            }
-            catch (const std::exception& error)
-            {
-                Log(Debug::Error) << "Error: An exception has been thrown: " << error.what();
+            Compiler::Scanner scanner (errorHandler, input, mCompilerContext.getExtensions());
+
+            scanner.scan (parser);
+
+            if (!errorHandler.isGood())
                 Success = false;
-            }
+        }
+        catch (const Compiler::SourceException&)
+        {
+            // error has already been reported via error handler
+            Success = false;
+        }
+        catch (const std::exception& error)
+        {
+            Log(Debug::Error) << "Error: An exception has been thrown: " << error.what();
+            Success = false;
+        }
+
+        if (!Success)
+        {
+            Log(Debug::Warning)
+                << "Warning: compiling failed: " << script.mId;
+            return false;
+        }
+
+        parser.getCode (compiled.first);
+        compiled.second = parser.getLocals();
+
+        return true;
+    }
 
-            if (!Success)
+    bool ScriptManager::compile (const std::string& name)
+    {
+        if (const ESM::Script *script = mStore.get<ESM::Script>().find (name))
+        {
+            CompiledScript compiled;
+
+            if (mCache && mCache->get (Misc::StringUtils::lowerCase (name), script->mScriptText, compiled))
             {
-                Log(Debug::Warning)
-                    << "Warning: compiling failed: " << name;
+                mScripts.insert (std::make_pair (name, compiled));
+                return true;
             }
 
-            if (Success)
+            if (compile (*script, mParser, mErrorHandler, compiled))
             {
-                std::vector<Interpreter::Type_Code> code;
-                mParser.getCode (code);
-                mScripts.insert (std::make_pair (name, std::make_pair (code, mParser.getLocals())));
+                if (mCache)
+                    mCache->add (Misc::StringUtils::lowerCase (name), script->mScriptText, compiled);
 
+                mScripts.insert (std::make_pair (name, compiled));
                 return true;
             }
         }
@@ -136,6 +171,8 @@ namespace MWScript
 
         const MWWorld::Store<ESM::Script>& scripts = mStore.get<ESM::Script>();
 
+        std::vector<const ESM::Script *> pending;
+
         for (MWWorld::Store<ESM::Script>::iterator iter = scripts.begin();
             iter != scripts.end(); ++iter)
             if (!std::binary_search (mScriptBlacklist.begin(), mScriptBlacklist.end(),
@@ -143,9 +180,64 @@ namespace MWScript
             {
                 ++count;
 
-                if (compile (iter->mId))
+                CompiledScript compiled;
+
+                if (mCache && mCache->get (Misc::StringUtils::lowerCase (iter->mId), iter->mScriptText, compiled))
+                {
+                    mScripts.insert (std::make_pair (iter->mId, compiled));
                     ++success;
+                }
+                else
+                    pending.push_back (&*iter);
+            }
+
+        // The compiler context only reads from the world, so the remaining scripts can be compiled
+        // in parallel. The results are added to mScripts once all threads are done.
+        std::vector<CompiledScript> compiled (pending.size());
+        std::vector<char> compiledSuccessfully (pending.size(), 0);
+        std::atomic<std::size_t> next (0);
+        std::mutex errorsMutex;
+
+        auto compilePending = [&] ()
+        {
+            std::ostringstream errors;
+            Compiler::StreamErrorHandler errorHandler (errors);
+            errorHandler.setWarningsMode (mWarningsMode);
+            Compiler::FileParser parser (errorHandler, mCompilerContext);
+
+            for (std::size_t index = next++; index < pending.size(); index = next++)
+            {
+                compiledSuccessfully[index] = compile (*pending[index], parser, errorHandler, compiled[index]);
+
+                if (errors.tellp() > 0)
+                {
+                    const std::lock_guard<std::mutex> lock (errorsMutex);
+                    std::cerr << errors.str();
+                    errors.str (std::string());
+                }
             }
+        };
+
+        std::vector<std::thread> threads;
+        for (std::size_t i = 1; i < std::min (mCompileThreads, pending.size()); ++i)
+            threads.emplace_back (compilePending);
+        compilePending();
+        for (std::thread& thread : threads)
+            thread.join();
+
+        for (std::size_t i = 0; i < pending.size(); ++i)
+            if (compiledSuccessfully[i])
+            {
+                ++success;
+
+                if (mCache)
+                    mCache->add (Misc::StringUtils::lowerCase (pending[i]->mId), pending[i]->mScriptText, compiled[i]);
+
+                mScripts.insert (std::make_pair (pending[i]->mId, compiled[i]));
+            }
+
+        if (mCache)
+            mCache->write();
 
         return std::make_pair (count, success);
     }
@@ -154,6 +246,8 @@ namespace MWScript
     {
         std::string name2 = Misc::StringUtils::lowerCase (name);
 
+        const std::lock_guard<std::recursive_mutex> lock (mOtherLocalsMutex);
+
         {
             ScriptCollection::iterator iter = mScripts.find (name2);
 
@@ -188,6 +282,13 @@ namespace MWScript
         throw std::logic_error ("script " + name + " does not exist");
     }
 
+    int ScriptManager::getLocalIndex (const std::string& scriptId, const std::string& variable, char type)
+    {
+        // The locals of a script never change once they are known, so neither do the indices
+        return mLocalIndices.getIndex (scriptId, variable, type,
+            [&] () -> const Compiler::Locals& { return getLocals (scriptId); });
+    }
+
     GlobalScripts& ScriptManager::getGlobalScripts()
     {
         return mGlobalScripts;
@@ -2,6 +2,8 @@
 #define GAME_SCRIPT_SCRIPTMANAGER_H
 
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include <components/compiler/streamerrorhandler.hpp>
@@ -13,6 +15,13 @@
 #include "../mwbase/scriptmanager.hpp"
 
 #include "globalscripts.hpp"
+#include "localindexcache.hpp"
+#include "scriptcache.hpp"
+
+namespace ESM
+{
+    struct Script;
+}
 
 namespace MWWorld
 {
@@ -40,20 +49,37 @@ namespace MWScript
             Compiler::FileParser mParser;
             Interpreter::Interpreter mInterpreter;
             bool mOpcodesInstalled;
+            int mWarningsMode;
+            std::size_t mCompileThreads;
 
-            typedef std::pair<std::vector<Interpreter::Type_Code>, Compiler::Locals> CompiledScript;
+            typedef ScriptCache::CompiledScript CompiledScript;
             typedef std::map<std::string, CompiledScript> ScriptCollection;
 
             ScriptCollection mScripts;
             GlobalScripts mGlobalScripts;
             std::map<std::string, Compiler::Locals> mOtherLocals;
+            std::recursive_mutex mOtherLocalsMutex; // getLocals is called by the compiler threads of compileAll
             std::vector<std::string> mScriptBlacklist;
+            std::unique_ptr<ScriptCache> mCache;
+            LocalIndexCache mLocalIndices; // Only used by the main thread
+
+            bool compile (const ESM::Script& script, Compiler::FileParser& parser,
+                Compiler::StreamErrorHandler& errorHandler, CompiledScript& compiled) const;
+            ///< Compile \a script without adding it to the compiled scripts.
+            /// \note Thread safe, as long as every thread has its own parser and error handler.
 
         public:
 
             ScriptManager (const MWWorld::ESMStore& store,
                 Compiler::Context& compilerContext, int warningsMode,
-                const std::vector<std::string>& scriptBlacklist);
+                const std::vector<std::string>& scriptBlacklist, std::size_t compileThreads = 1);
+            ///< \param compileThreads Number of threads used by compileAll
+
+            virtual ~ScriptManager();
+
+            void setCache (std::unique_ptr<ScriptCache> cache);
+            ///< Look up compiled scripts in \a cache before compiling them and add newly compiled
+            /// scripts to it.
 
             virtual void run (const std::string& name, Interpreter::Context& interpreterContext);
             ///< Run the script with the given name (compile first, if not compiled yet)
@@ -63,12 +89,16 @@ namespace MWScript
             /// \return Success?
 
             virtual std::pair<int, int> compileAll();
-            ///< Compile all scripts
+            ///< Compile all scripts, in parallel
             /// \return count, success
 
             virtual const Compiler::Locals& getLocals (const std::string& name);
             ///< Return locals for script \a name.
 
+            virtual int getLocalIndex (const std::string& scriptId, const std::string& variable, char type);
+            ///< Return index of local variable \a variable of type \a type in script \a scriptId
+            /// (-1: variable does not exist). Resolved once per script and variable.
+
             virtual GlobalScripts& getGlobalScripts();
     };
 }
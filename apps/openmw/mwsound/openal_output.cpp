@@ -942,52 +942,31 @@ void OpenAL_Output::setHrtf(const std::string &hrtfname, HrtfMode hrtfmode)
 }
 
 
-std::pair<Sound_Handle,size_t> OpenAL_Output::loadSound(const std::string &fname)
+std::pair<Sound_Handle,size_t> OpenAL_Output::loadSound(const DecodedSound &sound)
 {
     getALError();
 
-    std::vector<char> data;
+    const char *data = sound.mData.data();
+    size_t datasize = sound.mData.size();
     ALenum format = AL_NONE;
-    int srate = 0;
+    int srate = sound.mSampleRate;
+    if(datasize > 0)
+        format = getALFormat(sound.mChannelConfig, sound.mSampleType);
 
-    try
-    {
-        DecoderPtr decoder = mManager.getDecoder();
-        // Workaround: Bethesda at some point converted some of the files to mp3, but the references were kept as .wav.
-        if(decoder->mResourceMgr->exists(fname))
-            decoder->open(fname);
-        else
-        {
-            std::string file = fname;
-            std::string::size_type pos = file.rfind('.');
-            if(pos != std::string::npos)
-                file = file.substr(0, pos)+".mp3";
-            decoder->open(file);
-        }
-
-        ChannelConfig chans;
-        SampleType type;
-        decoder->getInfo(&srate, &chans, &type);
-        format = getALFormat(chans, type);
-        if(format) decoder->readAll(data);
-    }
-    catch(std::exception &e)
-    {
-        Log(Debug::Error) << "Failed to load audio from " << fname << ": " << e.what();
-    }
-
-    if(data.empty())
+    static const std::vector<char> silence(8000, -128);
+    if(!format)
     {
         // If we failed to get any usable audio, substitute with silence.
         format = AL_FORMAT_MONO8;
         srate = 8000;
-        data.assign(8000, -128);
+        data = silence.data();
+        datasize = silence.size();
     }
 
     ALint size;
     ALuint buf = 0;
     alGenBuffers(1, &buf);
-    alBufferData(buf, format, data.data(), data.size(), srate);
+    alBufferData(buf, format, data, datasize, srate);
     alGetBufferi(buf, AL_SIZE, &size);
     if(getALError() != AL_NO_ERROR)
     {
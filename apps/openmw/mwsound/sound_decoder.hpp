@@ -30,6 +30,18 @@ namespace MWSound
     size_t framesToBytes(size_t frames, ChannelConfig config, SampleType type);
     size_t bytesToFrames(size_t bytes, ChannelConfig config, SampleType type);
 
+    // Fully decoded sound data, ready to be handed to the output
+    struct DecodedSound
+    {
+        std::vector<char> mData;
+        ChannelConfig mChannelConfig;
+        SampleType mSampleType;
+        int mSampleRate;
+
+        DecodedSound() : mChannelConfig(ChannelConfig_Mono), mSampleType(SampleType_UInt8), mSampleRate(0)
+        { }
+    };
+
     struct Sound_Decoder
     {
         const VFS::Manager* mResourceMgr;
@@ -3,11 +3,15 @@
 #include <algorithm>
 #include <map>
 #include <numeric>
+#include <set>
 
 #include <osg/Matrixf>
+#include <osg/Stats>
+#include <osg/Timer>
 
 #include <components/misc/rng.hpp>
 #include <components/debug/debuglog.hpp>
+#include <components/sceneutil/workqueue.hpp>
 #include <components/vfs/manager.hpp>
 
 #include "../mwbase/environment.hpp"
@@ -33,6 +37,64 @@ namespace MWSound
     // For combining PlayMode and Type flags
     inline int operator|(PlayMode a, Type b) { return static_cast<int>(a) | static_cast<int>(b); }
 
+    // Opens a sound file in the background, and decodes all of it unless it is going to be streamed
+    class LoadAudioItem : public SceneUtil::WorkItem
+    {
+    public:
+        LoadAudioItem(DecoderPtr decoder, const std::string &fname, bool stream)
+            : mDecoder(decoder), mFileName(fname), mStream(stream), mDecodeTime(0.0)
+        { }
+
+        virtual void doWork()
+        {
+            osg::Timer_t startTick = osg::Timer::instance()->tick();
+            try
+            {
+                // Workaround: Bethesda at some point converted some of the files to mp3, but the references were kept as .wav.
+                if(mDecoder->mResourceMgr->exists(mFileName))
+                    mDecoder->open(mFileName);
+                else
+                {
+                    std::string file = mFileName;
+                    std::string::size_type pos = file.rfind('.');
+                    if(pos != std::string::npos)
+                        file = file.substr(0, pos)+".mp3";
+                    mDecoder->open(file);
+                }
+
+                if(!mStream)
+                {
+                    mDecoder->getInfo(&mDecoded.mSampleRate, &mDecoded.mChannelConfig, &mDecoded.mSampleType);
+                    mDecoder->readAll(mDecoded.mData);
+                    mDecoder->close();
+                    mDecoder.reset();
+                }
+            }
+            catch(std::exception &e)
+            {
+                Log(Debug::Error) << "Failed to load audio from " << mFileName << ": " << e.what();
+                mDecoder.reset();
+                mDecoded.mData.clear();
+            }
+            mDecodeTime = osg::Timer::instance()->delta_m(startTick, osg::Timer::instance()->tick());
+        }
+
+        // The opened decoder of a streamed file, or nullptr if it failed to open
+        const DecoderPtr& getDecoder() const { return mDecoder; }
+
+        // The decoded data of a file that isn't streamed, empty if it failed to decode
+        const DecodedSound& getDecoded() const { return mDecoded; }
+
+        double getDecodeTime() const { return mDecodeTime; }
+
+    private:
+        DecoderPtr mDecoder;
+        std::string mFileName;
+        bool mStream;
+        DecodedSound mDecoded;
+        double mDecodeTime;
+    };
+
     SoundManager::SoundManager(const VFS::Manager* vfs, const std::map<std::string, std::string>& fallbackMap, bool useSound)
         : mVFS(vfs)
         , mFallback(fallbackMap)
@@ -46,6 +108,10 @@ namespace MWSound
         , mBufferCacheSize(0)
         , mSounds(new std::deque<Sound>())
         , mStreams(new std::deque<Stream>())
+        , mNumCacheHits(0)
+        , mNumCacheMisses(0)
+        , mNumDecoded(0)
+        , mDecodeTime(0.0)
         , mMusic(nullptr)
         , mListenerUnderwater(false)
         , mListenerPos(0,0,0)
@@ -96,6 +162,8 @@ namespace MWSound
             return;
         }
 
+        mLoadQueue = new SceneUtil::WorkQueue(1);
+
         std::vector<std::string> names = mOutput->enumerate();
         std::stringstream stream;
 
@@ -120,6 +188,8 @@ namespace MWSound
     SoundManager::~SoundManager()
     {
         clear();
+        mLoadingBuffers.clear();
+        mLoadQueue = nullptr;
         for(Sound_Buffer &sfx : *mSoundBuffers)
         {
             if(sfx.mHandle)
@@ -174,16 +244,13 @@ namespace MWSound
     {
         NameBufferMap::const_iterator snd = mBufferNameMap.find(soundId);
         if(snd != mBufferNameMap.end())
-        {
-            Sound_Buffer *sfx = snd->second;
-            if(sfx->mHandle) return sfx;
-        }
+            return snd->second;
         return nullptr;
     }
 
     // Lookup a soundId for its sound data (resource name, local volume,
-    // minRange, and maxRange), and ensure it's ready for use.
-    Sound_Buffer *SoundManager::loadSound(const std::string &soundId)
+    // minRange, and maxRange), adding it if it wasn't used before.
+    Sound_Buffer *SoundManager::findSound(const std::string &soundId)
     {
 #ifdef __GNUC__
 #define LIKELY(x) __builtin_expect((bool)(x), true)
@@ -199,76 +266,172 @@ namespace MWSound
                 insertSound(Misc::StringUtils::lowerCase(sound.mId), &sound);
         }
 
-        Sound_Buffer *sfx;
         NameBufferMap::const_iterator snd = mBufferNameMap.find(soundId);
         if(LIKELY(snd != mBufferNameMap.end()))
-            sfx = snd->second;
-        else
-        {
-            MWBase::World *world = MWBase::Environment::get().getWorld();
-            const ESM::Sound *sound = world->getStore().get<ESM::Sound>().search(soundId);
-            if(!sound) return nullptr;
-            sfx = insertSound(soundId, sound);
-        }
+            return snd->second;
 #undef LIKELY
 #undef UNLIKELY
 
-        if(!sfx->mHandle)
+        MWBase::World *world = MWBase::Environment::get().getWorld();
+        const ESM::Sound *sound = world->getStore().get<ESM::Sound>().search(soundId);
+        if(!sound) return nullptr;
+        return insertSound(soundId, sound);
+    }
+
+    void SoundManager::startLoading(Sound_Buffer *sfx)
+    {
+        if(sfx->mHandle || mLoadingBuffers.find(sfx) != mLoadingBuffers.end())
+            return;
+
+        osg::ref_ptr<LoadAudioItem> item = new LoadAudioItem(getDecoder(), sfx->mResourceName, false);
+        mLoadQueue->addWorkItem(item);
+        mLoadingBuffers.insert(std::make_pair(sfx, item));
+    }
+
+    void SoundManager::fillBuffer(Sound_Buffer *sfx, const DecodedSound &decoded)
+    {
+        size_t size;
+        std::tie(sfx->mHandle, size) = mOutput->loadSound(decoded);
+        if(!sfx->mHandle) return;
+
+        // The buffer may still be listed as unused if the sounds waiting for it were stopped
+        SoundList::iterator iter = std::find(mUnusedBuffers.begin(), mUnusedBuffers.end(), sfx);
+        if(iter != mUnusedBuffers.end())
+            mUnusedBuffers.erase(iter);
+
+        mBufferCacheSize += size;
+        if(mBufferCacheSize > mBufferCacheMax)
         {
-            size_t size;
-            std::tie(sfx->mHandle, size) = mOutput->loadSound(sfx->mResourceName);
-            if(!sfx->mHandle) return nullptr;
+            do {
+                if(mUnusedBuffers.empty())
+                {
+                    Log(Debug::Warning) << "No unused sound buffers to free, using " << mBufferCacheSize << " bytes!";
+                    break;
+                }
+                Sound_Buffer *unused = mUnusedBuffers.back();
+
+                size = mOutput->unloadSound(unused->mHandle);
+                mBufferCacheSize -= size;
+                unused->mHandle = 0;
+
+                mUnusedBuffers.pop_back();
+            } while(mBufferCacheSize > mBufferCacheMin);
+        }
+        if(sfx->mUses == 0)
+            mUnusedBuffers.push_front(sfx);
+    }
 
-            mBufferCacheSize += size;
-            if(mBufferCacheSize > mBufferCacheMax)
+    void SoundManager::updateLoading()
+    {
+        LoadingBufferMap::iterator bufiter = mLoadingBuffers.begin();
+        while(bufiter != mLoadingBuffers.end())
+        {
+            const LoadAudioItem *item = bufiter->second.get();
+            if(!item->isDone())
             {
-                do {
-                    if(mUnusedBuffers.empty())
-                    {
-                        Log(Debug::Warning) << "No unused sound buffers to free, using " << mBufferCacheSize << " bytes!";
-                        break;
-                    }
-                    Sound_Buffer *unused = mUnusedBuffers.back();
+                ++bufiter;
+                continue;
+            }
 
-                    size = mOutput->unloadSound(unused->mHandle);
-                    mBufferCacheSize -= size;
-                    unused->mHandle = 0;
+            fillBuffer(bufiter->first, item->getDecoded());
+            ++mNumDecoded;
+            mDecodeTime += item->getDecodeTime();
+            bufiter = mLoadingBuffers.erase(bufiter);
+        }
 
-                    mUnusedBuffers.pop_back();
-                } while(mBufferCacheSize > mBufferCacheMin);
+        PendingSoundList::iterator penditer = mPendingSounds.begin();
+        while(penditer != mPendingSounds.end())
+        {
+            Sound *sound = penditer->mSound;
+            Sound_Buffer *sfx = penditer->mBuffer;
+            if(mLoadingBuffers.find(sfx) != mLoadingBuffers.end()
+                || (mPausedSoundTypes & static_cast<int>(sound->getPlayType())))
+            {
+                ++penditer;
+                continue;
             }
-            mUnusedBuffers.push_front(sfx);
+
+            // If the buffer failed to load, the sound is left stopped to be cleaned up by updateSounds
+            if(sfx->mHandle)
+            {
+                if(sound->getIs3D())
+                    mOutput->playSound3D(sound, sfx->mHandle, penditer->mOffset);
+                else
+                    mOutput->playSound(sound, sfx->mHandle, penditer->mOffset);
+            }
+            penditer = mPendingSounds.erase(penditer);
         }
 
-        return sfx;
-    }
+        if(mPausedSoundTypes & static_cast<int>(Type::Voice))
+            return;
 
-    DecoderPtr SoundManager::loadVoice(const std::string &voicefile)
-    {
-        try
+        PendingVoiceMap::iterator voiceiter = mPendingSaySounds.begin();
+        while(voiceiter != mPendingSaySounds.end())
         {
-            DecoderPtr decoder = getDecoder();
-
-            // Workaround: Bethesda at some point converted some of the files to mp3, but the references were kept as .wav.
-            if(mVFS->exists(voicefile))
-                decoder->open(voicefile);
-            else
+            const PendingVoice &voice = voiceiter->second;
+            if(!voice.mItem->isDone())
             {
-                std::string file = voicefile;
-                std::string::size_type pos = file.rfind('.');
-                if(pos != std::string::npos)
-                    file = file.substr(0, pos)+".mp3";
-                decoder->open(file);
+                ++voiceiter;
+                continue;
             }
 
-            return decoder;
+            const MWWorld::ConstPtr &ptr = voiceiter->first;
+            if(const DecoderPtr &decoder = voice.mItem->getDecoder())
+            {
+                osg::Vec3f pos;
+                if(!ptr.isEmpty())
+                    pos = MWBase::Environment::get().getWorld()->getActorHeadTransform(ptr).getTrans();
+
+                Stream *sound = playVoice(decoder, pos, voice.mPlayLocal);
+                if(sound)
+                    mActiveSaySounds.insert(std::make_pair(ptr, sound));
+            }
+            voiceiter = mPendingSaySounds.erase(voiceiter);
         }
-        catch(std::exception &e)
+    }
+
+    osg::ref_ptr<LoadAudioItem> SoundManager::loadVoice(const std::string &voicefile)
+    {
+        osg::ref_ptr<LoadAudioItem> item = new LoadAudioItem(getDecoder(), voicefile, true);
+        // Voices are played as soon as they're ready, so don't let them wait for preloaded sounds
+        mLoadQueue->addWorkItem(item, true);
+        return item;
+    }
+
+    bool SoundManager::playBuffer(Sound *sound, Sound_Buffer *sfx, float offset)
+    {
+        if(!sfx->mHandle)
         {
-            Log(Debug::Error) << "Failed to load audio from " << voicefile << ": " << e.what();
+            ++mNumCacheMisses;
+            startLoading(sfx);
+            PendingSound pending;
+            pending.mSound = sound;
+            pending.mBuffer = sfx;
+            pending.mOffset = offset;
+            mPendingSounds.push_back(pending);
+            return true;
         }
 
-        return nullptr;
+        ++mNumCacheHits;
+        if(sound->getIs3D())
+            return mOutput->playSound3D(sound, sfx->mHandle, offset);
+        return mOutput->playSound(sound, sfx->mHandle, offset);
+    }
+
+    void SoundManager::finishSound(Sound *sound)
+    {
+        PendingSoundList::iterator iter = std::find_if(mPendingSounds.begin(), mPendingSounds.end(),
+            [sound](const PendingSound &pending) -> bool { return pending.mSound == sound; });
+        if(iter != mPendingSounds.end())
+            mPendingSounds.erase(iter);
+        mOutput->finishSound(sound);
+    }
+
+    bool SoundManager::isSoundPlaying(Sound *sound) const
+    {
+        PendingSoundList::const_iterator iter = std::find_if(mPendingSounds.begin(), mPendingSounds.end(),
+            [sound](const PendingSound &pending) -> bool { return pending.mSound == sound; });
+        return iter != mPendingSounds.end() || mOutput->isSoundPlaying(sound);
     }
 
     Sound *SoundManager::getSoundRef()
@@ -480,18 +643,12 @@ namespace MWSound
         std::string voicefile = "Sound/"+filename;
 
         mVFS->normalizeFilename(voicefile);
-        DecoderPtr decoder = loadVoice(voicefile);
-        if (!decoder)
-            return;
-
-        MWBase::World *world = MWBase::Environment::get().getWorld();
-        const osg::Vec3f pos = world->getActorHeadTransform(ptr).getTrans();
 
         stopSay(ptr);
-        Stream *sound = playVoice(decoder, pos, (ptr == MWMechanics::getPlayer()));
-        if(!sound) return;
-
-        mActiveSaySounds.insert(std::make_pair(ptr, sound));
+        PendingVoice voice;
+        voice.mItem = loadVoice(voicefile);
+        voice.mPlayLocal = (ptr == MWMechanics::getPlayer());
+        mPendingSaySounds.insert(std::make_pair(ptr, voice));
     }
 
     float SoundManager::getSaySoundLoudness(const MWWorld::ConstPtr &ptr) const
@@ -514,19 +671,19 @@ namespace MWSound
         std::string voicefile = "Sound/"+filename;
 
         mVFS->normalizeFilename(voicefile);
-        DecoderPtr decoder = loadVoice(voicefile);
-        if (!decoder)
-            return;
 
         stopSay(MWWorld::ConstPtr());
-        Stream *sound = playVoice(decoder, osg::Vec3f(), true);
-        if(!sound) return;
-
-        mActiveSaySounds.insert(std::make_pair(MWWorld::ConstPtr(), sound));
+        PendingVoice voice;
+        voice.mItem = loadVoice(voicefile);
+        voice.mPlayLocal = true;
+        mPendingSaySounds.insert(std::make_pair(MWWorld::ConstPtr(), voice));
     }
 
     bool SoundManager::sayDone(const MWWorld::ConstPtr &ptr) const
     {
+        if(mPendingSaySounds.find(ptr) != mPendingSaySounds.end())
+            return false;
+
         SaySoundMap::const_iterator snditer = mActiveSaySounds.find(ptr);
         if(snditer != mActiveSaySounds.end())
         {
@@ -539,6 +696,8 @@ namespace MWSound
 
     void SoundManager::stopSay(const MWWorld::ConstPtr &ptr)
     {
+        mPendingSaySounds.erase(ptr);
+
         SaySoundMap::iterator snditer = mActiveSaySounds.find(ptr);
         if(snditer != mActiveSaySounds.end())
         {
@@ -588,7 +747,7 @@ namespace MWSound
         if(!mOutput->isInitialized())
             return nullptr;
 
-        Sound_Buffer *sfx = loadSound(Misc::StringUtils::lowerCase(soundId));
+        Sound_Buffer *sfx = findSound(Misc::StringUtils::lowerCase(soundId));
         if(!sfx) return nullptr;
 
         // Only one copy of given sound can be played at time, so stop previous copy
@@ -596,7 +755,7 @@ namespace MWSound
 
         Sound *sound = getSoundRef();
         sound->init(volume * sfx->mVolume, volumeFromType(type), pitch, mode|type|Play_2D);
-        if(!mOutput->playSound(sound, sfx->mHandle, offset))
+        if(!playBuffer(sound, sfx, offset))
         {
             mUnusedSounds.push_back(sound);
             return nullptr;
@@ -620,7 +779,7 @@ namespace MWSound
             return nullptr;
 
         // Look up the sound in the ESM data
-        Sound_Buffer *sfx = loadSound(Misc::StringUtils::lowerCase(soundId));
+        Sound_Buffer *sfx = findSound(Misc::StringUtils::lowerCase(soundId));
         if(!sfx) return nullptr;
 
         const osg::Vec3f objpos(ptr.getRefData().getPosition().asVec3());
@@ -630,20 +789,13 @@ namespace MWSound
         // Only one copy of given sound can be played at time on ptr, so stop previous copy
         stopSound(sfx, ptr);
 
-        bool played;
         Sound *sound = getSoundRef();
         if(!(mode&PlayMode::NoPlayerLocal) && ptr == MWMechanics::getPlayer())
-        {
             sound->init(volume * sfx->mVolume, volumeFromType(type), pitch, mode|type|Play_2D);
-            played = mOutput->playSound(sound, sfx->mHandle, offset);
-        }
         else
-        {
             sound->init(objpos, volume * sfx->mVolume, volumeFromType(type), pitch,
                         sfx->mMinDist, sfx->mMaxDist, mode|type|Play_3D);
-            played = mOutput->playSound3D(sound, sfx->mHandle, offset);
-        }
-        if(!played)
+        if(!playBuffer(sound, sfx, offset))
         {
             mUnusedSounds.push_back(sound);
             return nullptr;
@@ -667,13 +819,13 @@ namespace MWSound
             return nullptr;
 
         // Look up the sound in the ESM data
-        Sound_Buffer *sfx = loadSound(Misc::StringUtils::lowerCase(soundId));
+        Sound_Buffer *sfx = findSound(Misc::StringUtils::lowerCase(soundId));
         if(!sfx) return nullptr;
 
         Sound *sound = getSoundRef();
         sound->init(initialPos, volume * sfx->mVolume, volumeFromType(type), pitch,
                     sfx->mMinDist, sfx->mMaxDist, mode|type|Play_3D);
-        if(!mOutput->playSound3D(sound, sfx->mHandle, offset))
+        if(!playBuffer(sound, sfx, offset))
         {
             mUnusedSounds.push_back(sound);
             return nullptr;
@@ -692,7 +844,7 @@ namespace MWSound
     void SoundManager::stopSound(Sound *sound)
     {
         if(sound)
-            mOutput->finishSound(sound);
+            finishSound(sound);
     }
 
     void SoundManager::stopSound(Sound_Buffer *sfx, const MWWorld::ConstPtr &ptr)
@@ -703,14 +855,14 @@ namespace MWSound
             for(SoundBufferRefPair &snd : snditer->second)
             {
                 if(snd.second == sfx)
-                    mOutput->finishSound(snd.first);
+                    finishSound(snd.first);
             }
         }
     }
 
     void SoundManager::stopSound(const std::string& soundId)
     {
-        Sound_Buffer *sfx = loadSound(Misc::StringUtils::lowerCase(soundId));
+        Sound_Buffer *sfx = findSound(Misc::StringUtils::lowerCase(soundId));
         if (!sfx) return;
 
         stopSound(sfx, MWWorld::ConstPtr());
@@ -718,7 +870,7 @@ namespace MWSound
 
     void SoundManager::stopSound3D(const MWWorld::ConstPtr &ptr, const std::string& soundId)
     {
-        Sound_Buffer *sfx = loadSound(Misc::StringUtils::lowerCase(soundId));
+        Sound_Buffer *sfx = findSound(Misc::StringUtils::lowerCase(soundId));
         if (!sfx) return;
 
         stopSound(sfx, ptr);
@@ -730,8 +882,9 @@ namespace MWSound
         if(snditer != mActiveSounds.end())
         {
             for(SoundBufferRefPair &snd : snditer->second)
-                mOutput->finishSound(snd.first);
+                finishSound(snd.first);
         }
+        mPendingSaySounds.erase(ptr);
         SaySoundMap::iterator sayiter = mActiveSaySounds.find(ptr);
         if(sayiter != mActiveSaySounds.end())
             mOutput->finishStream(sayiter->second);
@@ -744,10 +897,19 @@ namespace MWSound
             if(!snd.first.isEmpty() && snd.first != MWMechanics::getPlayer() && snd.first.getCell() == cell)
             {
                 for(SoundBufferRefPair &sndbuf : snd.second)
-                    mOutput->finishSound(sndbuf.first);
+                    finishSound(sndbuf.first);
             }
         }
 
+        PendingVoiceMap::iterator voiceiter = mPendingSaySounds.begin();
+        while(voiceiter != mPendingSaySounds.end())
+        {
+            if(!voiceiter->first.isEmpty() && voiceiter->first != MWMechanics::getPlayer() && voiceiter->first.getCell() == cell)
+                voiceiter = mPendingSaySounds.erase(voiceiter);
+            else
+                ++voiceiter;
+        }
+
         for(SaySoundMap::value_type &snd : mActiveSaySounds)
         {
             if(!snd.first.isEmpty() && snd.first != MWMechanics::getPlayer() && snd.first.getCell() == cell)
@@ -761,7 +923,7 @@ namespace MWSound
         SoundMap::iterator snditer = mActiveSounds.find(ptr);
         if(snditer != mActiveSounds.end())
         {
-            Sound_Buffer *sfx = loadSound(Misc::StringUtils::lowerCase(soundId));
+            Sound_Buffer *sfx = findSound(Misc::StringUtils::lowerCase(soundId));
             for(SoundBufferRefPair &sndbuf : snditer->second)
             {
                 if(sndbuf.second == sfx)
@@ -778,7 +940,7 @@ namespace MWSound
             Sound_Buffer *sfx = lookupSound(Misc::StringUtils::lowerCase(soundId));
             return std::find_if(snditer->second.cbegin(), snditer->second.cend(),
                 [this,sfx](const SoundBufferRefPair &snd) -> bool
-                { return snd.second == sfx && mOutput->isSoundPlaying(snd.first); }
+                { return snd.second == sfx && isSoundPlaying(snd.first); }
             ) != snditer->second.cend();
         }
         return false;
@@ -915,7 +1077,7 @@ namespace MWSound
         {
             if (volume == 0.0f)
             {
-                mOutput->finishSound(mNearWaterSound);
+                finishSound(mNearWaterSound);
                 mNearWaterSound = nullptr;
             }
             else
@@ -941,7 +1103,7 @@ namespace MWSound
 
                 if(soundIdChanged)
                 {
-                    mOutput->finishSound(mNearWaterSound);
+                    finishSound(mNearWaterSound);
                     mNearWaterSound = playSound(soundId, volume, 1.0f, Type::Sfx, PlayMode::Loop);
                 }
                 else if (sfx)
@@ -974,7 +1136,7 @@ namespace MWSound
             env = Env_Underwater;
         else if(mUnderwaterSound)
         {
-            mOutput->finishSound(mUnderwaterSound);
+            finishSound(mUnderwaterSound);
             mUnderwaterSound = nullptr;
         }
 
@@ -1009,13 +1171,13 @@ namespace MWSound
                     if(sound->getDistanceCull())
                     {
                         if((mListenerPos - objpos).length2() > 2000*2000)
-                            mOutput->finishSound(sound);
+                            finishSound(sound);
                     }
                 }
 
-                if(!mOutput->isSoundPlaying(sound))
+                if(!isSoundPlaying(sound))
                 {
-                    mOutput->finishSound(sound);
+                    finishSound(sound);
                     mUnusedSounds.push_back(sound);
                     if(sound == mUnderwaterSound)
                         mUnderwaterSound = nullptr;
@@ -1122,6 +1284,8 @@ namespace MWSound
         if(!mOutput->isInitialized())
             return;
 
+        updateLoading();
+
         if (MWBase::Environment::get().getStateManager()->getState()!=
             MWBase::StateManager::State_NoGame)
         {
@@ -1196,6 +1360,88 @@ namespace MWSound
             mActiveSaySounds.erase(sayiter);
             mActiveSaySounds.emplace(updated, stream);
         }
+        PendingVoiceMap::iterator voiceiter = mPendingSaySounds.find(old);
+        if(voiceiter != mPendingSaySounds.end())
+        {
+            PendingVoice voice = voiceiter->second;
+            mPendingSaySounds.erase(voiceiter);
+            mPendingSaySounds.emplace(updated, voice);
+        }
+    }
+
+    void SoundManager::addCreatureSounds(const std::string &creatureId, std::vector<Sound_Buffer*> &buffers)
+    {
+        if(mCreatureSounds.empty())
+        {
+            // Sound generators without a creature are used by the creatures that have none of their own
+            MWBase::World *world = MWBase::Environment::get().getWorld();
+            for(const ESM::SoundGenerator &soundGen : world->getStore().get<ESM::SoundGenerator>())
+                mCreatureSounds[Misc::StringUtils::lowerCase(soundGen.mCreature)].push_back(
+                    Misc::StringUtils::lowerCase(soundGen.mSound));
+        }
+
+        CreatureSoundMap::const_iterator found = mCreatureSounds.find(creatureId);
+        if(found == mCreatureSounds.end())
+            found = mCreatureSounds.find(std::string());
+        if(found == mCreatureSounds.end())
+            return;
+
+        for(const std::string &soundId : found->second)
+        {
+            if(Sound_Buffer *sfx = findSound(soundId))
+                buffers.push_back(sfx);
+        }
+    }
+
+    void SoundManager::preloadSounds(const MWWorld::CellStore *cell)
+    {
+        if(!mOutput->isInitialized())
+            return;
+
+        std::vector<Sound_Buffer*> buffers;
+
+        const ESM::Cell *esmCell = cell->getCell();
+        if(esmCell->isExterior())
+        {
+            MWBase::World *world = MWBase::Environment::get().getWorld();
+            const ESM::Region *region = world->getStore().get<ESM::Region>().search(esmCell->mRegion);
+            if(region)
+            {
+                for(const ESM::Region::SoundRef &sndref : region->mSoundList)
+                {
+                    if(Sound_Buffer *sfx = findSound(Misc::StringUtils::lowerCase(sndref.mSound.toString())))
+                        buffers.push_back(sfx);
+                }
+            }
+        }
+
+        std::set<std::string> creatureIds;
+        for(const MWWorld::LiveCellRef<ESM::Creature> &ref : cell->getReadOnlyCreatures().mList)
+        {
+            const ESM::Creature *creature = ref.mBase;
+            creatureIds.insert(Misc::StringUtils::lowerCase(creature->mOriginal.empty() ? creature->mId : creature->mOriginal));
+        }
+        for(const std::string &creatureId : creatureIds)
+            addCreatureSounds(creatureId, buffers);
+
+        for(Sound_Buffer *sfx : buffers)
+            startLoading(sfx);
+    }
+
+    void SoundManager::reportStats(unsigned int frameNumber, osg::Stats& stats)
+    {
+        if(stats.collectStats("resource"))
+        {
+            stats.setAttribute(frameNumber, "Sound Cache Hit", mNumCacheHits);
+            stats.setAttribute(frameNumber, "Sound Cache Miss", mNumCacheMisses);
+            stats.setAttribute(frameNumber, "Sound Decoded", mNumDecoded);
+            stats.setAttribute(frameNumber, "Sound Decode ms", mDecodeTime);
+        }
+
+        mNumCacheHits = 0;
+        mNumCacheMisses = 0;
+        mNumDecoded = 0;
+        mDecodeTime = 0.0;
     }
 
     // Default readAll implementation, for decoders that can't do anything
@@ -1271,7 +1517,7 @@ namespace MWSound
         {
             for(SoundBufferRefPair &sndbuf : snd.second)
             {
-                mOutput->finishSound(sndbuf.first);
+                finishSound(sndbuf.first);
                 mUnusedSounds.push_back(sndbuf.first);
                 Sound_Buffer *sfx = sndbuf.second;
                 if(sfx->mUses-- == 1)
@@ -1279,6 +1525,7 @@ namespace MWSound
             }
         }
         mActiveSounds.clear();
+        mPendingSounds.clear();
         mUnderwaterSound = nullptr;
         mNearWaterSound = nullptr;
 
@@ -1288,6 +1535,7 @@ namespace MWSound
             mUnusedStreams.push_back(snd.second);
         }
         mActiveSaySounds.clear();
+        mPendingSaySounds.clear();
 
         for(Stream *sound : mActiveTracks)
         {
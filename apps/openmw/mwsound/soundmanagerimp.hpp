@@ -8,6 +8,8 @@
 #include <map>
 #include <unordered_map>
 
+#include <osg/ref_ptr>
+
 #include <components/settings/settings.hpp>
 
 #include <components/fallback/fallback.hpp>
@@ -24,13 +26,20 @@ namespace ESM
     struct Sound;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace MWSound
 {
     class Sound_Output;
     struct Sound_Decoder;
+    struct DecodedSound;
     class Sound;
     class Stream;
     class Sound_Buffer;
+    class LoadAudioItem;
 
     enum Environment {
         Env_Normal,
@@ -96,6 +105,38 @@ namespace MWSound
         typedef std::map<MWWorld::ConstPtr,Stream*> SaySoundMap;
         SaySoundMap mActiveSaySounds;
 
+        // Sound files are decoded in the background, and the sounds waiting for them are started once they're ready
+        osg::ref_ptr<SceneUtil::WorkQueue> mLoadQueue;
+
+        typedef std::unordered_map<Sound_Buffer*,osg::ref_ptr<LoadAudioItem> > LoadingBufferMap;
+        LoadingBufferMap mLoadingBuffers;
+
+        struct PendingSound
+        {
+            Sound *mSound;
+            Sound_Buffer *mBuffer;
+            float mOffset;
+        };
+        typedef std::vector<PendingSound> PendingSoundList;
+        PendingSoundList mPendingSounds;
+
+        struct PendingVoice
+        {
+            osg::ref_ptr<LoadAudioItem> mItem;
+            bool mPlayLocal;
+        };
+        typedef std::map<MWWorld::ConstPtr,PendingVoice> PendingVoiceMap;
+        PendingVoiceMap mPendingSaySounds;
+
+        // Creature IDs and the sounds their sound generators may play, built on first use
+        typedef std::unordered_map<std::string,std::vector<std::string> > CreatureSoundMap;
+        CreatureSoundMap mCreatureSounds;
+
+        size_t mNumCacheHits;
+        size_t mNumCacheMisses;
+        size_t mNumDecoded;
+        double mDecodeTime;
+
         typedef std::vector<Stream*> TrackList;
         TrackList mActiveTracks;
 
@@ -114,17 +155,33 @@ namespace MWSound
 
         Sound_Buffer *insertSound(const std::string &soundId, const ESM::Sound *sound);
 
+        // returns the sound data even if it isn't loaded yet
         Sound_Buffer *lookupSound(const std::string &soundId) const;
-        Sound_Buffer *loadSound(const std::string &soundId);
+        // returns the sound data, adding it for sounds seen the first time, or nullptr if the sound was not found
+        Sound_Buffer *findSound(const std::string &soundId);
 
-        // returns a decoder to start streaming, or nullptr if the sound was not found
-        DecoderPtr loadVoice(const std::string &voicefile);
+        // starts decoding the sound file in the background, unless it is already loaded or loading
+        void startLoading(Sound_Buffer *sfx);
+        // creates the output buffer from the decoded sound, freeing unused buffers over the cache limit
+        void fillBuffer(Sound_Buffer *sfx, const DecodedSound &decoded);
+        // starts the sounds and voices whose files finished decoding
+        void updateLoading();
+
+        // opens the voice file in the background, to start streaming when it's ready
+        osg::ref_ptr<LoadAudioItem> loadVoice(const std::string &voicefile);
 
         Sound *getSoundRef();
         Stream *getStreamRef();
 
         Stream *playVoice(DecoderPtr decoder, const osg::Vec3f &pos, bool playlocal);
 
+        // plays the sound right away if its buffer is loaded, or once it is
+        bool playBuffer(Sound *sound, Sound_Buffer *sfx, float offset);
+        void finishSound(Sound *sound);
+        bool isSoundPlaying(Sound *sound) const;
+
+        void addCreatureSounds(const std::string &creatureId, std::vector<Sound_Buffer*> &buffers);
+
         void streamMusicFull(const std::string& filename);
         void advanceMusic(const std::string& filename);
         void startRandomTitle();
@@ -251,6 +308,11 @@ namespace MWSound
         virtual void updatePtr (const MWWorld::ConstPtr& old, const MWWorld::ConstPtr& updated);
 
         virtual void clear();
+
+        virtual void preloadSounds(const MWWorld::CellStore *cell);
+        ///< Start decoding the region and creature sounds that may be played in the given cell.
+
+        virtual void reportStats(unsigned int frameNumber, osg::Stats& stats);
     };
 }
 
@@ -37,10 +37,17 @@ void MWState::Character::addSlot (const boost::filesystem::path& path, const std
     mSlots.push_back (slot);
 }
 
-void MWState::Character::addSlot (const ESM::SavedGame& profile)
+std::list<MWState::Slot>::iterator MWState::Character::findSlot (const Slot *slot)
 {
-    Slot slot;
+    for (std::list<Slot>::iterator iter = mSlots.begin(); iter != mSlots.end(); ++iter)
+        if (&*iter == slot)
+            return iter;
+
+    throw std::logic_error ("slot not found");
+}
 
+boost::filesystem::path MWState::Character::getNewSlotPath (const ESM::SavedGame& profile) const
+{
     std::ostringstream stream;
 
     // The profile description is user-supplied, so we need to escape the path
@@ -53,20 +60,17 @@ void MWState::Character::addSlot (const ESM::SavedGame& profile)
     }
 
     const std::string ext = ".omwsave";
-    slot.mPath = mPath / (stream.str() + ext);
+    boost::filesystem::path path = mPath / (stream.str() + ext);
 
     // Append an index if necessary to ensure a unique file
     int i=0;
-    while (boost::filesystem::exists(slot.mPath))
+    while (boost::filesystem::exists(path))
     {
         const std::string test = stream.str() + " - " + std::to_string(++i);
-        slot.mPath = mPath / (test + ext);
+        path = mPath / (test + ext);
     }
 
-    slot.mProfile = profile;
-    slot.mTimeStamp = std::time (0);
-
-    mSlots.push_back (slot);
+    return path;
 }
 
 MWState::Character::Character (const boost::filesystem::path& saves, const std::string& game)
@@ -83,6 +87,10 @@ MWState::Character::Character (const boost::filesystem::path& saves, const std::
         {
             boost::filesystem::path slotPath = *iter;
 
+            // Skip the leftovers of saves that were interrupted while they were written
+            if (slotPath.extension() == ".tmp")
+                continue;
+
             try
             {
                 addSlot (slotPath, game);
@@ -90,7 +98,7 @@ MWState::Character::Character (const boost::filesystem::path& saves, const std::
             catch (...) {} // ignoring bad saved game files for now
         }
 
-        std::sort (mSlots.begin(), mSlots.end());
+        mSlots.sort();
     }
 }
 
@@ -109,47 +117,38 @@ void MWState::Character::cleanup()
     }
 }
 
-const MWState::Slot *MWState::Character::createSlot (const ESM::SavedGame& profile)
+const MWState::Slot *MWState::Character::createSlot (const ESM::SavedGame& profile, const boost::filesystem::path& path)
 {
-    addSlot (profile);
+    Slot slot;
+    slot.mPath = path;
+    slot.mProfile = profile;
+    slot.mTimeStamp = std::time (0);
+
+    mSlots.push_back (slot);
 
     return &mSlots.back();
 }
 
 void MWState::Character::deleteSlot (const Slot *slot)
 {
-    int index = slot - &mSlots[0];
-
-    if (index<0 || index>=static_cast<int> (mSlots.size()))
-    {
-        // sanity check; not entirely reliable
-        throw std::logic_error ("slot not found");
-    }
+    std::list<Slot>::iterator iter = findSlot (slot);
 
     boost::filesystem::remove(slot->mPath);
 
-    mSlots.erase (mSlots.begin()+index);
+    mSlots.erase (iter);
 }
 
 const MWState::Slot *MWState::Character::updateSlot (const Slot *slot, const ESM::SavedGame& profile)
 {
-    int index = slot - &mSlots[0];
+    std::list<Slot>::iterator iter = findSlot (slot);
 
-    if (index<0 || index>=static_cast<int> (mSlots.size()))
-    {
-        // sanity check; not entirely reliable
-        throw std::logic_error ("slot not found");
-    }
-
-    Slot newSlot = *slot;
-    newSlot.mProfile = profile;
-    newSlot.mTimeStamp = std::time (0);
+    iter->mProfile = profile;
+    iter->mTimeStamp = std::time (0);
 
-    mSlots.erase (mSlots.begin()+index);
+    // The most recent slot goes last
+    mSlots.splice (mSlots.end(), mSlots, iter);
 
-    mSlots.push_back (newSlot);
-
-    return &mSlots.back();
+    return &*iter;
 }
 
 MWState::Character::SlotIterator MWState::Character::begin() const
@@ -167,7 +166,7 @@ ESM::SavedGame MWState::Character::getSignature() const
     if (mSlots.empty())
         throw std::logic_error ("character signature not available");
 
-    std::vector<Slot>::const_iterator iter (mSlots.begin());
+    std::list<Slot>::const_iterator iter (mSlots.begin());
 
     Slot slot = *iter;
 
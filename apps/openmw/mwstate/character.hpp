@@ -1,6 +1,8 @@
 #ifndef GAME_STATE_CHARACTER_H
 #define GAME_STATE_CHARACTER_H
 
+#include <list>
+
 #include <boost/filesystem/path.hpp>
 
 #include <components/esm/savedgame.hpp>
@@ -20,16 +22,17 @@ namespace MWState
     {
         public:
 
-            typedef std::vector<Slot>::const_reverse_iterator SlotIterator;
+            typedef std::list<Slot>::const_reverse_iterator SlotIterator;
 
         private:
 
             boost::filesystem::path mPath;
-            std::vector<Slot> mSlots;
+            // A list keeps the slots where they are when other slots are added, updated or deleted
+            std::list<Slot> mSlots;
 
             void addSlot (const boost::filesystem::path& path, const std::string& game);
 
-            void addSlot (const ESM::SavedGame& profile);
+            std::list<Slot>::iterator findSlot (const Slot *slot);
 
         public:
 
@@ -38,8 +41,11 @@ namespace MWState
             void cleanup();
             ///< Delete the directory we used, if it is empty
 
-            const Slot *createSlot (const ESM::SavedGame& profile);
-            ///< Create new slot.
+            boost::filesystem::path getNewSlotPath (const ESM::SavedGame& profile) const;
+            ///< Return a path for a new slot, that isn't used by any existing file.
+
+            const Slot *createSlot (const ESM::SavedGame& profile, const boost::filesystem::path& path);
+            ///< Create new slot for the saved game written to \a path.
             ///
             /// \attention The ownership of the slot is not transferred.
 
@@ -50,11 +56,9 @@ namespace MWState
 
             const Slot *updateSlot (const Slot *slot, const ESM::SavedGame& profile);
             /// \note Slot must belong to this character.
-            ///
-            /// \attention The \a slot pointer will be invalidated by this call.
 
             SlotIterator begin() const;
-            ///<  Any call to createSlot and updateSlot can invalidate the returned iterator.
+            ///<  Any call to createSlot and updateSlot can change the order of the slots.
 
             SlotIterator end() const;
 
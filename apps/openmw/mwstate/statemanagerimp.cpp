@@ -1,5 +1,16 @@
 #include "statemanagerimp.hpp"
 
+#include <cstdio>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 #include <components/debug/debuglog.hpp>
 
 #include <components/esm/esmwriter.hpp>
@@ -11,11 +22,13 @@
 
 #include <components/settings/settings.hpp>
 
+#include <components/sceneutil/workqueue.hpp>
+
 #include <osg/Image>
+#include <osg/Timer>
 
 #include <osgDB/Registry>
 
-#include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/operations.hpp>
 
 #include "../mwbase/environment.hpp"
@@ -40,6 +53,217 @@
 
 #include "quicksavemanager.hpp"
 
+namespace
+{
+    /// Output buffer over a string that can be taken without copying it, with the seeking ESM::ESMWriter needs.
+    class StringWriteBuffer : public std::streambuf
+    {
+        public:
+
+            StringWriteBuffer() : mPosition (0) {}
+
+            /// Take the data written so far, further writes start a new string.
+            std::string release()
+            {
+                mPosition = 0;
+                std::string data;
+                data.swap (mData);
+                return data;
+            }
+
+        protected:
+
+            virtual std::streamsize xsputn (const char* data, std::streamsize count)
+            {
+                const std::size_t size = static_cast<std::size_t> (count);
+                mData.replace (mPosition, size, data, size);
+                mPosition += size;
+                return count;
+            }
+
+            virtual int_type overflow (int_type ch)
+            {
+                if (traits_type::eq_int_type (ch, traits_type::eof()))
+                    return traits_type::not_eof (ch);
+                const char data = traits_type::to_char_type (ch);
+                xsputn (&data, 1);
+                return ch;
+            }
+
+            virtual pos_type seekoff (off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode which)
+            {
+                if (dir == std::ios_base::cur)
+                    offset += static_cast<off_type> (mPosition);
+                else if (dir == std::ios_base::end)
+                    offset += static_cast<off_type> (mData.size());
+                return seekpos (pos_type (offset), which);
+            }
+
+            virtual pos_type seekpos (pos_type position, std::ios_base::openmode which)
+            {
+                const off_type offset = position;
+                if (!(which & std::ios_base::out) || offset < 0 || offset > static_cast<off_type> (mData.size()))
+                    return pos_type (off_type (-1));
+                mPosition = static_cast<std::size_t> (offset);
+                return position;
+            }
+
+        private:
+
+            std::string mData;
+            std::size_t mPosition;
+    };
+
+    void setUpSavedGameWriter (ESM::ESMWriter& writer, const std::vector<std::string>& contentFiles, int recordCount)
+    {
+        for (std::vector<std::string>::const_iterator iter (contentFiles.begin()); iter!=contentFiles.end();
+            ++iter)
+            writer.addMaster (*iter, 0); // not using the size information anyway -> use value of 0
+
+        writer.setFormat (ESM::SavedGame::sCurrentFormat);
+
+        // all unused
+        writer.setVersion(0);
+        writer.setType(0);
+        writer.setAuthor("");
+        writer.setDescription("");
+
+        writer.setRecordCount (recordCount);
+    }
+
+    void encodeScreenshot (const osg::Image& screenshot, std::vector<char>& imageData)
+    {
+        osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("jpg");
+        if (!readerwriter)
+        {
+            Log(Debug::Error) << "Error: Unable to write screenshot, can't find a jpg ReaderWriter";
+            return;
+        }
+
+        std::ostringstream ostream;
+        osgDB::ReaderWriter::WriteResult result = readerwriter->writeImage(screenshot, ostream);
+        if (!result.success())
+        {
+            Log(Debug::Error) << "Error: Unable to write screenshot: " << result.message() << " code " << result.status();
+            return;
+        }
+
+        std::string data = ostream.str();
+        imageData = std::vector<char>(data.begin(), data.end());
+    }
+
+    /// Write \a header followed by \a records to a new file at \a path, and make sure it has reached the disk.
+    void writeFileSynced (const boost::filesystem::path& path, const std::string& header, const std::string& records)
+    {
+#ifdef _WIN32
+        std::FILE* file = _wfopen (path.wstring().c_str(), L"wb");
+#else
+        std::FILE* file = std::fopen (path.string().c_str(), "wb");
+#endif
+        if (!file)
+            throw std::runtime_error ("Failed to open " + path.string());
+
+        bool failed = std::fwrite (header.data(), 1, header.size(), file) != header.size()
+            || std::fwrite (records.data(), 1, records.size(), file) != records.size() || std::fflush (file) != 0;
+#ifdef _WIN32
+        failed = failed || _commit (_fileno (file)) != 0;
+#else
+        failed = failed || fsync (fileno (file)) != 0;
+#endif
+        failed = std::fclose (file) != 0 || failed;
+
+        if (failed)
+            throw std::runtime_error ("Write operation failed (file stream)");
+    }
+}
+
+namespace MWState
+{
+    /// Completes a saved game with the file header and the saved game record, which holds the encoded
+    /// screenshot, and writes it to a temporary file. The file is moved over the slot's file once it is
+    /// completely on the disk, so that a failed write never trashes the save it was going to replace.
+    class WriteSaveItem : public SceneUtil::WorkItem
+    {
+        public:
+
+            /// \param records Serialized records following the saved game record
+            /// \param recordCount Number of records, including the saved game record
+            WriteSaveItem (std::string records, int recordCount, osg::ref_ptr<osg::Image> screenshot,
+                           const boost::filesystem::path& path, Character* character, const Slot* slot,
+                           const ESM::SavedGame& profile)
+            : mRecords (std::move (records)), mRecordCount (recordCount), mScreenshot (screenshot), mPath (path)
+            , mCharacter (character), mSlot (slot), mProfile (profile), mWriteTime (0)
+            {}
+
+            virtual void doWork()
+            {
+                const osg::Timer_t start = osg::Timer::instance()->tick();
+                const boost::filesystem::path tempPath = mPath.string() + ".tmp";
+
+                try
+                {
+                    if (mScreenshot)
+                        encodeScreenshot (*mScreenshot, mProfile.mScreenshot);
+                    mScreenshot = nullptr;
+
+                    StringWriteBuffer buffer;
+                    std::ostream stream (&buffer);
+
+                    ESM::ESMWriter writer;
+                    setUpSavedGameWriter (writer, mProfile.mContentFiles, mRecordCount);
+                    writer.save (stream);
+
+                    writer.startRecord (ESM::REC_SAVE);
+                    mProfile.save (writer);
+                    writer.endRecord (ESM::REC_SAVE);
+
+                    writer.close();
+
+                    if (stream.fail())
+                        throw std::runtime_error("Write operation failed (memory stream)");
+
+                    writeFileSynced (tempPath, buffer.release(), mRecords);
+                    boost::filesystem::rename (tempPath, mPath);
+                }
+                catch (const std::exception& e)
+                {
+                    mError = e.what();
+                    boost::system::error_code ec;
+                    boost::filesystem::remove (tempPath, ec);
+                }
+
+                std::string().swap (mRecords);
+                mWriteTime = osg::Timer::instance()->delta_m (start, osg::Timer::instance()->tick());
+            }
+
+            const boost::filesystem::path& getPath() const { return mPath; }
+
+            Character* getCharacter() const { return mCharacter; }
+
+            /// \return Slot to update, or nullptr to create a new one.
+            const Slot* getSlot() const { return mSlot; }
+
+            const ESM::SavedGame& getProfile() const { return mProfile; }
+
+            /// \return Empty if the saved game was written.
+            const std::string& getError() const { return mError; }
+
+            double getWriteTime() const { return mWriteTime; }
+
+        private:
+
+            std::string mRecords;
+            int mRecordCount;
+            osg::ref_ptr<osg::Image> mScreenshot;
+            boost::filesystem::path mPath;
+            Character* mCharacter;
+            const Slot* mSlot;
+            ESM::SavedGame mProfile;
+            std::string mError;
+            double mWriteTime;
+    };
+}
+
 void MWState::StateManager::cleanup (bool force)
 {
     if (mState!=State_NoGame || force)
@@ -86,12 +310,58 @@ std::map<int, int> MWState::StateManager::buildContentFileIndexMap (const ESM::E
     return map;
 }
 
+void MWState::StateManager::finishSaving (bool wait)
+{
+    if (!mPendingSave || (!wait && !mPendingSave->isDone()))
+        return;
+
+    mPendingSave->waitTillDone();
+    osg::ref_ptr<WriteSaveItem> save = mPendingSave;
+    mPendingSave = nullptr;
+
+    Character* character = save->getCharacter();
+
+    if (!save->getError().empty())
+    {
+        std::stringstream error;
+        error << "Failed to save game: " << save->getError();
+
+        Log(Debug::Error) << error.str();
+
+        std::vector<std::string> buttons;
+        buttons.push_back("#{sOk}");
+        MWBase::Environment::get().getWindowManager()->interactiveMessageBox(error.str(), buttons);
+
+        // Remove the directory of a character that has no saves yet
+        character->cleanup();
+        return;
+    }
+
+    if (save->getSlot())
+        character->updateSlot (save->getSlot(), save->getProfile());
+    else
+        character->createSlot (save->getProfile(), save->getPath());
+
+    Settings::Manager::setString ("character", "Saves",
+        save->getPath().parent_path().filename().string());
+
+    Log(Debug::Verbose) << "Wrote " << save->getPath().string() << " in " << save->getWriteTime() << " ms";
+}
+
 MWState::StateManager::StateManager (const boost::filesystem::path& saves, const std::string& game)
 : mQuitRequest (false), mAskLoadRecent(false), mState (State_NoGame), mCharacterManager (saves, game), mTimePlayed (0)
+, mSaveQueue (new SceneUtil::WorkQueue(1))
 {
 
 }
 
+MWState::StateManager::~StateManager()
+{
+    // Don't let the work queue drop a saved game that has not been written yet
+    if (mPendingSave)
+        mPendingSave->waitTillDone();
+}
+
 void MWState::StateManager::requestQuit()
 {
     mQuitRequest = true;
@@ -181,6 +451,9 @@ void MWState::StateManager::resumeGame()
 
 void MWState::StateManager::saveGame (const std::string& description, const Slot *slot)
 {
+    // The previous save has to claim its slot first
+    finishSaving(true);
+
     MWState::Character* character = getCurrentCharacter();
 
     try
@@ -220,37 +493,18 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         profile.mTimePlayed = mTimePlayed;
         profile.mDescription = description;
 
-        writeScreenshot(profile.mScreenshot);
-
-        if (!slot)
-            slot = character->createSlot (profile);
-        else
-            slot = character->updateSlot (slot, profile);
+        // Only the rendering has to happen now, the image is encoded while the file is written
+        const osg::ref_ptr<osg::Image> screenshot = takeScreenshot();
 
         // Make sure the animation state held by references is up to date before saving the game.
         MWBase::Environment::get().getMechanicsManager()->persistAnimationStates();
 
-        // Write to a memory stream first. If there is an exception during the save process, we don't want to trash the
-        // existing save file we are overwriting.
-        std::stringstream stream;
+        // Write to memory first, so that the world can keep changing while the file is written.
+        StringWriteBuffer buffer;
+        std::ostream stream (&buffer);
 
         ESM::ESMWriter writer;
 
-        const std::vector<std::string>& current =
-            MWBase::Environment::get().getWorld()->getContentFiles();
-
-        for (std::vector<std::string>::const_iterator iter (current.begin()); iter!=current.end();
-            ++iter)
-            writer.addMaster (*iter, 0); // not using the size information anyway -> use value of 0
-
-        writer.setFormat (ESM::SavedGame::sCurrentFormat);
-
-        // all unused
-        writer.setVersion(0);
-        writer.setType(0);
-        writer.setAuthor("");
-        writer.setDescription("");
-
         int recordCount =         1 // saved game header
                 +MWBase::Environment::get().getJournal()->countSavedGameRecords()
                 +MWBase::Environment::get().getWorld()->countSavedGameRecords()
@@ -259,9 +513,11 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
                 +MWBase::Environment::get().getWindowManager()->countSavedGameRecords()
                 +MWBase::Environment::get().getMechanicsManager()->countSavedGameRecords()
                 +MWBase::Environment::get().getInputManager()->countSavedGameRecords();
-        writer.setRecordCount (recordCount);
+        setUpSavedGameWriter (writer, profile.mContentFiles, recordCount);
 
+        // The header and the saved game record are written by WriteSaveItem, the writer only needs its state
         writer.save (stream);
+        buffer.release();
 
         Loading::Listener& listener = *MWBase::Environment::get().getWindowManager()->getLoadingScreen();
         int messagesCount = MWBase::Environment::get().getWindowManager()->getMessagesCount();
@@ -271,10 +527,6 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
 
         Loading::ScopedLoad load(&listener);
 
-        writer.startRecord (ESM::REC_SAVE);
-        slot->mProfile.save (writer);
-        writer.endRecord (ESM::REC_SAVE);
-
         MWBase::Environment::get().getJournal()->write (writer, listener);
         MWBase::Environment::get().getDialogueManager()->write (writer, listener);
         MWBase::Environment::get().getWorld()->write (writer, listener);
@@ -284,23 +536,21 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         MWBase::Environment::get().getInputManager()->write(writer, listener);
 
         // Ensure we have written the number of records that was estimated
-        if (writer.getRecordCount() != recordCount+1) // 1 extra for TES3 record
-            Log(Debug::Warning) << "Warning: number of written savegame records does not match. Estimated: " << recordCount+1 << ", written: " << writer.getRecordCount();
+        if (writer.getRecordCount() != recordCount) // 1 extra for TES3 record, 1 missing for the saved game record
+            Log(Debug::Warning) << "Warning: number of written savegame records does not match. Estimated: " << recordCount+1 << ", written: " << writer.getRecordCount()+1;
 
         writer.close();
 
         if (stream.fail())
             throw std::runtime_error("Write operation failed (memory stream)");
 
-        // All good, write to file
-        boost::filesystem::ofstream filestream (slot->mPath, std::ios::binary);
-        filestream << stream.rdbuf();
-
-        if (filestream.fail())
-            throw std::runtime_error("Write operation failed (file stream)");
+        // All good, write to file. The slot is created or updated once the file is complete.
+        const boost::filesystem::path path = slot ? slot->mPath : character->getNewSlotPath (profile);
+        mPendingSave = new WriteSaveItem (buffer.release(), recordCount, screenshot, path, character, slot, profile);
+        mSaveQueue->addWorkItem (mPendingSave);
 
-        Settings::Manager::setString ("character", "Saves",
-            slot->mPath.parent_path().filename().string());
+        if (!Settings::Manager::getBool ("background writing", "Saves"))
+            finishSaving(true);
     }
     catch (const std::exception& e)
     {
@@ -313,15 +563,17 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
         buttons.push_back("#{sOk}");
         MWBase::Environment::get().getWindowManager()->interactiveMessageBox(error.str(), buttons);
 
-        // If no file was written, clean up the slot
-        if (character && slot && !boost::filesystem::exists(slot->mPath))
-        {
-            character->deleteSlot(slot);
+        // Remove the directory of a character that has no saves yet
+        if (character)
             character->cleanup();
-        }
     }
 }
 
+void MWState::StateManager::waitForSaving()
+{
+    finishSaving(true);
+}
+
 void MWState::StateManager::quickSave (std::string name)
 {
     if (!(mState==State_Running &&
@@ -333,6 +585,9 @@ void MWState::StateManager::quickSave (std::string name)
         return;
     }
 
+    // The slot of a quicksave that is still being written has to be taken into account
+    finishSaving(true);
+
     int maxSaves = Settings::Manager::getInt("max quicksaves", "Saves");
     if(maxSaves < 1)
         maxSaves = 1;
@@ -356,6 +611,8 @@ void MWState::StateManager::quickSave (std::string name)
 
 void MWState::StateManager::loadGame(const std::string& filepath)
 {
+    finishSaving(true);
+
     for (CharacterIterator it = mCharacterManager.begin(); it != mCharacterManager.end(); ++it)
     {
         const MWState::Character& character = *it;
@@ -376,6 +633,8 @@ void MWState::StateManager::loadGame(const std::string& filepath)
 
 void MWState::StateManager::loadGame (const Character *character, const std::string& filepath)
 {
+    finishSaving(true);
+
     try
     {
         cleanup();
@@ -575,6 +834,8 @@ void MWState::StateManager::quickLoad()
 
 void MWState::StateManager::deleteGame(const MWState::Character *character, const MWState::Slot *slot)
 {
+    finishSaving(true);
+
     mCharacterManager.deleteSlot(character, slot);
 }
 
@@ -597,6 +858,8 @@ void MWState::StateManager::update (float duration)
 {
     mTimePlayed += duration;
 
+    finishSaving(false);
+
     // Note: It would be nicer to trigger this from InputManager, i.e. the very beginning of the frame update.
     if (mAskLoadRecent)
     {
@@ -645,7 +908,7 @@ bool MWState::StateManager::verifyProfile(const ESM::SavedGame& profile) const
     return true;
 }
 
-void MWState::StateManager::writeScreenshot(std::vector<char> &imageData) const
+osg::ref_ptr<osg::Image> MWState::StateManager::takeScreenshot() const
 {
     int screenshotW = 259*2, screenshotH = 133*2; // *2 to get some nice antialiasing
 
@@ -653,22 +916,5 @@ void MWState::StateManager::writeScreenshot(std::vector<char> &imageData) const
 
     MWBase::Environment::get().getWorld()->screenshot(screenshot.get(), screenshotW, screenshotH);
 
-    osgDB::ReaderWriter* readerwriter = osgDB::Registry::instance()->getReaderWriterForExtension("jpg");
-    if (!readerwriter)
-    {
-        Log(Debug::Error) << "Error: Unable to write screenshot, can't find a jpg ReaderWriter";
-        return;
-    }
-
-    std::ostringstream ostream;
-    osgDB::ReaderWriter::WriteResult result = readerwriter->writeImage(*screenshot, ostream);
-    if (!result.success())
-    {
-        Log(Debug::Error) << "Error: Unable to write screenshot: " << result.message() << " code " << result.status();
-        return;
-    }
-
-    std::string data = ostream.str();
-    imageData = std::vector<char>(data.begin(), data.end());
-
+    return screenshot;
 }
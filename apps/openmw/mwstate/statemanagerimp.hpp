@@ -7,10 +7,24 @@
 
 #include <boost/filesystem/path.hpp>
 
+#include <osg/ref_ptr>
+
 #include "charactermanager.hpp"
 
+namespace osg
+{
+    class Image;
+}
+
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace MWState
 {
+    class WriteSaveItem;
+
     class StateManager : public MWBase::StateManager
     {
             bool mQuitRequest;
@@ -18,14 +32,20 @@ namespace MWState
             State mState;
             CharacterManager mCharacterManager;
             double mTimePlayed;
+            osg::ref_ptr<SceneUtil::WorkQueue> mSaveQueue;
+            osg::ref_ptr<WriteSaveItem> mPendingSave;
 
         private:
 
             void cleanup (bool force = false);
 
+            void finishSaving (bool wait);
+            ///< Publish the slot of the saved game that is being written, once it is on the disk.
+            /// \param wait Wait for the write to complete, otherwise only check if it has.
+
             bool verifyProfile (const ESM::SavedGame& profile) const;
 
-            void writeScreenshot (std::vector<char>& imageData) const;
+            osg::ref_ptr<osg::Image> takeScreenshot() const;
 
             std::map<int, int> buildContentFileIndexMap (const ESM::ESMReader& reader) const;
 
@@ -33,6 +53,8 @@ namespace MWState
 
             StateManager (const boost::filesystem::path& saves, const std::string& game);
 
+            virtual ~StateManager();
+
             virtual void requestQuit();
 
             virtual bool hasQuitRequest() const;
@@ -57,6 +79,12 @@ namespace MWState
             ///< Write a saved game to \a slot or create a new slot if \a slot == 0.
             ///
             /// \note Slot must belong to the current character.
+            ///
+            /// \note With [Saves] background writing, the file is written after this call returns,
+            /// and the slot is created or updated once the write is complete.
+
+            virtual void waitForSaving();
+            ///< Wait until a saved game that is being written is on the disk, and publish its slot.
 
             ///Saves a file, using supplied filename, overwritting if needed
             /** This is mostly used for quicksaving and autosaving, for they use the same name over and over again
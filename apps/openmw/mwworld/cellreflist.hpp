@@ -1,7 +1,7 @@
 #ifndef GAME_MWWORLD_CELLREFLIST_H
 #define GAME_MWWORLD_CELLREFLIST_H
 
-#include <list>
+#include <components/misc/chunkedvector.hpp>
 
 #include "livecellref.hpp"
 
@@ -12,7 +12,8 @@ namespace MWWorld
     struct CellRefList
     {
         typedef LiveCellRef<X> LiveRef;
-        typedef std::list<LiveRef> List;
+        /// Ptrs point into the list, so adding references must not move the existing ones
+        typedef Misc::ChunkedVector<LiveRef> List;
         List mList;
 
         /// Search for the given reference in the given reclist from
@@ -36,7 +37,7 @@ namespace MWWorld
             for (typename List::iterator it = mList.begin(); it != mList.end();)
             {
                 if (*it == refNum)
-                    mList.erase(it++);
+                    it = mList.erase(it);
                 else
                     ++it;
             }
@@ -235,6 +235,9 @@ namespace MWWorld
 
             bool movedHere(const MWWorld::Ptr& ptr) const;
 
+            bool movedToAnotherCell(const MWWorld::Ptr& ptr) const;
+            ///< Was \a ptr owned by this cell moved to another one?
+
             void setWaterLevel (float level);
 
             void setFog (ESM::FogState* fog);
@@ -351,6 +354,10 @@ namespace MWWorld
             {
                 return mStatics;
             }
+            inline const CellRefList<ESM::Creature>& getReadOnlyCreatures() const
+            {
+                return mCreatures;
+            }
 
             bool isExterior() const;
 
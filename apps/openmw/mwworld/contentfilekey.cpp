@@ -0,0 +1,67 @@
+#include "contentfilekey.hpp"
+
+#include <boost/filesystem/operations.hpp>
+
+#include <components/esm/esmreader.hpp>
+#include <components/esm/esmwriter.hpp>
+#include <components/files/collections.hpp>
+
+namespace MWWorld
+{
+    ContentFileKey::ContentFileKey(const Files::Collections& fileCollections, const std::vector<std::string>& contentFiles,
+        const std::string& engineVersion)
+        : mEngineVersion(engineVersion)
+    {
+        for (const std::string& file : contentFiles)
+        {
+            ContentFile contentFile {std::string(), 0, 0};
+            boost::filesystem::path filename(file);
+            const Files::MultiDirCollection& col = fileCollections.getCollection(filename.extension().string());
+            if (col.doesExist(file))
+            {
+                const boost::filesystem::path filePath = col.getPath(file);
+                contentFile.mPath = filePath.string();
+                contentFile.mSize = boost::filesystem::file_size(filePath);
+                contentFile.mTime = boost::filesystem::last_write_time(filePath);
+            }
+            mContentFiles.push_back(contentFile);
+        }
+    }
+
+    void ContentFileKey::save(ESM::ESMWriter& writer) const
+    {
+        writer.writeHNString("VERS", mEngineVersion);
+        writer.writeHNT("COUN", static_cast<int>(mContentFiles.size()));
+        for (const ContentFile& file : mContentFiles)
+        {
+            writer.writeHNString("FILE", file.mPath);
+            writer.writeHNT("SIZE", file.mSize);
+            writer.writeHNT("TIME", file.mTime);
+        }
+    }
+
+    bool ContentFileKey::matches(ESM::ESMReader& reader) const
+    {
+        if (reader.getHNString("VERS") != mEngineVersion)
+            return false;
+
+        int count = 0;
+        reader.getHNT(count, "COUN");
+        if (count != static_cast<int>(mContentFiles.size()))
+            return false;
+
+        for (const ContentFile& file : mContentFiles)
+        {
+            ContentFile cached {std::string(), 0, 0};
+            cached.mPath = reader.getHNString("FILE");
+            reader.getHNT(cached.mSize, "SIZE");
+            reader.getHNT(cached.mTime, "TIME");
+
+            // Files that were not found are never up to date, loading will fail for them anyway
+            if (file.mPath.empty() || cached.mPath != file.mPath || cached.mSize != file.mSize || cached.mTime != file.mTime)
+                return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef CONTENTFILEKEY_HPP
+#define CONTENTFILEKEY_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ESM
+{
+    class ESMReader;
+    class ESMWriter;
+}
+
+namespace Files
+{
+    class Collections;
+}
+
+namespace MWWorld
+{
+    /// @brief Identifies the content files in load order, with their sizes and modification times, and the
+    /// engine version.
+    /// @par Used to decide whether a cache built from the data of the content files is still up to date.
+    /// Other engine versions may generate different data from the same files, so they don't share caches.
+    class ContentFileKey
+    {
+        public:
+            ContentFileKey(const Files::Collections& fileCollections, const std::vector<std::string>& contentFiles,
+                const std::string& engineVersion = std::string());
+
+            /// Write the key as subrecords of the current record.
+            void save(ESM::ESMWriter& writer) const;
+
+            /// Read a key written by save() from the current record.
+            /// @return Does it describe the same content files as this key?
+            bool matches(ESM::ESMReader& reader) const;
+
+        private:
+            struct ContentFile
+            {
+                std::string mPath;
+                std::uint64_t mSize;
+                std::int64_t mTime;
+            };
+
+            std::string mEngineVersion;
+            std::vector<ContentFile> mContentFiles;
+    };
+}
+
+#endif
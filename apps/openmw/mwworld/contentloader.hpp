@@ -21,6 +21,11 @@ struct ContentLoader
     {
     }
 
+    /// Announce a file that load() will be called for later, so that it can be read ahead of time.
+    virtual void preload(const boost::filesystem::path& filepath, int index)
+    {
+    }
+
     virtual void load(const boost::filesystem::path& filepath, int& index)
     {
         Log(Debug::Info) << "Loading content file " << filepath.string();
@@ -3,29 +3,147 @@
 
 #include <components/esm/esmreader.hpp>
 
+namespace
+{
+    using FloatMs = std::chrono::duration<float, std::milli>;
+}
+
 namespace MWWorld
 {
 
 EsmLoader::EsmLoader(MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& readers,
-  ToUTF8::Utf8Encoder* encoder, Loading::Listener& listener)
+  ToUTF8::Utf8Encoder* encoder, Loading::Listener& listener, std::size_t numThreads)
   : ContentLoader(listener)
   , mEsm(readers)
   , mStore(store)
   , mEncoder(encoder)
+  , mShouldStop(false)
+  , mNextJob(0)
+  , mLoadedJobs(0)
 {
+    // The encoder keeps a conversion buffer, so every thread needs its own. Copy it before any thread starts,
+    // load() uses the shared one while the threads are running.
+    for (std::size_t i = 0; i < numThreads; ++i)
+        mEncoders.emplace_back(mEncoder ? new ToUTF8::Utf8Encoder(*mEncoder) : nullptr);
+    for (std::size_t i = 0; i < numThreads; ++i)
+    {
+        ToUTF8::Utf8Encoder* const threadEncoder = mEncoders[i].get();
+        mThreads.emplace_back([this, threadEncoder] { process(threadEncoder); });
+    }
+}
+
+EsmLoader::~EsmLoader()
+{
+    mShouldStop = true;
+    std::unique_lock<std::mutex> lock(mMutex);
+    mHasJob.notify_all();
+    lock.unlock();
+    for (auto& thread : mThreads)
+        thread.join();
+}
+
+void EsmLoader::preload(const boost::filesystem::path& filepath, int index)
+{
+    if (mThreads.empty())
+        return;
+
+    const std::lock_guard<std::mutex> lock(mMutex);
+    mJobs.push_back(Job {filepath, index, ESMStore::StagedRecords(), false, false, std::chrono::steady_clock::duration()});
+    mHasJob.notify_one();
 }
 
 void EsmLoader::load(const boost::filesystem::path& filepath, int& index)
 {
   ContentLoader::load(filepath.filename(), index);
 
+  const auto start = std::chrono::steady_clock::now();
+
+  // Take the records read ahead by the worker threads, if this file was preloaded
+  ESMStore::StagedRecords staged;
+  bool hasStaged = false;
+  std::chrono::steady_clock::duration stageTime {};
+  {
+      std::unique_lock<std::mutex> lock(mMutex);
+      for (auto& job : mJobs)
+      {
+          if (job.mIndex != index || job.mPath != filepath)
+              continue;
+          mJobDone.wait(lock, [&] { return job.mDone; });
+          hasStaged = !job.mFailed;
+          staged = std::move(job.mRecords);
+          stageTime = job.mTime;
+          ++mLoadedJobs;
+          mHasJob.notify_all();
+          break;
+      }
+  }
+
+  const auto merge = std::chrono::steady_clock::now();
+
   ESM::ESMReader lEsm;
   lEsm.setEncoder(mEncoder);
   lEsm.setIndex(index);
   lEsm.setGlobalReaderList(&mEsm);
   lEsm.open(filepath.string());
   mEsm[index] = lEsm;
-  mStore.load(mEsm[index], &mListener);
+  mStore.load(mEsm[index], &mListener, hasStaged ? &staged : nullptr);
+
+  const auto finish = std::chrono::steady_clock::now();
+
+  if (hasStaged)
+      Log(Debug::Info) << "Loaded content file " << filepath.filename().string() << " in "
+          << std::chrono::duration_cast<FloatMs>(finish - start).count() << " ms (waited "
+          << std::chrono::duration_cast<FloatMs>(merge - start).count() << " ms for records read in "
+          << std::chrono::duration_cast<FloatMs>(stageTime).count() << " ms by a worker thread, merged in "
+          << std::chrono::duration_cast<FloatMs>(finish - merge).count() << " ms)";
+  else
+      Log(Debug::Info) << "Loaded content file " << filepath.filename().string() << " in "
+          << std::chrono::duration_cast<FloatMs>(finish - start).count() << " ms";
+}
+
+void EsmLoader::process(ToUTF8::Utf8Encoder* encoder)
+{
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        // Don't read too far ahead of the loading thread, staged records hold a copy of every record
+        mHasJob.wait(lock, [&] {
+            return mShouldStop || (mNextJob < mJobs.size() && mNextJob < mLoadedJobs + 2 * mThreads.size());
+        });
+        if (mShouldStop)
+            return;
+        Job& job = mJobs[mNextJob++];
+        lock.unlock();
+
+        stage(job, encoder);
+
+        lock.lock();
+        job.mDone = true;
+        mJobDone.notify_all();
+    }
+}
+
+void EsmLoader::stage(Job& job, ToUTF8::Utf8Encoder* encoder) const
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    try
+    {
+        ESM::ESMReader reader;
+        reader.setEncoder(encoder);
+        reader.setIndex(job.mIndex);
+        reader.open(job.mPath.string());
+        mStore.stage(reader, job.mRecords);
+    }
+    catch (const std::exception& e)
+    {
+        // Let load() read the file on its own and report the error
+        Log(Debug::Verbose) << "Failed to read ahead content file " << job.mPath.string() << ": " << e.what();
+        job.mRecords.clear();
+        job.mFailed = true;
+    }
+
+    job.mTime = std::chrono::steady_clock::now() - start;
 }
 
 } /* namespace MWWorld */
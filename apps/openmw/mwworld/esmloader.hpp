@@ -1,9 +1,17 @@
 #ifndef ESMLOADER_HPP
 #define ESMLOADER_HPP
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "contentloader.hpp"
+#include "esmstore.hpp"
 
 namespace ToUTF8
 {
@@ -18,19 +26,46 @@ namespace ESM
 namespace MWWorld
 {
 
-class ESMStore;
-
 struct EsmLoader : public ContentLoader
 {
+    /// @param numThreads Number of worker threads reading content files ahead of load(), 0 to read everything in load().
     EsmLoader(MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& readers,
-      ToUTF8::Utf8Encoder* encoder, Loading::Listener& listener);
+      ToUTF8::Utf8Encoder* encoder, Loading::Listener& listener, std::size_t numThreads = 0);
+
+    ~EsmLoader();
+
+    void preload(const boost::filesystem::path& filepath, int index);
 
     void load(const boost::filesystem::path& filepath, int& index);
 
     private:
+      struct Job
+      {
+          boost::filesystem::path mPath;
+          int mIndex;
+          ESMStore::StagedRecords mRecords;
+          bool mDone;
+          bool mFailed;
+          std::chrono::steady_clock::duration mTime;
+      };
+
       std::vector<ESM::ESMReader>& mEsm;
       MWWorld::ESMStore& mStore;
       ToUTF8::Utf8Encoder* mEncoder;
+      std::vector<std::unique_ptr<ToUTF8::Utf8Encoder>> mEncoders;
+
+      std::atomic_bool mShouldStop;
+      std::mutex mMutex;
+      std::condition_variable mHasJob;
+      std::condition_variable mJobDone;
+      std::deque<Job> mJobs;
+      std::size_t mNextJob;
+      std::size_t mLoadedJobs;
+      std::vector<std::thread> mThreads;
+
+      void process(ToUTF8::Utf8Encoder* encoder);
+
+      void stage(Job& job, ToUTF8::Utf8Encoder* encoder) const;
 };
 
 } /* namespace MWWorld */
@@ -26,7 +26,36 @@ static bool isCacheableRecord(int id)
     return false;
 }
 
-void ESMStore::load(ESM::ESMReader &esm, Loading::Listener* listener)
+void ESMStore::stage(ESM::ESMReader &esm, StagedRecords &records) const
+{
+    while(esm.hasMoreRecs())
+    {
+        ESM::NAME n = esm.getRecName();
+        esm.getRecHeader();
+
+        std::unique_ptr<StagedRecordBase> record;
+
+        if (n.intval == ESM::REC_INFO)
+        {
+            std::unique_ptr<StagedRecord<ESM::DialInfo> > info(new StagedRecord<ESM::DialInfo>);
+            info->mRecord.load(esm, info->mIsDeleted);
+            record = std::move(info);
+        }
+        else
+        {
+            std::map<int, StoreBase *>::const_iterator it = mStores.find(n.intval);
+            if (it != mStores.end() && !(mCachedRecordsLoaded && it->second->isCacheable()))
+                record = it->second->stage(esm);
+        }
+
+        if (!record)
+            esm.skipRecord();
+
+        records.push_back(std::move(record));
+    }
+}
+
+void ESMStore::load(ESM::ESMReader &esm, Loading::Listener* listener, StagedRecords* staged)
 {
     listener->setProgressRange(1000);
 
@@ -67,24 +96,42 @@ void ESMStore::load(ESM::ESMReader &esm, Loading::Listener* listener)
     }
 
     // Loop through all records
-    while(esm.hasMoreRecs())
+    for (size_t recordIndex = 0; esm.hasMoreRecs(); ++recordIndex)
     {
         ESM::NAME n = esm.getRecName();
         esm.getRecHeader();
 
+        // Records read ahead by stage() only need to be inserted
+        StagedRecordBase* stagedRecord = nullptr;
+        if (staged && recordIndex < staged->size())
+            stagedRecord = (*staged)[recordIndex].get();
+        if (stagedRecord)
+            esm.skipRecord();
+
         // Look up the record type.
         std::map<int, StoreBase *>::iterator it = mStores.find(n.intval);
 
-        if (it == mStores.end()) {
+        if (it != mStores.end() && mCachedRecordsLoaded && it->second->isCacheable()) {
+            // Already merged into the store by readCache()
+            if (!stagedRecord)
+                esm.skipRecord();
+            dialogue = 0;
+        } else if (it == mStores.end()) {
             if (n.intval == ESM::REC_INFO) {
-                if (dialogue)
+                if (dialogue && stagedRecord)
+                {
+                    const StagedRecord<ESM::DialInfo>& info = static_cast<StagedRecord<ESM::DialInfo>&>(*stagedRecord);
+                    dialogue->addInfo(info.mRecord, info.mIsDeleted, esm.getIndex() != 0);
+                }
+                else if (dialogue)
                 {
                     dialogue->readInfo(esm, esm.getIndex() != 0);
                 }
                 else
                 {
                     Log(Debug::Error) << "Error: info record without dialog";
-                    esm.skipRecord();
+                    if (!stagedRecord)
+                        esm.skipRecord();
                 }
             } else if (n.intval == ESM::REC_MGEF) {
                 mMagicEffects.load (esm);
@@ -102,7 +149,7 @@ void ESMStore::load(ESM::ESMReader &esm, Loading::Listener* listener)
                 throw std::runtime_error(error.str());
             }
         } else {
-            RecordId id = it->second->load(esm);
+            RecordId id = stagedRecord ? it->second->loadStaged(*stagedRecord) : it->second->load(esm);
             if (id.mIsDeleted)
             {
                 it->second->eraseStatic(id.mId);
@@ -119,6 +166,40 @@ void ESMStore::load(ESM::ESMReader &esm, Loading::Listener* listener)
     }
 }
 
+void ESMStore::writeCache(ESM::ESMWriter &writer) const
+{
+    for (std::map<int, StoreBase *>::const_iterator it = mStores.begin(); it != mStores.end(); ++it)
+    {
+        if (it->second->isCacheable())
+            it->second->writeStatic(writer);
+    }
+}
+
+void ESMStore::readCache(ESM::ESMReader &esm)
+{
+    // Read everything before touching the stores, so a broken cache leaves them empty
+    StagedRecords records;
+    std::vector<StoreBase *> stores;
+
+    while(esm.hasMoreRecs())
+    {
+        ESM::NAME n = esm.getRecName();
+        esm.getRecHeader();
+
+        std::map<int, StoreBase *>::iterator it = mStores.find(n.intval);
+        if (it == mStores.end() || !it->second->isCacheable())
+            esm.fail("Unexpected record in record cache: " + n.toString());
+
+        records.push_back(it->second->stage(esm));
+        stores.push_back(it->second);
+    }
+
+    for (size_t i = 0; i < records.size(); ++i)
+        stores[i]->loadStaged(*records[i]);
+
+    mCachedRecordsLoaded = true;
+}
+
 void ESMStore::setUp(bool validateRecords)
 {
     mIds.clear();
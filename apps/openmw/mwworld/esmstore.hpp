@@ -74,6 +74,9 @@ namespace MWWorld
 
         unsigned int mDynamicCount;
 
+        /// Records of cacheable stores were read by readCache(), load() skips them in content files
+        bool mCachedRecordsLoaded;
+
         /// Validate entries in store after setup
         void validate();
 
@@ -102,6 +105,7 @@ namespace MWWorld
 
         ESMStore()
           : mDynamicCount(0)
+          , mCachedRecordsLoaded(false)
         {
             mStores[ESM::REC_ACTI] = &mActivators;
             mStores[ESM::REC_ALCH] = &mPotions;
@@ -161,7 +165,23 @@ namespace MWWorld
             mNpcs.insert(mPlayerTemplate);
         }
 
-        void load(ESM::ESMReader &esm, Loading::Listener* listener);
+        typedef std::vector<std::unique_ptr<StagedRecordBase> > StagedRecords;
+
+        /// Read all records of a content file that do not depend on previously loaded records,
+        /// without modifying the store. One entry is added per record, nullptr for records left to load().
+        /// @note Thread safe, may be called for several files at once while another file is being loaded.
+        void stage(ESM::ESMReader &esm, StagedRecords &records) const;
+
+        /// @param staged Records of the same file read by stage(), or nullptr to read everything here.
+        void load(ESM::ESMReader &esm, Loading::Listener* listener, StagedRecords* staged = nullptr);
+
+        /// Write all records of cacheable stores that were loaded from content files.
+        void writeCache(ESM::ESMWriter &writer) const;
+
+        /// Read records written by writeCache(), before any content file is loaded.
+        /// Records of cacheable stores are skipped by load() and stage() afterwards.
+        /// @note The store is left untouched if the records can not be read.
+        void readCache(ESM::ESMReader &esm);
 
         template <class T>
         const Store<T> &get() const {
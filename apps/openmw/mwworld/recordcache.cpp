@@ -0,0 +1,128 @@
+#include "recordcache.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <components/debug/debuglog.hpp>
+#include <components/esm/esmreader.hpp>
+#include <components/esm/esmwriter.hpp>
+#include <components/files/memorymappedfile.hpp>
+#include <components/to_utf8/to_utf8.hpp>
+
+#include "esmstore.hpp"
+
+namespace
+{
+    const int sKeyRecord = ESM::FourCC<'C','K','E','Y'>::value;
+
+    /// Increase when the layout of the cached records changes
+    const int sCacheFormat = 3;
+}
+
+namespace MWWorld
+{
+    RecordCache::RecordCache(const std::string& path, const Files::Collections& fileCollections,
+        const std::vector<std::string>& contentFiles, ToUTF8::Utf8Encoder* encoder,
+        const std::string& engineVersion)
+        : mPath(path)
+        , mKey(fileCollections, contentFiles, engineVersion)
+        , mEncoder(encoder)
+    {
+    }
+
+    bool RecordCache::read(ESMStore& store) const
+    {
+        if (!boost::filesystem::exists(mPath))
+            return false;
+
+        try
+        {
+            const Files::MemoryMappedFilePtr file(new Files::MemoryMappedFile(mPath));
+
+            ESM::ESMReader reader;
+            reader.setEncoder(mEncoder);
+            reader.open(Files::openMemoryMappedFileStream(file), mPath);
+
+            if (!readKey(reader))
+            {
+                Log(Debug::Info) << "Record cache " << mPath << " is out of date";
+                return false;
+            }
+
+            store.readCache(reader);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to read record cache " << mPath << ": " << e.what();
+            return false;
+        }
+
+        Log(Debug::Info) << "Loaded records from cache " << mPath;
+        return true;
+    }
+
+    void RecordCache::write(const ESMStore& store) const
+    {
+        const std::string tempPath = mPath + ".tmp";
+
+        try
+        {
+            boost::filesystem::ofstream stream(tempPath, std::ios::binary);
+
+            ESM::ESMWriter writer;
+            writer.setEncoder(mEncoder);
+            writer.setFormat(sCacheFormat);
+            writer.setVersion();
+            writer.setType(0);
+            writer.setAuthor("");
+            writer.setDescription("");
+            writer.save(stream);
+
+            writeKey(writer);
+            store.writeCache(writer);
+
+            writer.close();
+            stream.close();
+
+            if (stream.fail())
+                throw std::runtime_error("write error");
+
+            // Replace the old cache only once the new one is complete
+            boost::filesystem::rename(tempPath, mPath);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Error) << "Failed to write record cache " << mPath << ": " << e.what();
+            boost::system::error_code ec;
+            boost::filesystem::remove(tempPath, ec);
+        }
+    }
+
+    void RecordCache::writeKey(ESM::ESMWriter& writer) const
+    {
+        writer.startRecord(sKeyRecord);
+        mKey.save(writer);
+        writer.writeHNT("ENCD", getEncoding());
+        writer.endRecord(sKeyRecord);
+    }
+
+    bool RecordCache::readKey(ESM::ESMReader& reader) const
+    {
+        if (reader.getFormat() != sCacheFormat || !reader.hasMoreRecs() || reader.getRecName().intval != sKeyRecord)
+            return false;
+        reader.getRecHeader();
+
+        if (!mKey.matches(reader))
+            return false;
+
+        // Strings of the cached records are converted with the encoding
+        int encoding = -1;
+        reader.getHNT(encoding, "ENCD");
+        return encoding == getEncoding();
+    }
+
+    int RecordCache::getEncoding() const
+    {
+        return mEncoder ? static_cast<int>(mEncoder->getEncoding()) : -1;
+    }
+}
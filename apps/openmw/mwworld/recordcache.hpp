@@ -0,0 +1,61 @@
+#ifndef RECORDCACHE_HPP
+#define RECORDCACHE_HPP
+
+#include <string>
+#include <vector>
+
+#include "contentfilekey.hpp"
+
+namespace ToUTF8
+{
+    class Utf8Encoder;
+}
+
+namespace ESM
+{
+    class ESMReader;
+    class ESMWriter;
+}
+
+namespace Files
+{
+    class Collections;
+}
+
+namespace MWWorld
+{
+    class ESMStore;
+
+    /// @brief File holding the records merged from all content files into the generic stores of ESMStore.
+    /// @par The cache is only used while the same content files, with the same sizes and modification
+    /// times, are loaded in the same order with the same encoding by the same engine version. Any other change
+    /// rewrites it after loading.
+    class RecordCache
+    {
+        public:
+            RecordCache(const std::string& path, const Files::Collections& fileCollections,
+                const std::vector<std::string>& contentFiles, ToUTF8::Utf8Encoder* encoder,
+                const std::string& engineVersion);
+
+            /// Read the cached records into \a store, before any content file is loaded.
+            /// @return Was the cache up to date and read successfully?
+            bool read(ESMStore& store) const;
+
+            /// Replace the cache with the records loaded into \a store.
+            /// @note Failing to write the cache is not an error, it is only logged.
+            void write(const ESMStore& store) const;
+
+        private:
+            std::string mPath;
+            ContentFileKey mKey;
+            ToUTF8::Utf8Encoder* mEncoder;
+
+            void writeKey(ESM::ESMWriter& writer) const;
+
+            bool readKey(ESM::ESMReader& reader) const;
+
+            int getEncoding() const;
+    };
+}
+
+#endif
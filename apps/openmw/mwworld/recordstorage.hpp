@@ -0,0 +1,222 @@
+#ifndef OPENMW_MWWORLD_RECORDSTORAGE_H
+#define OPENMW_MWWORLD_RECORDSTORAGE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <components/misc/stringops.hpp>
+
+namespace MWWorld
+{
+    /// @brief Keeps records in fixed size chunks, close to each other in memory.
+    /// @note Pointers to the records stay valid until they are removed or the pool is cleared.
+    template <class T>
+    class RecordPool
+    {
+        public:
+            RecordPool() : mUsed(sChunkSize) {}
+
+            T *add(const T &record)
+            {
+                if (!mFree.empty())
+                {
+                    T *slot = mFree.back();
+                    mFree.pop_back();
+                    *slot = record;
+                    return slot;
+                }
+
+                if (mUsed == sChunkSize)
+                {
+                    mChunks.emplace_back(new T[sChunkSize]);
+                    mUsed = 0;
+                }
+
+                T *slot = &mChunks.back()[mUsed++];
+                *slot = record;
+                return slot;
+            }
+
+            /// Release the memory held by \a record and reuse its slot for the next add().
+            void remove(T *record)
+            {
+                *record = T();
+                mFree.push_back(record);
+            }
+
+            void clear()
+            {
+                mChunks.clear();
+                mFree.clear();
+                mUsed = sChunkSize;
+            }
+
+        private:
+            static const std::size_t sChunkSize = 64;
+
+            std::vector<std::unique_ptr<T[]> > mChunks;
+            std::size_t mUsed; // Slots used in the last chunk
+            std::vector<T *> mFree;
+    };
+
+    /// @brief Open addressing hash table from record IDs to records.
+    /// @par Every ID is lowercased once when it is inserted. Lookups fold the case of the given ID
+    /// while hashing and comparing, so they never allocate.
+    template <class T>
+    class RecordIndex
+    {
+        public:
+            RecordIndex() : mMask(0), mSize(0) {}
+
+            T *search(const std::string &id) const
+            {
+                if (mEntries.empty())
+                    return nullptr;
+
+                const std::uint64_t idHash = hash(id);
+                for (std::size_t slot = static_cast<std::size_t>(idHash) & mMask; mEntries[slot].mRecord != nullptr; slot = (slot + 1) & mMask)
+                {
+                    const Entry &entry = mEntries[slot];
+                    if (entry.mHash == idHash && equal(entry.mId, id))
+                        return entry.mRecord;
+                }
+
+                return nullptr;
+            }
+
+            /// Add \a record under \a id, replacing the record that was there before.
+            void insert(const std::string &id, T *record)
+            {
+                // Keep the load factor at or below 1/2 so probe sequences stay short
+                if (2 * (mSize + 1) > mEntries.size())
+                    rehash(mEntries.empty() ? 16 : 2 * mEntries.size());
+
+                const std::uint64_t idHash = hash(id);
+                std::size_t slot = static_cast<std::size_t>(idHash) & mMask;
+                for (; mEntries[slot].mRecord != nullptr; slot = (slot + 1) & mMask)
+                {
+                    Entry &entry = mEntries[slot];
+                    if (entry.mHash == idHash && equal(entry.mId, id))
+                    {
+                        entry.mRecord = record;
+                        return;
+                    }
+                }
+
+                mEntries[slot].mHash = idHash;
+                mEntries[slot].mId = Misc::StringUtils::lowerCase(id);
+                mEntries[slot].mRecord = record;
+                ++mSize;
+            }
+
+            /// @return The record that was removed, or nullptr if there is none with this ID.
+            T *erase(const std::string &id)
+            {
+                if (mEntries.empty())
+                    return nullptr;
+
+                const std::uint64_t idHash = hash(id);
+                std::size_t hole = static_cast<std::size_t>(idHash) & mMask;
+                for (; mEntries[hole].mRecord != nullptr; hole = (hole + 1) & mMask)
+                {
+                    if (mEntries[hole].mHash == idHash && equal(mEntries[hole].mId, id))
+                        break;
+                }
+
+                T *record = mEntries[hole].mRecord;
+                if (record == nullptr)
+                    return nullptr;
+
+                // Move back the following entries of the probe sequence, instead of leaving a tombstone
+                for (std::size_t next = (hole + 1) & mMask; mEntries[next].mRecord != nullptr; next = (next + 1) & mMask)
+                {
+                    const std::size_t home = static_cast<std::size_t>(mEntries[next].mHash) & mMask;
+                    if (((next - home) & mMask) >= ((next - hole) & mMask))
+                    {
+                        mEntries[hole] = std::move(mEntries[next]);
+                        hole = next;
+                    }
+                }
+
+                mEntries[hole] = Entry();
+                --mSize;
+                return record;
+            }
+
+            void clear()
+            {
+                mEntries.clear();
+                mMask = 0;
+                mSize = 0;
+            }
+
+            std::size_t size() const { return mSize; }
+
+            /// Call \a function with the lowercase ID and the record of every entry, in no particular order.
+            template <class Function>
+            void forEach(Function function) const
+            {
+                for (const Entry &entry : mEntries)
+                    if (entry.mRecord != nullptr)
+                        function(entry.mId, entry.mRecord);
+            }
+
+        private:
+            struct Entry
+            {
+                std::uint64_t mHash;
+                std::string mId;
+                T *mRecord;
+
+                Entry() : mHash(0), mRecord(nullptr) {}
+            };
+
+            std::vector<Entry> mEntries;
+            std::size_t mMask;
+            std::size_t mSize;
+
+            static std::uint64_t hash(const std::string &id)
+            {
+                // 64-bit FNV-1a over the lowercase characters
+                std::uint64_t result = 14695981039346656037ull;
+                for (char ch : id)
+                {
+                    result ^= static_cast<unsigned char>(Misc::StringUtils::toLower(ch));
+                    result *= 1099511628211ull;
+                }
+                return result;
+            }
+
+            static bool equal(const std::string &lowerId, const std::string &id)
+            {
+                if (lowerId.size() != id.size())
+                    return false;
+                for (std::size_t i = 0; i < id.size(); ++i)
+                    if (lowerId[i] != Misc::StringUtils::toLower(id[i]))
+                        return false;
+                return true;
+            }
+
+            void rehash(std::size_t capacity)
+            {
+                std::vector<Entry> entries(capacity);
+                mEntries.swap(entries);
+                mMask = capacity - 1;
+
+                for (Entry &entry : entries)
+                {
+                    if (entry.mRecord == nullptr)
+                        continue;
+                    std::size_t slot = static_cast<std::size_t>(entry.mHash) & mMask;
+                    while (mEntries[slot].mRecord != nullptr)
+                        slot = (slot + 1) & mMask;
+                    mEntries[slot] = std::move(entry);
+                }
+            }
+    };
+}
+
+#endif
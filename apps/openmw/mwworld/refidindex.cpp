@@ -0,0 +1,103 @@
+#include "refidindex.hpp"
+
+#include <algorithm>
+
+#include <osg/Stats>
+
+#include "cellstore.hpp"
+
+namespace MWWorld
+{
+    RefIdIndex::RefIdIndex()
+        : mNumSearches(0)
+        , mNumMisses(0)
+    {
+    }
+
+    bool RefIdIndex::isValid (const Entry& entry)
+    {
+        const Ptr& ptr = entry.mPtr;
+
+        if (!CellStore::isAccessible(ptr.getRefData(), ptr.getCellRef()))
+            return false;
+
+        // A reference is only moved between cells by CellStore::moveTo, which either records it as moved in
+        // the cell it is leaving, or deletes it and inserts a copy into the other cell.
+        if (entry.mMovedHere)
+            return ptr.getCell()->movedHere(ptr);
+
+        return !ptr.getCell()->movedToAnotherCell(ptr);
+    }
+
+    void RefIdIndex::addCell (CellStore& cell)
+    {
+        auto visitor = [&] (const Ptr& ptr)
+        {
+            add(ptr);
+            return true;
+        };
+        cell.forEach(visitor);
+    }
+
+    void RefIdIndex::removeCell (const CellStore& cell)
+    {
+        for (Refs::iterator iter = mRefs.begin(); iter != mRefs.end();)
+        {
+            std::vector<Entry>& entries = iter->second;
+            entries.erase(std::remove_if(entries.begin(), entries.end(),
+                [&] (const Entry& entry) { return entry.mPtr.getCell() == &cell; }), entries.end());
+
+            if (entries.empty())
+                iter = mRefs.erase(iter);
+            else
+                ++iter;
+        }
+    }
+
+    void RefIdIndex::add (const Ptr& ptr)
+    {
+        std::vector<Entry>& entries = mRefs[ptr.getCellRef().getRefId()];
+
+        // Drop the references that have become invalid, including the previous entry of a moved reference
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+            [&] (const Entry& entry) { return entry.mPtr.getBase() == ptr.getBase() || !isValid(entry); }), entries.end());
+
+        Entry entry;
+        entry.mPtr = ptr;
+        entry.mMovedHere = ptr.getCell()->movedHere(ptr);
+        entries.push_back(entry);
+    }
+
+    Ptr RefIdIndex::search (const std::string& id)
+    {
+        ++mNumSearches;
+
+        Refs::const_iterator found = mRefs.find(id);
+        if (found != mRefs.end())
+        {
+            for (const Entry& entry : found->second)
+                if (isValid(entry))
+                    return entry.mPtr;
+        }
+
+        ++mNumMisses;
+        return Ptr();
+    }
+
+    void RefIdIndex::clear()
+    {
+        mRefs.clear();
+    }
+
+    void RefIdIndex::reportStats (unsigned int frameNumber, osg::Stats& stats)
+    {
+        if (stats.collectStats("resource"))
+        {
+            stats.setAttribute(frameNumber, "Ptr Search", mNumSearches);
+            stats.setAttribute(frameNumber, "Ptr Search Fallback", mNumMisses);
+        }
+
+        mNumSearches = 0;
+        mNumMisses = 0;
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef GAME_MWWORLD_REFIDINDEX_H
+#define GAME_MWWORLD_REFIDINDEX_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ptr.hpp"
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace MWWorld
+{
+    class CellStore;
+
+    /// \brief Maps case-smashed reference IDs to the references with that ID in the active cells.
+    ///
+    /// Entries are checked on every lookup, so references that were deleted or moved to another cell
+    /// are never returned. References added without telling the index are missed, and have to be found
+    /// by scanning the cells instead.
+    class RefIdIndex
+    {
+        public:
+
+            RefIdIndex();
+
+            void addCell (CellStore& cell);
+            ///< Index all references in \a cell.
+
+            void removeCell (const CellStore& cell);
+            ///< Remove all references in \a cell.
+
+            void add (const Ptr& ptr);
+            ///< Add or update the entry for \a ptr, which must be in an active cell.
+
+            Ptr search (const std::string& id);
+            ///< \a id must be in lower case.
+            /// \return Empty Ptr if no valid reference is indexed under \a id.
+
+            void clear();
+
+            void reportStats (unsigned int frameNumber, osg::Stats& stats);
+            ///< Report the number of searches and misses since the last report, and start counting anew.
+
+        private:
+
+            struct Entry
+            {
+                Ptr mPtr;
+                bool mMovedHere;
+            };
+
+            typedef std::unordered_map<std::string, std::vector<Entry> > Refs;
+
+            Refs mRefs;
+            std::size_t mNumSearches;
+            std::size_t mNumMisses;
+
+            static bool isValid (const Entry& entry);
+    };
+}
+
+#endif
@@ -379,6 +379,7 @@ namespace MWWorld
         MWBase::Environment::get().getWorld()->getLocalScripts().clearCell (*iter);
 
         MWBase::Environment::get().getSoundManager()->stopSound (*iter);
+        mRefIdIndex.removeCell (**iter);
         mActiveCells.erase(*iter);
     }
 
@@ -431,6 +432,10 @@ namespace MWWorld
             /// \todo rescale depending on the state of a new GMST
             insertCell (*cell, true, loadingListener);
 
+            mRefIdIndex.addCell (*cell);
+
+            MWBase::Environment::get().getSoundManager()->preloadSounds(cell);
+
             mRendering.addCell(cell);
             bool waterEnabled = cell->getCell()->hasWater() || cell->isExterior();
             float waterLevel = cell->getWaterLevel();
@@ -682,6 +687,11 @@ namespace MWWorld
         return mActiveCells;
     }
 
+    RefIdIndex& Scene::getRefIdIndex()
+    {
+        return mRefIdIndex;
+    }
+
     void Scene::changeToInteriorCell (const std::string& cellName, const ESM::Position& position, bool adjustPlayerPos, bool changeEvent)
     {
         CellStore *cell = MWBase::Environment::get().getWorld()->getInterior(cellName);
@@ -889,6 +899,8 @@ namespace MWWorld
 
         mLastPlayerPos = playerPos;
 
+        mNavigator.setPredictedPlayerPosition(predictedPos);
+
         if (mPreloadEnabled)
         {
             if (mPreloadDoors)
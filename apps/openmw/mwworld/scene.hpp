@@ -3,6 +3,7 @@
 
 #include "ptr.hpp"
 #include "globals.hpp"
+#include "refidindex.hpp"
 
 #include <set>
 #include <memory>
@@ -61,6 +62,7 @@ namespace MWWorld
 
             CellStore* mCurrentCell; // the cell the player is in
             CellStoreCollection mActiveCells;
+            RefIdIndex mRefIdIndex;
             bool mCellChanged;
             MWPhysics::PhysicsSystem *mPhysics;
             MWRender::RenderingManager& mRendering;
@@ -113,6 +115,9 @@ namespace MWWorld
 
             const CellStoreCollection& getActiveCells () const;
 
+            RefIdIndex& getRefIdIndex();
+            ///< References in the active cells by ID.
+
             bool hasCellChanged() const;
             ///< Has the set of active cells changed, since the last frame?
 
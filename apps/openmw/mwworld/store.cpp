@@ -8,6 +8,8 @@
 #include <components/loadinglistener/loadinglistener.hpp>
 #include <components/misc/rng.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <stdexcept>
 
 namespace
@@ -45,6 +47,25 @@ namespace
             return x->mX < y.first;
         }
     };
+
+    /// Record header flags to write for a record, so that loading it again gives the same record
+    template<typename T>
+    std::uint32_t getRecordFlags(const T& /*record*/)
+    {
+        return 0;
+    }
+
+    // Read back by ESM::NPC::load
+    std::uint32_t getRecordFlags(const ESM::NPC& record)
+    {
+        return record.mPersistent ? 0x0400 : 0;
+    }
+
+    // Read back by ESM::Creature::load
+    std::uint32_t getRecordFlags(const ESM::Creature& record)
+    {
+        return record.mPersistent ? 0x0400 : 0;
+    }
 }
 
 namespace MWWorld
@@ -120,42 +141,48 @@ namespace MWWorld
 
     template<typename T>
     Store<T>::Store(const Store<T>& orig)
-        : mStatic(orig.mStatic)
     {
+        typename std::vector<T *>::const_iterator end = orig.mShared.begin() + orig.mStaticIndex.size();
+        for (typename std::vector<T *>::const_iterator it = orig.mShared.begin(); it != end; ++it)
+            insert(mStatic, mStaticIndex, **it);
+    }
+
+    template<typename T>
+    T *Store<T>::insert(RecordPool<T> &pool, RecordIndex<T> &index, const T &item)
+    {
+        T *ptr = index.search(item.mId);
+        if (ptr) {
+            *ptr = item;
+        } else {
+            ptr = pool.add(item);
+            index.insert(item.mId, ptr);
+            mShared.push_back(ptr);
+        }
+        return ptr;
     }
 
     template<typename T>
     void Store<T>::clearDynamic()
     {
         // remove the dynamic part of mShared
-        assert(mShared.size() >= mStatic.size());
-        mShared.erase(mShared.begin() + mStatic.size(), mShared.end());
+        assert(mShared.size() >= mStaticIndex.size());
+        mShared.erase(mShared.begin() + mStaticIndex.size(), mShared.end());
         mDynamic.clear();
+        mDynamicIndex.clear();
     }
 
     template<typename T>
     const T *Store<T>::search(const std::string &id) const
     {
-        std::string idLower = Misc::StringUtils::lowerCase(id);
-
-        typename Dynamic::const_iterator dit = mDynamic.find(idLower);
-        if (dit != mDynamic.end()) {
-            return &dit->second;
-        }
-
-        typename std::map<std::string, T>::const_iterator it = mStatic.find(idLower);
-
-        if (it != mStatic.end() && Misc::StringUtils::ciEqual(it->second.mId, id)) {
-            return &(it->second);
-        }
-
-        return 0;
+        const T *ptr = mDynamicIndex.search(id);
+        if (ptr)
+            return ptr;
+        return mStaticIndex.search(id);
     }
     template<typename T>
     bool Store<T>::isDynamic(const std::string &id) const
     {
-        typename Dynamic::const_iterator dit = mDynamic.find(id);
-        return (dit != mDynamic.end());
+        return mDynamicIndex.search(id) != nullptr;
     }
     template<typename T>
     const T *Store<T>::searchRandom(const std::string &id) const
@@ -197,15 +224,31 @@ namespace MWWorld
         record.load(esm, isDeleted);
         Misc::StringUtils::lowerCaseInPlace(record.mId);
 
-        std::pair<typename Static::iterator, bool> inserted = mStatic.insert(std::make_pair(record.mId, record));
-        if (inserted.second)
-            mShared.push_back(&inserted.first->second);
-        else
-            inserted.first->second = record;
+        insert(mStatic, mStaticIndex, record);
 
         return RecordId(record.mId, isDeleted);
     }
     template<typename T>
+    std::unique_ptr<StagedRecordBase> Store<T>::stage(ESM::ESMReader &esm) const
+    {
+        StagedRecord<T>* staged = new StagedRecord<T>;
+        std::unique_ptr<StagedRecordBase> result(staged);
+
+        staged->mRecord.load(esm, staged->mIsDeleted);
+        Misc::StringUtils::lowerCaseInPlace(staged->mRecord.mId);
+
+        return result;
+    }
+    template<typename T>
+    RecordId Store<T>::loadStaged(StagedRecordBase &record)
+    {
+        StagedRecord<T>& staged = static_cast<StagedRecord<T>&>(record);
+
+        insert(mStatic, mStaticIndex, staged.mRecord);
+
+        return RecordId(staged.mRecord.mId, staged.mIsDeleted);
+    }
+    template<typename T>
     void Store<T>::setUp()
     {
     }
@@ -230,7 +273,7 @@ namespace MWWorld
     template<typename T>
     int Store<T>::getDynamicSize() const
     {
-        return mDynamic.size();
+        return mDynamicIndex.size();
     }
     template<typename T>
     void Store<T>::listIdentifier(std::vector<std::string> &list) const
@@ -244,51 +287,27 @@ namespace MWWorld
     template<typename T>
     T *Store<T>::insert(const T &item)
     {
-        std::string id = Misc::StringUtils::lowerCase(item.mId);
-        std::pair<typename Dynamic::iterator, bool> result =
-            mDynamic.insert(std::pair<std::string, T>(id, item));
-        T *ptr = &result.first->second;
-        if (result.second) {
-            mShared.push_back(ptr);
-        } else {
-            *ptr = item;
-        }
-        return ptr;
+        return insert(mDynamic, mDynamicIndex, item);
     }
     template<typename T>
     T *Store<T>::insertStatic(const T &item)
     {
-        std::string id = Misc::StringUtils::lowerCase(item.mId);
-        std::pair<typename Static::iterator, bool> result =
-            mStatic.insert(std::pair<std::string, T>(id, item));
-        T *ptr = &result.first->second;
-        if (result.second) {
-            mShared.push_back(ptr);
-        } else {
-            *ptr = item;
-        }
-        return ptr;
+        return insert(mStatic, mStaticIndex, item);
     }
     template<typename T>
     bool Store<T>::eraseStatic(const std::string &id)
     {
-        std::string idLower = Misc::StringUtils::lowerCase(id);
-
-        typename std::map<std::string, T>::iterator it = mStatic.find(idLower);
+        T *ptr = mStaticIndex.search(id);
 
-        if (it != mStatic.end() && Misc::StringUtils::ciEqual(it->second.mId, id)) {
+        if (ptr) {
             // delete from the static part of mShared
-            typename std::vector<T *>::iterator sharedIter = mShared.begin();
-            typename std::vector<T *>::iterator end = sharedIter + mStatic.size();
+            typename std::vector<T *>::iterator end = mShared.begin() + std::min(mShared.size(), mStaticIndex.size());
+            typename std::vector<T *>::iterator sharedIter = std::find(mShared.begin(), end, ptr);
+            if (sharedIter != end)
+                mShared.erase(sharedIter);
 
-            while (sharedIter != mShared.end() && sharedIter != end) {
-                if((*sharedIter)->mId == idLower) {
-                    mShared.erase(sharedIter);
-                    break;
-                }
-                ++sharedIter;
-            }
-            mStatic.erase(it);
+            mStaticIndex.erase(id);
+            mStatic.remove(ptr);
         }
 
         return true;
@@ -297,19 +316,14 @@ namespace MWWorld
     template<typename T>
     bool Store<T>::erase(const std::string &id)
     {
-        std::string key = Misc::StringUtils::lowerCase(id);
-        typename Dynamic::iterator it = mDynamic.find(key);
-        if (it == mDynamic.end()) {
+        T *ptr = mDynamicIndex.erase(id);
+        if (!ptr) {
             return false;
         }
-        mDynamic.erase(it);
 
-        // have to reinit the whole shared part
-        assert(mShared.size() >= mStatic.size());
-        mShared.erase(mShared.begin() + mStatic.size(), mShared.end());
-        for (it = mDynamic.begin(); it != mDynamic.end(); ++it) {
-            mShared.push_back(&it->second);
-        }
+        assert(mShared.size() >= mStaticIndex.size());
+        mShared.erase(std::find(mShared.begin() + mStaticIndex.size(), mShared.end(), ptr));
+        mDynamic.remove(ptr);
         return true;
     }
     template<typename T>
@@ -320,11 +334,27 @@ namespace MWWorld
     template<typename T>
     void Store<T>::write (ESM::ESMWriter& writer, Loading::Listener& progress) const
     {
-        for (typename Dynamic::const_iterator iter (mDynamic.begin()); iter!=mDynamic.end();
+        for (typename std::vector<T *>::const_iterator iter (mShared.begin() + mStaticIndex.size()); iter!=mShared.end();
              ++iter)
         {
-            writer.startRecord (T::sRecordId);
-            iter->second.save (writer);
+            writer.startRecord (T::sRecordId, getRecordFlags(**iter));
+            (*iter)->save (writer);
+            writer.endRecord (T::sRecordId);
+        }
+    }
+    template<typename T>
+    bool Store<T>::isCacheable() const
+    {
+        return true;
+    }
+    template<typename T>
+    void Store<T>::writeStatic(ESM::ESMWriter& writer) const
+    {
+        typename std::vector<T *>::const_iterator end = mShared.begin() + mStaticIndex.size();
+        for (typename std::vector<T *>::const_iterator it = mShared.begin(); it != end; ++it)
+        {
+            writer.startRecord (T::sRecordId, getRecordFlags(**it));
+            (*it)->save (writer);
             writer.endRecord (T::sRecordId);
         }
     }
@@ -1032,20 +1062,38 @@ namespace MWWorld
     {
         // DialInfos marked as deleted are kept during the loading phase, so that the linked list
         // structure is kept intact for inserting further INFOs. Delete them now that loading is done.
-        for (Static::iterator it = mStatic.begin(); it != mStatic.end(); ++it)
+        std::vector<std::pair<std::string, ESM::Dialogue*> > sorted;
+        sorted.reserve(mStaticIndex.size());
+        mStaticIndex.forEach([&] (const std::string& id, ESM::Dialogue* dial)
         {
-            ESM::Dialogue& dial = it->second;
-            dial.clearDeletedInfos();
-        }
+            dial->clearDeletedInfos();
+            sorted.push_back(std::make_pair(id, dial));
+        });
+
+        // Dialogues are listed in the order of their lowercase IDs
+        std::sort(sorted.begin(), sorted.end());
 
         mShared.clear();
-        mShared.reserve(mStatic.size());
-        std::map<std::string, ESM::Dialogue>::iterator it = mStatic.begin();
-        for (; it != mStatic.end(); ++it) {
-            mShared.push_back(&(it->second));
+        mShared.reserve(sorted.size());
+        for (std::vector<std::pair<std::string, ESM::Dialogue*> >::const_iterator it = sorted.begin(); it != sorted.end(); ++it) {
+            mShared.push_back(it->second);
         }
     }
 
+    template <>
+    std::unique_ptr<StagedRecordBase> Store<ESM::Dialogue>::stage(ESM::ESMReader &esm) const
+    {
+        // Dialogues are merged with the existing record while they are read, see load()
+        return nullptr;
+    }
+
+    template <>
+    bool Store<ESM::Dialogue>::isCacheable() const
+    {
+        // Infos are attached to their dialogue while the content files are read
+        return false;
+    }
+
     template <>
     inline RecordId Store<ESM::Dialogue>::load(ESM::ESMReader &esm) {
         // The original letter case of a dialogue ID is saved, because it's printed
@@ -1054,17 +1102,16 @@ namespace MWWorld
 
         dialogue.loadId(esm);
 
-        std::string idLower = Misc::StringUtils::lowerCase(dialogue.mId);
-        std::map<std::string, ESM::Dialogue>::iterator found = mStatic.find(idLower);
-        if (found == mStatic.end())
+        ESM::Dialogue *found = mStaticIndex.search(dialogue.mId);
+        if (!found)
         {
             dialogue.loadData(esm, isDeleted);
-            mStatic.insert(std::make_pair(idLower, dialogue));
+            mStaticIndex.insert(dialogue.mId, mStatic.add(dialogue));
         }
         else
         {
-            found->second.loadData(esm, isDeleted);
-            dialogue = found->second;
+            found->loadData(esm, isDeleted);
+            dialogue = *found;
         }
 
         return RecordId(dialogue.mId, isDeleted);
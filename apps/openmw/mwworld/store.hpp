@@ -1,11 +1,13 @@
 #ifndef OPENMW_MWWORLD_STORE_H
 #define OPENMW_MWWORLD_STORE_H
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <map>
 
 #include "recordcmp.hpp"
+#include "recordstorage.hpp"
 
 namespace ESM
 {
@@ -27,6 +29,21 @@ namespace MWWorld
         RecordId(const std::string &id = "", bool isDeleted = false);
     };
 
+    /// A record that was read ahead of time and still has to be inserted into its store.
+    struct StagedRecordBase
+    {
+        virtual ~StagedRecordBase() {}
+    };
+
+    template <class T>
+    struct StagedRecord : StagedRecordBase
+    {
+        T mRecord;
+        bool mIsDeleted;
+
+        StagedRecord() : mIsDeleted(false) {}
+    };
+
     class StoreBase
     {
     public:
@@ -41,6 +58,20 @@ namespace MWWorld
         virtual int getDynamicSize() const { return 0; }
         virtual RecordId load(ESM::ESMReader &esm) = 0;
 
+        /// Read a record without modifying the store, so that it can be done on a worker thread.
+        /// @return nullptr if this store can only be loaded with load(). Nothing is read from \a esm in that case.
+        /// @note Thread safe.
+        virtual std::unique_ptr<StagedRecordBase> stage(ESM::ESMReader &esm) const { return nullptr; }
+
+        /// Insert a record previously read by stage(). Has the same effect as load() on that record.
+        virtual RecordId loadStaged(StagedRecordBase &record) { return RecordId(); }
+
+        /// Can the records loaded from content files be written with writeStatic() and read back with load()?
+        virtual bool isCacheable() const { return false; }
+
+        /// Write the records loaded from content files so far.
+        virtual void writeStatic(ESM::ESMWriter& writer) const {}
+
         virtual bool eraseStatic(const std::string &id) {return false;}
         virtual void clearDynamic() {}
 
@@ -138,14 +169,16 @@ namespace MWWorld
     template <class T>
     class Store : public StoreBase
     {
-        std::map<std::string, T>      mStatic;
+        RecordPool<T>       mStatic;
+        RecordIndex<T>      mStaticIndex;
         std::vector<T *>    mShared; // Preserves the record order as it came from the content files (this
                                      // is relevant for the spell autocalc code and selection order
                                      // for heads/hairs in the character creation)
-        std::map<std::string, T> mDynamic;
+        RecordPool<T>       mDynamic;
+        RecordIndex<T>      mDynamicIndex;
 
-        typedef std::map<std::string, T> Dynamic;
-        typedef std::map<std::string, T> Static;
+        /// Add \a item to the given storage, or overwrite the record with the same ID
+        T *insert(RecordPool<T> &pool, RecordIndex<T> &index, const T &item);
 
         friend class ESMStore;
 
@@ -192,6 +225,10 @@ namespace MWWorld
         bool erase(const T &item);
 
         RecordId load(ESM::ESMReader &esm);
+        std::unique_ptr<StagedRecordBase> stage(ESM::ESMReader &esm) const;
+        RecordId loadStaged(StagedRecordBase &record);
+        bool isCacheable() const;
+        void writeStatic(ESM::ESMWriter& writer) const;
         void write(ESM::ESMWriter& writer, Loading::Listener& progress) const;
         RecordId read(ESM::ESMReader& reader);
     };
@@ -28,6 +28,8 @@
 #include <components/detournavigator/navigatorstub.hpp>
 #include <components/detournavigator/recastglobalallocator.hpp>
 
+#include <components/version/version.hpp>
+
 #include "../mwbase/environment.hpp"
 #include "../mwbase/soundmanager.hpp"
 #include "../mwbase/mechanicsmanager.hpp"
@@ -67,6 +69,7 @@
 
 #include "contentloader.hpp"
 #include "esmloader.hpp"
+#include "recordcache.hpp"
 
 namespace
 {
@@ -97,6 +100,13 @@ namespace MWWorld
             return mLoaders.insert(std::make_pair(extension, loader)).second;
         }
 
+        void preload(const boost::filesystem::path& filepath, int index)
+        {
+            LoadersContainer::iterator it(mLoaders.find(Misc::StringUtils::lowerCase(filepath.extension().string())));
+            if (it != mLoaders.end())
+                it->second->preload(filepath, index);
+        }
+
         void load(const boost::filesystem::path& filepath, int& index)
         {
             LoadersContainer::iterator it(mLoaders.find(Misc::StringUtils::lowerCase(filepath.extension().string())));
@@ -172,7 +182,8 @@ namespace MWWorld
         listener->loadingOn();
 
         GameContentLoader gameContentLoader(*listener);
-        EsmLoader esmLoader(mStore, mEsm, encoder, *listener);
+        EsmLoader esmLoader(mStore, mEsm, encoder, *listener,
+            std::max(0, Settings::Manager::getInt("content loading threads", "General")));
 
         gameContentLoader.addLoader(".esm", &esmLoader);
         gameContentLoader.addLoader(".esp", &esmLoader);
@@ -180,8 +191,21 @@ namespace MWWorld
         gameContentLoader.addLoader(".omwaddon", &esmLoader);
         gameContentLoader.addLoader(".project", &esmLoader);
 
+        // Records of the generic stores can be read from a single cache instead of being merged from every content file
+        std::unique_ptr<RecordCache> recordCache;
+        bool cachedRecords = false;
+        if (Settings::Manager::getBool("record cache", "General"))
+        {
+            recordCache.reset(new RecordCache(mUserDataPath + "/records.cache", fileCollections, contentFiles, encoder,
+                Version::getOpenmwVersionDescription(resourcePath)));
+            cachedRecords = recordCache->read(mStore);
+        }
+
         loadContentFiles(fileCollections, contentFiles, gameContentLoader);
 
+        if (recordCache && !cachedRecords)
+            recordCache->write(mStore);
+
         listener->loadingOff();
 
         // insert records that may not be present in all versions of MW
@@ -195,13 +219,15 @@ namespace MWWorld
 
         mSwimHeightScale = mStore.get<ESM::GameSetting>().find("fSwimHeightScale")->mValue.getFloat();
 
-        mPhysics.reset(new MWPhysics::PhysicsSystem(resourceSystem, rootNode));
+        mPhysics.reset(new MWPhysics::PhysicsSystem(resourceSystem, rootNode,
+            std::max(0, Settings::Manager::getInt("actor movement threads", "General"))));
 
         if (auto navigatorSettings = DetourNavigator::makeSettingsFromSettingsManager())
         {
             navigatorSettings->mMaxClimb = MWPhysics::sStepSizeUp;
             navigatorSettings->mMaxSlope = MWPhysics::sMaxSlope;
             navigatorSettings->mSwimHeightScale = mSwimHeightScale;
+            navigatorSettings->mNavMeshDiskCachePath = mUserDataPath + "/navmesh.cache";
             if (Settings::Manager::getBool("enable log", "Navigator"))
                 DetourNavigator::Log::instance().setSink(std::unique_ptr<DetourNavigator::FileSink>(
                     new DetourNavigator::FileSink(Settings::Manager::getString("log path", "Navigator"))));
@@ -701,13 +727,21 @@ namespace MWWorld
 
         std::string lowerCaseName = Misc::StringUtils::lowerCase(name);
 
+        RefIdIndex& index = mWorldScene->getRefIdIndex();
+        ret = index.search (lowerCaseName);
+        if (!ret.isEmpty())
+            return ret;
+
+        // Not indexed, e.g. spawned without going through copyObjectToCell
         for (CellStore* cellstore : mWorldScene->getActiveCells())
         {
-            // TODO: caching still doesn't work efficiently here (only works for the one CellStore that the reference is in)
             Ptr ptr = mCells.getPtr (lowerCaseName, *cellstore, false);
 
             if (!ptr.isEmpty())
+            {
+                index.add (ptr);
                 return ptr;
+            }
         }
 
         if (!activeOnly)
@@ -1199,6 +1233,7 @@ namespace MWWorld
     MWWorld::Ptr World::moveObject(const Ptr &ptr, CellStore* newCell, float x, float y, float z, bool movePhysics)
     {
         ESM::Position pos = ptr.getRefData().getPosition();
+        const osg::Vec3f oldPosition = pos.asVec3();
 
         pos.pos[0] = x;
         pos.pos[1] = y;
@@ -1248,6 +1283,7 @@ namespace MWWorld
                 {
                     newPtr = currCell->moveTo(ptr, newCell);
                     mWorldScene->addObjectToScene(newPtr);
+                    mWorldScene->getRefIdIndex().add(newPtr);
 
                     std::string script = newPtr.getClass().getScript(newPtr);
                     if (!script.empty())
@@ -1271,6 +1307,7 @@ namespace MWWorld
                 else // both cells active
                 {
                     newPtr = currCell->moveTo(ptr, newCell);
+                    mWorldScene->getRefIdIndex().add(newPtr);
 
                     mRendering->updatePtr(ptr, newPtr);
                     MWBase::Environment::get().getSoundManager()->updatePtr (ptr, newPtr);
@@ -1301,6 +1338,9 @@ namespace MWWorld
 
                 if (const auto object = mPhysics->getObject(newPtr))
                     updateNavigatorObject(object);
+
+                if (newPtr.getClass().isActor())
+                    MWBase::Environment::get().getMechanicsManager()->updatePosition(newPtr, oldPosition);
             }
         }
         if (isPlayer)
@@ -1841,6 +1881,13 @@ namespace MWWorld
         }
     }
 
+    void World::reportStats (unsigned int frameNumber, osg::Stats& stats, osg::Timer_t startTick) const
+    {
+        mPhysics->reportStats(frameNumber, stats, startTick);
+        mWorldScene->getRefIdIndex().reportStats(frameNumber, stats);
+        mNavigator->reportStats(frameNumber, stats);
+    }
+
     void World::updatePlayer()
     {
         MWWorld::Ptr player = getPlayerPtr();
@@ -2205,6 +2252,7 @@ namespace MWWorld
         dropped.getCellRef().unsetRefNum();
 
         if (mWorldScene->isCellActive(*cell)) {
+            mWorldScene->getRefIdIndex().add(dropped);
             if (dropped.getRefData().isEnabled()) {
                 mWorldScene->addObjectToScene(dropped);
             }
@@ -2915,8 +2963,19 @@ namespace MWWorld
     void World::loadContentFiles(const Files::Collections& fileCollections,
         const std::vector<std::string>& content, ContentLoader& contentLoader)
     {
+        // Let the loaders start reading files in the background, they are still merged in load order below
         int idx = 0;
         for (const std::string &file : content)
+        {
+            boost::filesystem::path filename(file);
+            const Files::MultiDirCollection& col = fileCollections.getCollection(filename.extension().string());
+            if (col.doesExist(file))
+                contentLoader.preload(col.getPath(file), idx);
+            idx++;
+        }
+
+        idx = 0;
+        for (const std::string &file : content)
         {
             boost::filesystem::path filename(file);
             const Files::MultiDirCollection& col = fileCollections.getCollection(filename.extension().string());
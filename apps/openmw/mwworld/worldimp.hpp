@@ -488,6 +488,9 @@ namespace MWWorld
             void update (float duration, bool paused) override;
             void updatePhysics (float duration, bool paused) override;
 
+            void reportStats (unsigned int frameNumber, osg::Stats& stats, osg::Timer_t startTick) const override;
+            ///< Report the times of the phases of updatePhysics, relative to \a startTick.
+
             void updateWindowManager () override;
 
             MWWorld::Ptr placeObject (const MWWorld::ConstPtr& object, float cursorX, float cursorY, int amount) override;
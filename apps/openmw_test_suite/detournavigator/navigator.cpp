@@ -93,6 +93,27 @@ namespace
         EXPECT_THROW(mNavigator->findPath(mAgentHalfExtents, mStart, mEnd, Flag_walk, mOut), NavigatorException);
     }
 
+    TEST_F(DetourNavigatorNavigatorTest, add_agent_with_half_extents_step_should_share_navmesh_for_close_sizes)
+    {
+        mSettings.mAgentHalfExtentsStep = 16;
+        mNavigator.reset(new NavigatorImpl(mSettings));
+        const osg::Vec3f otherAgentHalfExtents(30, 25, 70);
+
+        mNavigator->addAgent(mAgentHalfExtents);
+        mNavigator->addAgent(otherAgentHalfExtents);
+        mNavigator->addAgent(osg::Vec3f(33, 33, 66));
+
+        const auto navMeshes = mNavigator->getNavMeshes();
+        ASSERT_EQ(navMeshes.size(), 2u);
+        EXPECT_EQ(navMeshes.begin()->first, osg::Vec3f(32, 32, 80));
+
+        mNavigator->removeAgent(mAgentHalfExtents);
+        EXPECT_THROW(mNavigator->findPath(otherAgentHalfExtents, mStart, mEnd, Flag_walk, mOut), NavigatorException);
+        mNavigator->removeAgent(otherAgentHalfExtents);
+        mNavigator->findPath(otherAgentHalfExtents, mStart, mEnd, Flag_walk, mOut);
+        EXPECT_EQ(mPath, std::deque<osg::Vec3f>());
+    }
+
     TEST_F(DetourNavigatorNavigatorTest, update_then_find_path_should_return_path)
     {
         const std::array<btScalar, 5 * 5> heightfieldData {{
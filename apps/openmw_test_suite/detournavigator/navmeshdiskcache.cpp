@@ -0,0 +1,157 @@
+#include "operators.hpp"
+
+#include <components/detournavigator/navmeshdiskcache.hpp>
+#include <components/detournavigator/recastmesh.hpp>
+#include <components/detournavigator/settings.hpp>
+
+#include <DetourAlloc.h>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+
+    struct DetourNavigatorNavMeshDiskCacheTest : Test
+    {
+        const osg::Vec3f mAgentHalfExtents {1, 2, 3};
+        const TilePosition mTilePosition {0, 0};
+        const std::vector<int> mIndices {{0, 1, 2}};
+        const std::vector<float> mVertices {{0, 0, 0, 1, 0, 0, 1, 1, 0}};
+        const std::vector<AreaType> mAreaTypes {1, AreaType_ground};
+        const std::vector<RecastMesh::Water> mWater {};
+        const std::size_t mTrianglesPerChunk {1};
+        const RecastMesh mRecastMesh {mIndices, mVertices, mAreaTypes, mWater, mTrianglesPerChunk};
+        const std::vector<OffMeshConnection> mOffMeshConnections {};
+        const std::string mPath = (boost::filesystem::temp_directory_path()
+            / boost::filesystem::unique_path("openmw_navmesh_%%%%%%%%.cache")).string();
+        Settings mSettings;
+
+        DetourNavigatorNavMeshDiskCacheTest()
+        {
+            mSettings.mCellSize = 0.2f;
+            mSettings.mTileSize = 64;
+            mSettings.mMaxNavMeshDiskCacheSize = 1024 * 1024;
+        }
+
+        ~DetourNavigatorNavMeshDiskCacheTest()
+        {
+            boost::system::error_code error;
+            boost::filesystem::remove(mPath, error);
+        }
+
+        static NavMeshData makeNavMeshData(const std::string& value)
+        {
+            NavMeshData result(reinterpret_cast<unsigned char*>(dtAlloc(static_cast<int>(value.size()), DT_ALLOC_PERM)),
+                               static_cast<int>(value.size()));
+            std::memcpy(result.mValue.get(), value.data(), value.size());
+            return result;
+        }
+
+        static std::string toString(const NavMeshData& value)
+        {
+            if (!value.mValue)
+                return std::string();
+            return std::string(reinterpret_cast<const char*>(value.mValue.get()), static_cast<std::size_t>(value.mSize));
+        }
+    };
+
+    TEST_F(DetourNavigatorNavMeshDiskCacheTest, get_for_empty_cache_should_return_empty_value_and_count_miss)
+    {
+        NavMeshDiskCache cache(mPath, mSettings);
+
+        EXPECT_FALSE(cache.get(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections).mValue);
+        EXPECT_EQ(cache.getStats().mHits, 0u);
+        EXPECT_EQ(cache.getStats().mMisses, 1u);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDiskCacheTest, get_after_set_should_return_copy_of_data)
+    {
+        NavMeshDiskCache cache(mPath, mSettings);
+        cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections, makeNavMeshData("tile"));
+
+        EXPECT_EQ(toString(cache.get(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections)), "tile");
+        EXPECT_EQ(cache.getStats().mHits, 1u);
+        EXPECT_EQ(cache.getStats().mTiles, 1u);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDiskCacheTest, get_should_distinguish_agents_tiles_and_geometry)
+    {
+        NavMeshDiskCache cache(mPath, mSettings);
+        cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections, makeNavMeshData("tile"));
+
+        const std::vector<float> otherVertices {{0, 0, 0, 1, 0, 0, 1, 2, 0}};
+        const RecastMesh otherRecastMesh {mIndices, otherVertices, mAreaTypes, mWater, mTrianglesPerChunk};
+
+        EXPECT_FALSE(cache.get(osg::Vec3f(1, 2, 4), mTilePosition, mRecastMesh, mOffMeshConnections).mValue);
+        EXPECT_FALSE(cache.get(mAgentHalfExtents, TilePosition(0, 1), mRecastMesh, mOffMeshConnections).mValue);
+        EXPECT_FALSE(cache.get(mAgentHalfExtents, mTilePosition, otherRecastMesh, mOffMeshConnections).mValue);
+        EXPECT_EQ(cache.getStats().mMisses, 3u);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDiskCacheTest, reopened_cache_should_return_data_written_before)
+    {
+        {
+            NavMeshDiskCache cache(mPath, mSettings);
+            cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections, makeNavMeshData("first"));
+            cache.set(mAgentHalfExtents, TilePosition(1, 0), mRecastMesh, mOffMeshConnections, makeNavMeshData("second"));
+        }
+
+        NavMeshDiskCache cache(mPath, mSettings);
+        EXPECT_EQ(cache.getStats().mTiles, 2u);
+        EXPECT_EQ(toString(cache.get(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections)), "first");
+        EXPECT_EQ(toString(cache.get(mAgentHalfExtents, TilePosition(1, 0), mRecastMesh, mOffMeshConnections)), "second");
+    }
+
+    TEST_F(DetourNavigatorNavMeshDiskCacheTest, reopened_cache_with_other_settings_should_be_empty)
+    {
+        {
+            NavMeshDiskCache cache(mPath, mSettings);
+            cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections, makeNavMeshData("tile"));
+        }
+
+        mSettings.mCellSize = 0.1f;
+        NavMeshDiskCache cache(mPath, mSettings);
+        EXPECT_EQ(cache.getStats().mTiles, 0u);
+        EXPECT_FALSE(cache.get(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections).mValue);
+    }
+
+    TEST_F(DetourNavigatorNavMeshDiskCacheTest, reopened_cache_should_drop_incomplete_record)
+    {
+        {
+            NavMeshDiskCache cache(mPath, mSettings);
+            cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections, makeNavMeshData("first"));
+            cache.set(mAgentHalfExtents, TilePosition(1, 0), mRecastMesh, mOffMeshConnections, makeNavMeshData("second"));
+        }
+
+        boost::filesystem::resize_file(mPath, boost::filesystem::file_size(mPath) - 1);
+
+        {
+            NavMeshDiskCache cache(mPath, mSettings);
+            EXPECT_EQ(cache.getStats().mTiles, 1u);
+            EXPECT_EQ(toString(cache.get(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections)), "first");
+            cache.set(mAgentHalfExtents, TilePosition(1, 0), mRecastMesh, mOffMeshConnections, makeNavMeshData("third"));
+        }
+
+        NavMeshDiskCache cache(mPath, mSettings);
+        EXPECT_EQ(toString(cache.get(mAgentHalfExtents, TilePosition(1, 0), mRecastMesh, mOffMeshConnections)), "third");
+    }
+
+    TEST_F(DetourNavigatorNavMeshDiskCacheTest, set_should_not_exceed_max_file_size)
+    {
+        mSettings.mMaxNavMeshDiskCacheSize = 128;
+        NavMeshDiskCache cache(mPath, mSettings);
+        cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections, makeNavMeshData("tile"));
+        cache.set(mAgentHalfExtents, TilePosition(1, 0), mRecastMesh, mOffMeshConnections,
+                  makeNavMeshData(std::string(128, 'x')));
+
+        EXPECT_EQ(cache.getStats().mTiles, 1u);
+        EXPECT_LE(cache.getStats().mFileSize, 128u);
+        EXPECT_FALSE(cache.get(mAgentHalfExtents, TilePosition(1, 0), mRecastMesh, mOffMeshConnections).mValue);
+    }
+}
@@ -0,0 +1,107 @@
+#include <components/detournavigator/navmeshkey.hpp>
+#include <components/detournavigator/recastmesh.hpp>
+
+#include <LinearMath/btTransform.h>
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+namespace
+{
+    using namespace testing;
+    using namespace DetourNavigator;
+
+    NavMeshKey makeHash(const char* value)
+    {
+        Hash128 hash;
+        hash.add(value, std::strlen(value));
+        return hash.getValue();
+    }
+
+    TEST(DetourNavigatorNavMeshKeyTest, hash_should_match_reference_murmur3_x64_128)
+    {
+        const NavMeshKey empty = makeHash("");
+        EXPECT_EQ(empty.mHigh, 0u);
+        EXPECT_EQ(empty.mLow, 0u);
+
+        const NavMeshKey hello = makeHash("hello");
+        EXPECT_EQ(hello.mHigh, 0xcbd8a7b341bd9b02ull);
+        EXPECT_EQ(hello.mLow, 0x5b1e906a48ae1d19ull);
+        EXPECT_EQ(hello.mSize, 5u);
+
+        const NavMeshKey fox = makeHash("The quick brown fox jumps over the lazy dog");
+        EXPECT_EQ(fox.mHigh, 0xe34bbc7bbc071b6cull);
+        EXPECT_EQ(fox.mLow, 0x7a433ca9c49a9347ull);
+    }
+
+    TEST(DetourNavigatorNavMeshKeyTest, hash_should_not_depend_on_how_data_is_split)
+    {
+        const std::string value = "The quick brown fox jumps over the lazy dog";
+        const NavMeshKey expected = makeHash(value.c_str());
+        for (std::size_t first = 0; first <= value.size(); ++first)
+        {
+            for (std::size_t second = first; second <= value.size(); ++second)
+            {
+                Hash128 hash;
+                hash.add(value.data(), first);
+                hash.add(value.data() + first, second - first);
+                hash.add(value.data() + second, value.size() - second);
+                EXPECT_EQ(hash.getValue(), expected) << first << " " << second;
+            }
+        }
+    }
+
+    TEST(DetourNavigatorNavMeshKeyTest, make_nav_mesh_key_should_hash_key_data)
+    {
+        const std::vector<int> indices {{0, 1, 2}};
+        const std::vector<float> vertices {{0, 0, 0, 1, 0, 0, 1, 1, 0}};
+        const std::vector<AreaType> areaTypes {1, AreaType_ground};
+        const std::vector<RecastMesh::Water> water {1, RecastMesh::Water {1, btTransform::getIdentity()}};
+        const RecastMesh recastMesh {indices, vertices, areaTypes, water, 1};
+        const std::vector<OffMeshConnection> offMeshConnections {1, OffMeshConnection {osg::Vec3f(1, 2, 3), osg::Vec3f()}};
+
+        const std::string data = makeNavMeshKeyData(recastMesh, offMeshConnections);
+        EXPECT_EQ(data.size(), 3 * sizeof(int) + 9 * sizeof(float) + sizeof(AreaType)
+            + sizeof(int) + 12 * sizeof(btScalar) + sizeof(OffMeshConnection));
+        Hash128 hash;
+        hash.add(data.data(), data.size());
+        EXPECT_EQ(makeNavMeshKey(recastMesh, offMeshConnections), hash.getValue());
+    }
+
+    TEST(DetourNavigatorNavMeshKeyTest, make_nav_mesh_key_should_not_depend_on_water_padding)
+    {
+        const std::vector<int> indices {{0, 1, 2}};
+        const std::vector<float> vertices {{0, 0, 0, 1, 0, 0, 1, 1, 0}};
+        const std::vector<AreaType> areaTypes {1, AreaType_ground};
+        const std::vector<OffMeshConnection> offMeshConnections;
+        btTransform transform = btTransform::getIdentity();
+        transform.getOrigin() = btVector3(1, 2, 3);
+
+        const auto makeWater = [&] (unsigned char padding)
+        {
+            std::vector<RecastMesh::Water> result(1);
+            std::memset(static_cast<void*>(result.data()), padding, sizeof(RecastMesh::Water));
+            result.front().mCellSize = 8192;
+            const btMatrix3x3& basis = transform.getBasis();
+            for (int row = 0; row < 3; ++row)
+                for (int column = 0; column < 3; ++column)
+                    result.front().mTransform.getBasis()[row][column] = basis[row][column];
+            for (int i = 0; i < 3; ++i)
+                result.front().mTransform.getOrigin()[i] = transform.getOrigin()[i];
+            return result;
+        };
+
+        std::vector<RecastMesh::Water> zeroPadding = makeWater(0);
+        std::vector<RecastMesh::Water> onesPadding = makeWater(0xff);
+        ASSERT_NE(std::memcmp(static_cast<const void*>(zeroPadding.data()), static_cast<const void*>(onesPadding.data()),
+                              sizeof(RecastMesh::Water)), 0);
+
+        // Moved to keep the padding bytes
+        const RecastMesh first {indices, vertices, areaTypes, std::move(zeroPadding), 1};
+        const RecastMesh second {indices, vertices, areaTypes, std::move(onesPadding), 1};
+
+        EXPECT_EQ(makeNavMeshKey(first, offMeshConnections), makeNavMeshKey(second, offMeshConnections));
+        EXPECT_EQ(makeNavMeshKeyData(first, offMeshConnections), makeNavMeshKeyData(second, offMeshConnections));
+    }
+}
@@ -8,6 +8,12 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+
 namespace DetourNavigator
 {
     static inline bool operator ==(const NavMeshDataRef& lhs, const NavMeshDataRef& rhs)
@@ -35,13 +41,15 @@ namespace
         unsigned char* const mData = reinterpret_cast<unsigned char*>(dtAlloc(1, DT_ALLOC_PERM));
         NavMeshData mNavMeshData {mData, 1};
 
-        const size_t cRecastMeshKeySize = mRecastMesh.getIndices().size() * sizeof(int)
+        const size_t cRecastMeshKeySize = sizeof(NavMeshKey);
+
+        const size_t cRecastMeshWithWaterKeySize = sizeof(NavMeshKey);
+
+        const size_t cRecastMeshKeyDataSize = mRecastMesh.getIndices().size() * sizeof(int)
             + mRecastMesh.getVertices().size() * sizeof(float)
             + mRecastMesh.getAreaTypes().size() * sizeof(AreaType)
-            + mRecastMesh.getWater().size() * sizeof(RecastMesh::Water)
+            + mRecastMesh.getWater().size() * (sizeof(int) + 12 * sizeof(btScalar))
             + mOffMeshConnections.size() * sizeof(OffMeshConnection);
-
-        const size_t cRecastMeshWithWaterKeySize = cRecastMeshKeySize + sizeof(RecastMesh::Water);
     };
 
     TEST_F(DetourNavigatorNavMeshTilesCacheTest, get_for_empty_cache_should_return_empty_value)
@@ -257,8 +265,9 @@ namespace
 
         const std::vector<RecastMesh::Water> water {1, RecastMesh::Water {1, btTransform::getIdentity()}};
         const RecastMesh tooLargeRecastMesh {mIndices, mVertices, mAreaTypes, water, mTrianglesPerChunk};
-        const auto tooLargeData = reinterpret_cast<unsigned char*>(dtAlloc(2, DT_ALLOC_PERM));
-        NavMeshData tooLargeNavMeshData {tooLargeData, 2};
+        const int tooLargeDataSize = static_cast<int>(maxSize - 2 * navMeshKeySize + 1);
+        const auto tooLargeData = reinterpret_cast<unsigned char*>(dtAlloc(tooLargeDataSize, DT_ALLOC_PERM));
+        NavMeshData tooLargeNavMeshData {tooLargeData, tooLargeDataSize};
 
         cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections, std::move(mNavMeshData));
         EXPECT_FALSE(cache.set(mAgentHalfExtents, mTilePosition, tooLargeRecastMesh, mOffMeshConnections,
@@ -341,4 +350,94 @@ namespace
                                std::move(anotherNavMeshData)));
         EXPECT_TRUE(cache.get(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections));
     }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, get_with_verified_keys_should_return_cached_value)
+    {
+        const std::size_t navMeshDataSize = 1;
+        const std::size_t navMeshKeySize = cRecastMeshKeySize;
+        const std::size_t maxSize = navMeshDataSize + 2 * navMeshKeySize + cRecastMeshKeyDataSize;
+        NavMeshTilesCache cache(maxSize, true);
+
+        ASSERT_TRUE(cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections,
+                              std::move(mNavMeshData)));
+        const auto result = cache.get(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections);
+        ASSERT_TRUE(result);
+        EXPECT_EQ(result.get(), (NavMeshDataRef {mData, 1}));
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, set_with_verified_keys_should_count_key_data_size)
+    {
+        const std::size_t navMeshDataSize = 1;
+        const std::size_t navMeshKeySize = cRecastMeshKeySize;
+        const std::size_t maxSize = navMeshDataSize + 2 * navMeshKeySize + cRecastMeshKeyDataSize - 1;
+        NavMeshTilesCache cache(maxSize, true);
+
+        EXPECT_FALSE(cache.set(mAgentHalfExtents, mTilePosition, mRecastMesh, mOffMeshConnections,
+                               std::move(mNavMeshData)));
+    }
+
+    /// Flat grid of quads like a dense tile of exterior terrain
+    std::unique_ptr<RecastMesh> makeDenseRecastMesh(int tile, int size)
+    {
+        std::vector<float> vertices;
+        for (int y = 0; y <= size; ++y)
+            for (int x = 0; x <= size; ++x)
+                vertices.insert(vertices.end(), {float(tile * size + x), float((x * y) % 7), float(y)});
+        std::vector<int> indices;
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                const int first = y * (size + 1) + x;
+                indices.insert(indices.end(), {first, first + 1, first + size + 1});
+                indices.insert(indices.end(), {first + 1, first + size + 2, first + size + 1});
+            }
+        }
+        const std::vector<AreaType> areaTypes(indices.size() / 3, AreaType_ground);
+        return std::unique_ptr<RecastMesh>(new RecastMesh(indices, vertices, areaTypes, {}, 256));
+    }
+
+    template <class Get>
+    void printLookupsPerSecond(const char* name, std::size_t keySize, std::size_t tiles, Get&& get)
+    {
+        const int passes = 20;
+        std::size_t found = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < passes; ++pass)
+            for (std::size_t tile = 0; tile < tiles; ++tile)
+                found += get(tile);
+        const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+        EXPECT_EQ(found, passes * tiles);
+        std::cout << name << ": " << keySize << " bytes of keys per tile, "
+            << passes * tiles / time.count() << " lookups per second" << std::endl;
+    }
+
+    TEST_F(DetourNavigatorNavMeshTilesCacheTest, key_memory_and_lookups_per_second_for_dense_tiles)
+    {
+        const std::size_t tiles = 32;
+        std::vector<std::unique_ptr<RecastMesh>> recastMeshes;
+        for (std::size_t tile = 0; tile < tiles; ++tile)
+            recastMeshes.push_back(makeDenseRecastMesh(static_cast<int>(tile), 64));
+        const std::size_t keyDataSize = makeNavMeshKeyData(*recastMeshes.front(), mOffMeshConnections).size();
+
+        std::map<std::string, std::size_t> stringKeys;
+        for (std::size_t tile = 0; tile < tiles; ++tile)
+            stringKeys.emplace(makeNavMeshKeyData(*recastMeshes[tile], mOffMeshConnections), tile);
+        printLookupsPerSecond("std::string key", 2 * keyDataSize, tiles, [&] (std::size_t tile) {
+            return stringKeys.count(makeNavMeshKeyData(*recastMeshes[tile], mOffMeshConnections));
+        });
+
+        for (const bool verifyKeys : {false, true})
+        {
+            NavMeshTilesCache cache(std::numeric_limits<std::size_t>::max(), verifyKeys);
+            for (std::size_t tile = 0; tile < tiles; ++tile)
+                cache.set(mAgentHalfExtents, mTilePosition, *recastMeshes[tile], mOffMeshConnections,
+                          NavMeshData(reinterpret_cast<unsigned char*>(dtAlloc(1, DT_ALLOC_PERM)), 1));
+            printLookupsPerSecond(verifyKeys ? "NavMeshKey with verification" : "NavMeshKey",
+                2 * sizeof(NavMeshKey) + (verifyKeys ? keyDataSize : 0), tiles, [&] (std::size_t tile) {
+                    return static_cast<std::size_t>(static_cast<bool>(
+                        cache.get(mAgentHalfExtents, mTilePosition, *recastMeshes[tile], mOffMeshConnections)));
+                });
+        }
+    }
 }
@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+#include <components/compiler/context.hpp>
+#include <components/compiler/exception.hpp>
+#include <components/compiler/extensions.hpp>
+#include <components/compiler/extensions0.hpp>
+#include <components/compiler/fileparser.hpp>
+#include <components/compiler/scanner.hpp>
+#include <components/compiler/streamerrorhandler.hpp>
+#include <components/interpreter/context.hpp>
+#include <components/interpreter/installopcodes.hpp>
+#include <components/interpreter/interpreter.hpp>
+#include <components/interpreter/opcodes.hpp>
+#include <components/interpreter/runtime.hpp>
+
+namespace
+{
+    using namespace testing;
+
+    const int opcodeGetTestValue = 0x2000200;
+
+    struct TestCompilerContext : Compiler::Context
+    {
+        bool canDeclareLocals() const override { return true; }
+        char getGlobalType(const std::string&) const override { return ' '; }
+        std::pair<char, bool> getMemberType(const std::string&, const std::string&) const override { return {' ', false}; }
+        bool isId(const std::string&) const override { return false; }
+        bool isJournalId(const std::string&) const override { return false; }
+    };
+
+    /// Only provides local variables, which is all the generic opcodes used by the test scripts need
+    struct TestInterpreterContext : Interpreter::Context
+    {
+        std::vector<Interpreter::Type_Short> mShorts;
+        std::vector<Interpreter::Type_Integer> mLongs;
+        std::vector<Interpreter::Type_Float> mFloats;
+
+        TestInterpreterContext(const Compiler::Locals& locals)
+            : mShorts(locals.get('s').size(), 0)
+            , mLongs(locals.get('l').size(), 0)
+            , mFloats(locals.get('f').size(), 0)
+        {}
+
+        int getLocalShort(int index) const override { return mShorts[index]; }
+        int getLocalLong(int index) const override { return mLongs[index]; }
+        float getLocalFloat(int index) const override { return mFloats[index]; }
+        void setLocalShort(int index, int value) override { mShorts[index] = value; }
+        void setLocalLong(int index, int value) override { mLongs[index] = value; }
+        void setLocalFloat(int index, float value) override { mFloats[index] = value; }
+        void messageBox(const std::string&, const std::vector<std::string>&) override {}
+        void report(const std::string&) override {}
+        bool menuMode() override { return false; }
+        int getGlobalShort(const std::string&) const override { return 0; }
+        int getGlobalLong(const std::string&) const override { return 0; }
+        float getGlobalFloat(const std::string&) const override { return 0; }
+        void setGlobalShort(const std::string&, int) override {}
+        void setGlobalLong(const std::string&, int) override {}
+        void setGlobalFloat(const std::string&, float) override {}
+        std::vector<std::string> getGlobals() const override { return {}; }
+        char getGlobalType(const std::string&) const override { return ' '; }
+        std::string getActionBinding(const std::string&) const override { return {}; }
+        std::string getActorName() const override { return {}; }
+        std::string getNPCRace() const override { return {}; }
+        std::string getNPCClass() const override { return {}; }
+        std::string getNPCFaction() const override { return {}; }
+        std::string getNPCRank() const override { return {}; }
+        std::string getPCName() const override { return {}; }
+        std::string getPCRace() const override { return {}; }
+        std::string getPCClass() const override { return {}; }
+        std::string getPCRank() const override { return {}; }
+        std::string getPCNextRank() const override { return {}; }
+        int getPCBounty() const override { return 0; }
+        std::string getCurrentCellName() const override { return {}; }
+        bool isScriptRunning(const std::string&) const override { return false; }
+        void startScript(const std::string&, const std::string&) override {}
+        void stopScript(const std::string&) override {}
+        float getDistance(const std::string&, const std::string&) const override { return 0; }
+        float getSecondsPassed() const override { return 0; }
+        bool isDisabled(const std::string&) const override { return false; }
+        void enable(const std::string&) override {}
+        void disable(const std::string&) override {}
+        int getMemberShort(const std::string&, const std::string&, bool) const override { return 0; }
+        int getMemberLong(const std::string&, const std::string&, bool) const override { return 0; }
+        float getMemberFloat(const std::string&, const std::string&, bool) const override { return 0; }
+        void setMemberShort(const std::string&, const std::string&, int, bool) override {}
+        void setMemberLong(const std::string&, const std::string&, int, bool) override {}
+        void setMemberFloat(const std::string&, const std::string&, float, bool) override {}
+        std::string getTargetId() const override { return {}; }
+    };
+
+    class OpGetTestValue : public Interpreter::Opcode0
+    {
+        public:
+
+            void execute(Interpreter::Runtime& runtime) override
+            {
+                runtime.push(Interpreter::Type_Integer(3));
+            }
+    };
+
+    struct CompiledScript
+    {
+        std::vector<Interpreter::Type_Code> mCode;
+        Compiler::Locals mLocals;
+    };
+
+    struct InterpreterTest : Test
+    {
+        std::ostringstream mErrors;
+        Compiler::StreamErrorHandler mErrorHandler {mErrors};
+        Compiler::Extensions mExtensions;
+        TestCompilerContext mCompilerContext;
+        Interpreter::Interpreter mInterpreter;
+
+        InterpreterTest()
+        {
+            Compiler::registerExtensions(mExtensions);
+            mExtensions.registerFunction("gettestvalue", 'l', "", opcodeGetTestValue);
+            mCompilerContext.setExtensions(&mExtensions);
+
+            Interpreter::installOpcodes(mInterpreter);
+            mInterpreter.installSegment5(opcodeGetTestValue, new OpGetTestValue);
+        }
+
+        CompiledScript compile(const std::string& source)
+        {
+            Compiler::FileParser parser(mErrorHandler, mCompilerContext);
+            std::istringstream input(source);
+            Compiler::Scanner scanner(mErrorHandler, input, &mExtensions);
+            scanner.scan(parser);
+            EXPECT_TRUE(mErrorHandler.isGood()) << mErrors.str();
+
+            CompiledScript script;
+            parser.getCode(script.mCode);
+            script.mLocals = parser.getLocals();
+            return script;
+        }
+
+        void run(const CompiledScript& script, TestInterpreterContext& context)
+        {
+            mInterpreter.run(&script.mCode[0], static_cast<int>(script.mCode.size()), context);
+        }
+    };
+
+    /// A script without branches, so that every compiled instruction is executed exactly once
+    std::string makeStraightLineScript(int seed, int statements)
+    {
+        std::ostringstream script;
+        script << "begin test_" << seed << "\n"
+            << "short s1\nshort s2\nlong l1\nlong l2\nfloat f1\nfloat f2\n"
+            << "set s1 to " << seed << "\nset l1 to 7\nset f1 to 1.5\n";
+
+        const char* statementsTemplate[] = {
+            "set s2 to s1 + l1 * 2\n",
+            "set l2 to ( l1 - s2 ) / 3\n",
+            "set f2 to f1 * 0.5 + s1\n",
+            "set l1 to l2 + gettestvalue\n",
+            "set f1 to f2 - l2 / 2.0\n",
+            "set s1 to -s2 + 11\n",
+        };
+        const int templates = sizeof(statementsTemplate) / sizeof(statementsTemplate[0]);
+
+        for (int i = 0; i < statements; ++i)
+            script << statementsTemplate[(seed + i) % templates];
+
+        script << "end\n";
+        return script.str();
+    }
+
+    TEST_F(InterpreterTest, should_run_generic_and_installed_opcodes)
+    {
+        const CompiledScript script = compile(
+            "begin test\n"
+            "long value\n"
+            "short counter\n"
+            "float sum\n"
+            "while ( counter < 10 )\n"
+            "    set counter to counter + 1\n"
+            "    set sum to sum + 0.5\n"
+            "endwhile\n"
+            "if ( counter == 10 )\n"
+            "    set value to gettestvalue * counter\n"
+            "endif\n"
+            "end\n");
+
+        TestInterpreterContext context(script.mLocals);
+        run(script, context);
+
+        EXPECT_EQ(context.mShorts[0], 10);
+        EXPECT_EQ(context.mLongs[0], 30);
+        EXPECT_FLOAT_EQ(context.mFloats[0], 5.f);
+    }
+
+    TEST_F(InterpreterTest, should_throw_for_unknown_opcode)
+    {
+        const CompiledScript script = compile("begin test\nlong value\nset value to gettestvalue\nend\n");
+
+        Interpreter::Interpreter interpreter;
+        Interpreter::installOpcodes(interpreter);
+        TestInterpreterContext context(script.mLocals);
+        EXPECT_THROW(interpreter.run(&script.mCode[0], static_cast<int>(script.mCode.size()), context), std::runtime_error);
+    }
+
+    TEST_F(InterpreterTest, instructions_per_second_for_script_corpus)
+    {
+        const int scriptCount = 100;
+        std::vector<CompiledScript> scripts;
+        std::vector<TestInterpreterContext> contexts;
+        std::size_t instructionsPerRound = 0;
+        for (int i = 0; i < scriptCount; ++i)
+        {
+            scripts.push_back(compile(makeStraightLineScript(i, 200)));
+            contexts.emplace_back(scripts.back().mLocals);
+            // The first word of the code holds the number of instructions
+            instructionsPerRound += scripts.back().mCode[0];
+        }
+
+        const int rounds = 200;
+        const auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round)
+            for (int i = 0; i < scriptCount; ++i)
+                run(scripts[i], contexts[i]);
+        const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+
+        std::cout << "Interpreter::run: " << instructionsPerRound * rounds / time.count() << " instructions/s, "
+            << scriptCount * rounds / time.count() << " scripts/s" << std::endl;
+    }
+}
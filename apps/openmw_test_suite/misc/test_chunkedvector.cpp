@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+
+#include <components/misc/chunkedvector.hpp>
+
+namespace
+{
+    using namespace testing;
+    using namespace Misc;
+
+    TEST(MiscChunkedVectorTest, push_back_should_keep_order_and_addresses_of_elements)
+    {
+        ChunkedVector<int, 2, 8> vector;
+        std::vector<const int*> addresses;
+        for (int i = 0; i < 100; ++i)
+        {
+            vector.push_back(i);
+            addresses.push_back(&vector.back());
+        }
+
+        ASSERT_EQ(vector.size(), 100u);
+        int expected = 0;
+        for (const int& value : vector)
+        {
+            EXPECT_EQ(value, expected);
+            EXPECT_EQ(&value, addresses[expected]);
+            ++expected;
+        }
+        EXPECT_EQ(expected, 100);
+    }
+
+    TEST(MiscChunkedVectorTest, iterator_should_be_bidirectional)
+    {
+        ChunkedVector<int, 2, 2> vector;
+        for (int i = 0; i < 5; ++i)
+            vector.push_back(i);
+
+        ChunkedVector<int, 2, 2>::iterator iter = vector.end();
+        for (int i = 4; i >= 0; --i)
+            EXPECT_EQ(*--iter, i);
+        EXPECT_TRUE(iter == vector.begin());
+        EXPECT_EQ(vector.front(), 0);
+        EXPECT_EQ(vector.back(), 4);
+    }
+
+    TEST(MiscChunkedVectorTest, erase_should_return_iterator_to_next_element)
+    {
+        ChunkedVector<int, 2, 2> vector;
+        for (int i = 0; i < 6; ++i)
+            vector.push_back(i);
+
+        for (ChunkedVector<int, 2, 2>::iterator iter = vector.begin(); iter != vector.end();)
+        {
+            if (*iter == 1 || *iter == 2 || *iter == 3 || *iter == 5)
+                iter = vector.erase(iter);
+            else
+                ++iter;
+        }
+
+        EXPECT_EQ(std::vector<int>(vector.begin(), vector.end()), std::vector<int>({0, 4}));
+        EXPECT_EQ(vector.size(), 2u);
+
+        vector.push_back(6);
+        EXPECT_EQ(std::vector<int>(vector.begin(), vector.end()), std::vector<int>({0, 4, 6}));
+        EXPECT_EQ(*--vector.end(), 6);
+    }
+
+    TEST(MiscChunkedVectorTest, erase_only_element_of_last_chunk_should_return_end)
+    {
+        ChunkedVector<int> vector;
+        for (int i = 0; i < 9; ++i)
+            vector.push_back(i);
+
+        ChunkedVector<int>::iterator iter = vector.begin();
+        std::advance(iter, 8);
+        const ChunkedVector<int>::iterator next = vector.erase(iter);
+        EXPECT_TRUE(next == vector.end());
+        EXPECT_EQ(vector.size(), 8u);
+        EXPECT_EQ(vector.back(), 7);
+    }
+
+    TEST(MiscChunkedVectorTest, erase_while_iterating_should_visit_every_element)
+    {
+        ChunkedVector<int> vector;
+        for (int i = 0; i < 9; ++i)
+            vector.push_back(i % 2 == 0 ? 1 : 0);
+
+        // Like CellRefList::remove
+        for (ChunkedVector<int>::iterator iter = vector.begin(); iter != vector.end();)
+        {
+            if (*iter == 1)
+                iter = vector.erase(iter);
+            else
+                ++iter;
+        }
+
+        EXPECT_EQ(std::vector<int>(vector.begin(), vector.end()), std::vector<int>(4, 0));
+    }
+
+    TEST(MiscChunkedVectorTest, copy_should_be_independent)
+    {
+        ChunkedVector<std::string> vector;
+        vector.push_back("a");
+        ChunkedVector<std::string> copy = vector;
+        copy.push_back("b");
+        copy.front() = "c";
+
+        EXPECT_EQ(std::vector<std::string>(vector.begin(), vector.end()), std::vector<std::string>({"a"}));
+        EXPECT_EQ(std::vector<std::string>(copy.begin(), copy.end()), std::vector<std::string>({"c", "b"}));
+    }
+
+    /// About the size of a MWWorld::LiveCellRef
+    struct Ref
+    {
+        int mRefNum;
+        std::string mRefId;
+        float mPosition[6];
+        int mCount;
+        char mOtherData[320];
+    };
+
+    template <class List>
+    struct Cell
+    {
+        std::vector<List> mLists;
+        std::vector<Ref*> mMergedRefs;
+    };
+
+    /// Loads a cell with 4000 references of 21 types in the mixed order of a cell record, allocating the other data
+    /// of the cell in between like the content file loader would, and lists them like CellStore::updateMergedRefs.
+    template <class List>
+    void loadCell(Cell<List>& cell, std::vector<std::unique_ptr<std::string>>& otherData)
+    {
+        const int refs = 4000;
+        const int types = 21;
+        std::minstd_rand random(13);
+        std::uniform_int_distribution<int> type(0, types - 1);
+        std::uniform_int_distribution<int> otherSize(16, 256);
+
+        cell.mLists.resize(types);
+        for (int i = 0; i < refs; ++i)
+        {
+            Ref ref;
+            ref.mRefNum = i;
+            ref.mRefId = "reference_id_" + std::to_string(i);
+            ref.mCount = 1;
+            for (float& position : ref.mPosition)
+                position = static_cast<float>(i);
+            cell.mLists[type(random)].push_back(ref);
+            otherData.emplace_back(new std::string(otherSize(random), 'x'));
+        }
+
+        for (List& list : cell.mLists)
+            for (Ref& ref : list)
+                cell.mMergedRefs.push_back(&ref);
+    }
+
+    template <class List>
+    double visitRefsPerSecond(const char* name)
+    {
+        std::vector<std::unique_ptr<std::string>> otherData;
+        Cell<List> cell;
+        loadCell(cell, otherData);
+
+        const int passes = 2000;
+        float checksum = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < passes; ++pass)
+        {
+            // Like CellStore::forEach, and CellStore::forEachType for every type
+            for (const Ref* ref : cell.mMergedRefs)
+                if (ref->mCount > 0)
+                    checksum += ref->mPosition[pass % 3];
+            for (const List& list : cell.mLists)
+                for (const Ref& ref : list)
+                    if (ref.mCount > 0)
+                        checksum += ref.mPosition[pass % 3];
+        }
+        const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+        const double result = 2.0 * cell.mMergedRefs.size() * passes / time.count();
+        std::cout << name << ": " << result << " references visited per second, "
+            << time.count() / passes * 1000 << " ms per pass (checksum " << checksum << ")" << std::endl;
+        return result;
+    }
+
+    TEST(MiscChunkedVectorTest, references_of_dense_cell_visited_per_second)
+    {
+        visitRefsPerSecond<std::list<Ref>>("std::list");
+        visitRefsPerSecond<ChunkedVector<Ref>>("Misc::ChunkedVector");
+    }
+}
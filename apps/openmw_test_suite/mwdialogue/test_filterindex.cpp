@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <components/esm/loaddial.hpp>
+
+#include "apps/openmw/mwdialogue/filterindex.hpp"
+
+namespace
+{
+    using namespace testing;
+    using namespace MWDialogue;
+
+    struct MWDialogueFilterIndexTest : Test
+    {
+        ESM::Dialogue mDialogue;
+        FilterIndex mIndex;
+
+        ESM::DialInfo& addInfo(const std::string& id)
+        {
+            ESM::DialInfo info;
+            info.blank();
+            info.mId = id;
+            mDialogue.mInfo.push_back(info);
+            return mDialogue.mInfo.back();
+        }
+
+        static FilterIndex::Actor makeNpc(const std::string& id, const std::string& race, const std::string& className,
+            const std::string& faction)
+        {
+            FilterIndex::Actor actor;
+            actor.mIsCreature = false;
+            actor.mId = id;
+            actor.mRace = race;
+            actor.mClass = className;
+            actor.mFaction = faction;
+            return actor;
+        }
+
+        std::vector<std::string> getCandidateIds(const FilterIndex::Actor& actor) const
+        {
+            std::vector<const FilterIndex::Info*> candidates;
+            EXPECT_TRUE(mIndex.getCandidates(mDialogue, actor, candidates));
+            std::vector<std::string> result;
+            for (const FilterIndex::Info* candidate : candidates)
+                result.push_back(candidate->mInfo->mId);
+            return result;
+        }
+    };
+
+    TEST_F(MWDialogueFilterIndexTest, get_candidates_for_not_indexed_dialogue_should_return_false)
+    {
+        std::vector<const FilterIndex::Info*> candidates;
+        EXPECT_FALSE(mIndex.getCandidates(mDialogue, makeNpc("fargoth", "wood elf", "", ""), candidates));
+        EXPECT_TRUE(candidates.empty());
+    }
+
+    TEST_F(MWDialogueFilterIndexTest, npc_should_get_infos_matching_any_of_its_static_properties_in_dialogue_order)
+    {
+        addInfo("any");
+        addInfo("actor").mActor = "Fargoth";
+        addInfo("other actor").mActor = "Caius Cosades";
+        addInfo("race").mRace = "Wood Elf";
+        addInfo("other race").mRace = "Dark Elf";
+        addInfo("class").mClass = "Commoner";
+        addInfo("faction").mFaction = "Imperial Cult";
+        addInfo("other faction").mFaction = "Mages Guild";
+        ESM::DialInfo& factionLess = addInfo("faction less");
+        factionLess.mFaction = "FFFF";
+        factionLess.mFactionLess = true;
+        mIndex.add(mDialogue);
+
+        EXPECT_EQ(mIndex.getNumInfos(), 9u);
+        const std::vector<std::string> expected {"any", "actor", "race", "class", "faction", "faction less"};
+        EXPECT_EQ(getCandidateIds(makeNpc("fargoth", "wood elf", "commoner", "imperial cult")), expected);
+    }
+
+    TEST_F(MWDialogueFilterIndexTest, creature_should_get_only_infos_for_its_id)
+    {
+        addInfo("any");
+        addInfo("actor").mActor = "mudcrab_unique";
+        addInfo("race").mRace = "Wood Elf";
+        mIndex.add(mDialogue);
+
+        FilterIndex::Actor creature = makeNpc("mudcrab_unique", "", "", "");
+        creature.mIsCreature = true;
+        EXPECT_EQ(getCandidateIds(creature), std::vector<std::string> {"actor"});
+    }
+
+    TEST_F(MWDialogueFilterIndexTest, info_should_be_bucketed_by_its_most_specific_property)
+    {
+        ESM::DialInfo& info = addInfo("actor and race");
+        info.mActor = "Fargoth";
+        info.mRace = "Dark Elf";
+        mIndex.add(mDialogue);
+
+        EXPECT_EQ(getCandidateIds(makeNpc("fargoth", "wood elf", "", "")), std::vector<std::string> {"actor and race"});
+        EXPECT_TRUE(getCandidateIds(makeNpc("dram bero", "dark elf", "", "")).empty());
+    }
+
+    TEST_F(MWDialogueFilterIndexTest, select_structs_should_be_decoded_when_indexed)
+    {
+        ESM::DialInfo::SelectStruct select;
+        select.mSelectRule = "02sX2Random100";
+        select.mValue.setType(ESM::VT_Int);
+        select.mValue.setInteger(50);
+        addInfo("global").mSelects.push_back(select);
+        mIndex.add(mDialogue);
+
+        std::vector<const FilterIndex::Info*> candidates;
+        ASSERT_TRUE(mIndex.getCandidates(mDialogue, makeNpc("fargoth", "", "", ""), candidates));
+        ASSERT_EQ(candidates.size(), 1u);
+        ASSERT_EQ(candidates[0]->mSelects.size(), 1u);
+        const SelectWrapper& wrapper = candidates[0]->mSelects[0];
+        EXPECT_EQ(wrapper.getFunction(), SelectWrapper::Function_Global);
+        EXPECT_EQ(wrapper.getName(), "random100");
+        EXPECT_TRUE(wrapper.selectCompare(51));
+        EXPECT_FALSE(wrapper.selectCompare(50));
+    }
+}
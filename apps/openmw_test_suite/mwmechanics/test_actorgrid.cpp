@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "apps/openmw/mwmechanics/actorgrid.hpp"
+
+namespace
+{
+    using namespace testing;
+
+    std::vector<osg::Vec3f> makePositions(std::size_t count, float extent, unsigned seed)
+    {
+        std::minstd_rand random(seed);
+        std::uniform_real_distribution<float> horizontal(-extent / 2, extent / 2);
+        std::uniform_real_distribution<float> vertical(-500.f, 500.f);
+        std::vector<osg::Vec3f> result;
+        for (std::size_t i = 0; i < count; ++i)
+            result.emplace_back(horizontal(random), horizontal(random), vertical(random));
+        return result;
+    }
+
+    MWMechanics::ActorGrid<std::size_t> makeGrid(const std::vector<osg::Vec3f>& positions)
+    {
+        MWMechanics::ActorGrid<std::size_t> grid(4096.f);
+        for (std::size_t i = 0; i < positions.size(); ++i)
+            grid.add(positions[i], i);
+        grid.build();
+        return grid;
+    }
+
+    std::vector<std::size_t> findInRange(const MWMechanics::ActorGrid<std::size_t>& grid,
+        const osg::Vec3f& position, float radius)
+    {
+        std::vector<std::size_t> result;
+        grid.forEachInRange(position, radius, [&] (std::size_t index) { result.push_back(index); return true; });
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::vector<std::size_t> findInRangeByScan(const std::vector<osg::Vec3f>& positions,
+        const osg::Vec3f& position, float radius)
+    {
+        std::vector<std::size_t> result;
+        for (std::size_t i = 0; i < positions.size(); ++i)
+            if ((positions[i] - position).length2() <= radius * radius)
+                result.push_back(i);
+        return result;
+    }
+
+    TEST(ActorGridTest, for_each_in_range_should_find_same_actors_as_scan)
+    {
+        const std::vector<osg::Vec3f> positions = makePositions(500, 40000.f, 42);
+        const MWMechanics::ActorGrid<std::size_t> grid = makeGrid(positions);
+
+        for (float radius : {0.f, 100.f, 1000.f, 4096.f, 7168.f, 50000.f})
+            for (const osg::Vec3f& position : makePositions(50, 44000.f, 7))
+                EXPECT_EQ(findInRange(grid, position, radius), findInRangeByScan(positions, position, radius))
+                    << "radius " << radius;
+    }
+
+    TEST(ActorGridTest, for_each_in_range_should_handle_negative_and_boundary_coordinates)
+    {
+        const std::vector<osg::Vec3f> positions = {
+            osg::Vec3f(0, 0, 0), osg::Vec3f(-1, -1, 0), osg::Vec3f(4096, 0, 0), osg::Vec3f(-4096, 0, 0),
+            osg::Vec3f(-4097, 4095, 0), osg::Vec3f(1e6f, -1e6f, 0),
+        };
+        const MWMechanics::ActorGrid<std::size_t> grid = makeGrid(positions);
+
+        EXPECT_EQ(findInRange(grid, osg::Vec3f(0, 0, 0), 1.5f), (std::vector<std::size_t> {0, 1}));
+        EXPECT_EQ(findInRange(grid, osg::Vec3f(-4096, 0, 0), 0.f), (std::vector<std::size_t> {3}));
+        EXPECT_EQ(findInRange(grid, osg::Vec3f(1e6f, -1e6f, 0), 10.f), (std::vector<std::size_t> {5}));
+        EXPECT_EQ(findInRange(grid, osg::Vec3f(-4097, 4095, 100), 99.f), (std::vector<std::size_t> {}));
+    }
+
+    TEST(ActorGridTest, for_each_in_range_should_stop_when_function_returns_false)
+    {
+        const MWMechanics::ActorGrid<std::size_t> grid = makeGrid(makePositions(100, 1000.f, 1));
+
+        std::size_t calls = 0;
+        EXPECT_TRUE(grid.forEachInRange(osg::Vec3f(), 5000.f, [&] (std::size_t) { ++calls; return false; }));
+        EXPECT_EQ(calls, 1u);
+        EXPECT_FALSE(grid.forEachInRange(osg::Vec3f(), 5000.f, [&] (std::size_t) { return true; }));
+    }
+
+    TEST(ActorGridTest, moving_grid_should_find_actors_moved_within_margin_without_rebuild)
+    {
+        std::vector<osg::Vec3f> positions = {osg::Vec3f(0, 0, 0), osg::Vec3f(5000, 0, 0)};
+        MWMechanics::MovingActorGrid<std::size_t> grid(4096.f, 1024.f);
+        for (std::size_t i = 0; i < positions.size(); ++i)
+            grid.add(positions[i], i);
+        grid.build();
+        const auto getPosition = [&] (std::size_t index) { return positions[index]; };
+
+        positions[0] = osg::Vec3f(400, 300, 0);
+
+        ASSERT_FALSE(grid.isDirty());
+        std::vector<std::size_t> found;
+        grid.forEachInRange(osg::Vec3f(400, 300, 0), 10.f, getPosition,
+            [&] (std::size_t index) { found.push_back(index); return true; });
+        EXPECT_EQ(found, std::vector<std::size_t> {0});
+        found.clear();
+        grid.forEachInRange(osg::Vec3f(0, 0, 0), 10.f, getPosition,
+            [&] (std::size_t index) { found.push_back(index); return true; });
+        EXPECT_EQ(found, std::vector<std::size_t> {});
+    }
+
+    TEST(ActorGridTest, moving_grid_should_find_actor_teleported_beyond_margin_after_rebuild)
+    {
+        std::vector<osg::Vec3f> positions = {osg::Vec3f(0, 0, 0), osg::Vec3f(5000, 0, 0)};
+        MWMechanics::MovingActorGrid<std::size_t> grid(4096.f, 1024.f);
+        const auto build = [&]
+        {
+            grid.clear();
+            for (std::size_t i = 0; i < positions.size(); ++i)
+                grid.add(positions[i], i);
+            grid.build();
+        };
+        build();
+        const auto getPosition = [&] (std::size_t index) { return positions[index]; };
+        const auto findInRange = [&] (const osg::Vec3f& position, float radius)
+        {
+            if (grid.isDirty())
+                build();
+            std::vector<std::size_t> result;
+            grid.forEachInRange(position, radius, getPosition,
+                [&] (std::size_t index) { result.push_back(index); return true; });
+            std::sort(result.begin(), result.end());
+            return result;
+        };
+
+        const osg::Vec3f oldPosition = positions[0];
+        positions[0] = osg::Vec3f(300, 0, 0);
+        grid.moved(oldPosition, positions[0]);
+        EXPECT_FALSE(grid.isDirty());
+        EXPECT_EQ(findInRange(osg::Vec3f(300, 0, 0), 10.f), std::vector<std::size_t> {0});
+        EXPECT_EQ(findInRange(osg::Vec3f(0, 0, 0), 10.f), std::vector<std::size_t> {});
+
+        positions[0] = osg::Vec3f(4900, 0, 0);
+        grid.moved(osg::Vec3f(300, 0, 0), positions[0]);
+        EXPECT_TRUE(grid.isDirty());
+        EXPECT_EQ(findInRange(osg::Vec3f(4900, 0, 0), 150.f), (std::vector<std::size_t> {0, 1}));
+        EXPECT_FALSE(grid.isDirty());
+    }
+
+    /// Simulates the combat engagement and head tracking passes of MWMechanics::Actors, where every actor
+    /// looks for the actors in range, for a growing number of actors spread over the 3x3 loaded exterior cells.
+    TEST(ActorGridTest, pairwise_range_queries_scaling)
+    {
+        for (float range : {7168.f /* AI processing range */, 400.f /* fMaxHeadTrackDistance */})
+        {
+            for (std::size_t count : {50, 100, 200, 400, 800})
+            {
+                const std::vector<osg::Vec3f> positions = makePositions(count, 3 * 8192.f, 3);
+
+                auto start = std::chrono::steady_clock::now();
+                std::size_t scanPairs = 0;
+                for (const osg::Vec3f& position : positions)
+                    for (const osg::Vec3f& other : positions)
+                        scanPairs += (other - position).length2() <= range * range;
+                const std::chrono::duration<double, std::milli> scanTime = std::chrono::steady_clock::now() - start;
+
+                start = std::chrono::steady_clock::now();
+                const MWMechanics::ActorGrid<std::size_t> grid = makeGrid(positions);
+                std::size_t gridPairs = 0;
+                for (const osg::Vec3f& position : positions)
+                    grid.forEachInRange(position, range, [&] (std::size_t) { ++gridPairs; return true; });
+                const std::chrono::duration<double, std::milli> gridTime = std::chrono::steady_clock::now() - start;
+
+                ASSERT_EQ(gridPairs, scanPairs);
+                std::cout << count << " actors, range " << range << ": " << count * count << " pairs scanned in "
+                    << scanTime.count() << " ms, " << gridPairs << " pairs found by grid in "
+                    << gridTime.count() << " ms (including build)" << std::endl;
+            }
+        }
+    }
+}
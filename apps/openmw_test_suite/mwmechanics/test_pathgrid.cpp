@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "apps/openmw/mwmechanics/pathgrid.hpp"
+
+namespace
+{
+    using namespace testing;
+    using namespace MWMechanics;
+
+    /// Square grid of points with edges in both directions between the neighbours, like in a large interior
+    ESM::Pathgrid makeGridPathgrid(int size, float edgeShare, unsigned seed)
+    {
+        std::minstd_rand random(seed);
+        std::uniform_int_distribution<int> offset(-32, 32);
+        std::uniform_real_distribution<float> share(0, 1);
+        ESM::Pathgrid result;
+        for (int y = 0; y < size; ++y)
+            for (int x = 0; x < size; ++x)
+                result.mPoints.emplace_back(x * 256 + offset(random), y * 256 + offset(random), offset(random));
+        const auto connect = [&] (int v0, int v1)
+        {
+            if (share(random) > edgeShare)
+                return;
+            result.mEdges.push_back(ESM::Pathgrid::Edge {v0, v1});
+            result.mEdges.push_back(ESM::Pathgrid::Edge {v1, v0});
+        };
+        for (int y = 0; y < size; ++y)
+            for (int x = 0; x < size; ++x)
+            {
+                if (x + 1 < size)
+                    connect(y * size + x, y * size + x + 1);
+                if (y + 1 < size)
+                    connect(y * size + x, (y + 1) * size + x);
+            }
+        return result;
+    }
+
+    std::vector<int> toIndexes(const ESM::Pathgrid& pathgrid, const std::deque<ESM::Pathgrid::Point>& path)
+    {
+        std::vector<int> result;
+        for (const ESM::Pathgrid::Point& point : path)
+            for (std::size_t i = 0; i < pathgrid.mPoints.size(); ++i)
+                if (pathgrid.mPoints[i].mX == point.mX && pathgrid.mPoints[i].mY == point.mY
+                        && pathgrid.mPoints[i].mZ == point.mZ)
+                    result.push_back(static_cast<int>(i));
+        return result;
+    }
+
+    TEST(MWMechanicsPathgridGraphTest, a_star_search_should_return_points_from_start_to_end)
+    {
+        const ESM::Pathgrid pathgrid = makeGridPathgrid(3, 1, 42);
+        const PathgridGraph graph(&pathgrid);
+
+        const std::vector<int> path = toIndexes(pathgrid, graph.aStarSearch(0, 8));
+
+        ASSERT_EQ(path.size(), 5u);
+        EXPECT_EQ(path.front(), 0);
+        EXPECT_EQ(path.back(), 8);
+        for (std::size_t i = 1; i < path.size(); ++i)
+            EXPECT_TRUE(std::abs(path[i] - path[i - 1]) == 1 || std::abs(path[i] - path[i - 1]) == 3);
+    }
+
+    TEST(MWMechanicsPathgridGraphTest, a_star_search_for_not_connected_points_should_return_empty_path)
+    {
+        ESM::Pathgrid pathgrid = makeGridPathgrid(3, 1, 42);
+        pathgrid.mPoints.emplace_back(10000, 10000, 0);
+        const PathgridGraph graph(&pathgrid);
+
+        EXPECT_TRUE(graph.aStarSearch(0, 9).empty());
+        EXPECT_TRUE(graph.aStarSearch(0, 9).empty());
+    }
+
+    TEST(MWMechanicsPathgridGraphTest, a_star_search_with_cache_should_return_same_paths_as_without)
+    {
+        const ESM::Pathgrid pathgrid = makeGridPathgrid(12, 0.8f, 13);
+        const PathgridGraph uncached(&pathgrid, 0);
+        const PathgridGraph cached(&pathgrid, 16);
+        std::minstd_rand random(7);
+        std::uniform_int_distribution<int> point(0, static_cast<int>(pathgrid.mPoints.size()) - 1);
+
+        for (int i = 0; i < 200; ++i)
+        {
+            const int start = point(random) % 24;
+            const int end = point(random);
+            const auto expected = toIndexes(pathgrid, uncached.aStarSearch(start, end));
+            EXPECT_EQ(toIndexes(pathgrid, cached.aStarSearch(start, end)), expected) << start << " " << end;
+            EXPECT_EQ(toIndexes(pathgrid, cached.aStarSearch(start, end)), expected) << start << " " << end;
+        }
+    }
+
+    struct WanderActor
+    {
+        int mCurrent;
+        std::vector<int> mAllowedNodes;
+    };
+
+    /// Each actor walks between random pathgrid points within its wander distance, like AiWander does
+    double wanderPathsPerSecond(const ESM::Pathgrid& pathgrid, int size, std::size_t maxCachedPaths, const char* name)
+    {
+        const int actors = 64;
+        const int wanderDistance = 1;
+        const int pathsPerActor = 500;
+        std::minstd_rand random(99);
+        std::uniform_int_distribution<int> home(0, size - 1);
+
+        std::vector<WanderActor> wanderActors(actors);
+        for (WanderActor& actor : wanderActors)
+        {
+            const int homeX = home(random);
+            const int homeY = home(random);
+            for (int y = std::max(0, homeY - wanderDistance); y <= std::min(size - 1, homeY + wanderDistance); ++y)
+                for (int x = std::max(0, homeX - wanderDistance); x <= std::min(size - 1, homeX + wanderDistance); ++x)
+                    actor.mAllowedNodes.push_back(y * size + x);
+            actor.mCurrent = homeY * size + homeX;
+        }
+
+        const PathgridGraph graph(&pathgrid, maxCachedPaths);
+        std::size_t checksum = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < pathsPerActor; ++i)
+            for (WanderActor& actor : wanderActors)
+            {
+                const int destination = actor.mAllowedNodes[random() % actor.mAllowedNodes.size()];
+                if (destination == actor.mCurrent)
+                    continue;
+                checksum += graph.aStarSearch(actor.mCurrent, destination).size();
+                actor.mCurrent = destination;
+            }
+        const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+        const double result = double(actors) * pathsPerActor / time.count();
+        std::cout << name << ": " << result << " paths per second for " << actors << " wandering actors (checksum "
+            << checksum << ")" << std::endl;
+        return result;
+    }
+
+    TEST(MWMechanicsPathgridGraphTest, wander_paths_per_second_in_large_interior)
+    {
+        const int size = 40;
+        const ESM::Pathgrid pathgrid = makeGridPathgrid(size, 0.9f, 1);
+        wanderPathsPerSecond(pathgrid, size, 0, "without cache");
+        wanderPathsPerSecond(pathgrid, size, 4096, "with cache");
+    }
+}
@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <components/compiler/locals.hpp>
+
+#include "apps/openmw/mwscript/localindexcache.hpp"
+
+namespace
+{
+    using namespace testing;
+
+    TEST(LocalIndexCacheTest, search_should_find_inserted_index_ignoring_case_of_script_id)
+    {
+        MWScript::LocalIndexCache cache;
+        cache.insert("BM_Script", "counter", 's', 2);
+
+        int index = -2;
+        EXPECT_TRUE(cache.search("bm_script", "counter", 's', index));
+        EXPECT_EQ(index, 2);
+        EXPECT_TRUE(cache.search("BM_SCRIPT", "counter", 's', index));
+        EXPECT_EQ(index, 2);
+        EXPECT_EQ(cache.getHits(), 2u);
+    }
+
+    TEST(LocalIndexCacheTest, search_should_tell_types_and_scripts_apart)
+    {
+        MWScript::LocalIndexCache cache;
+        cache.insert("script", "state", 's', 0);
+        cache.insert("script", "state", 'l', 1);
+        cache.insert("other", "state", 's', 3);
+
+        int index = -2;
+        EXPECT_TRUE(cache.search("script", "state", 'l', index));
+        EXPECT_EQ(index, 1);
+        EXPECT_TRUE(cache.search("other", "state", 's', index));
+        EXPECT_EQ(index, 3);
+        EXPECT_FALSE(cache.search("script", "state", 'f', index));
+        EXPECT_FALSE(cache.search("scrip", "tstate", 's', index));
+    }
+
+    TEST(LocalIndexCacheTest, search_should_remember_missing_variables)
+    {
+        MWScript::LocalIndexCache cache;
+        cache.insert("script", "missing", 'f', -1);
+
+        int index = 0;
+        EXPECT_TRUE(cache.search("script", "missing", 'f', index));
+        EXPECT_EQ(index, -1);
+    }
+
+    TEST(LocalIndexCacheTest, insert_should_keep_entries_while_growing)
+    {
+        MWScript::LocalIndexCache cache;
+        for (int i = 0; i < 1000; ++i)
+            cache.insert("script" + std::to_string(i % 10), "var" + std::to_string(i), 's', i);
+
+        EXPECT_EQ(cache.getSize(), 1000u);
+        for (int i = 0; i < 1000; ++i)
+        {
+            int index = -2;
+            ASSERT_TRUE(cache.search("Script" + std::to_string(i % 10), "var" + std::to_string(i), 's', index));
+            EXPECT_EQ(index, i);
+        }
+    }
+
+    TEST(LocalIndexCacheTest, get_index_should_not_depend_on_case_of_first_access)
+    {
+        Compiler::Locals locals;
+        locals.declare('s', "state");
+        locals.declare('s', "counter");
+
+        for (const std::string& first : {"Counter", "counter"})
+        {
+            MWScript::LocalIndexCache cache;
+            std::size_t searches = 0;
+            const auto getLocals = [&] () -> const Compiler::Locals& { ++searches; return locals; };
+
+            EXPECT_EQ(cache.getIndex("script", first, 's', getLocals), 1) << first;
+            EXPECT_EQ(cache.getIndex("script", "COUNTER", 's', getLocals), 1) << first;
+            EXPECT_EQ(cache.getIndex("script", "counter", 's', getLocals), 1) << first;
+            EXPECT_EQ(cache.getIndex("script", "Missing", 's', getLocals), -1) << first;
+            EXPECT_EQ(cache.getIndex("script", "missing", 's', getLocals), -1) << first;
+            EXPECT_EQ(searches, 2u) << first;
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <components/files/collections.hpp>
+
+#include "apps/openmw/mwscript/scriptcache.hpp"
+
+namespace
+{
+    using namespace testing;
+
+    struct ScriptCacheTest : Test
+    {
+        const std::string mPath = (boost::filesystem::temp_directory_path() / "openmw_test_scripts.cache").string();
+        Files::Collections mCollections;
+
+        ScriptCacheTest()
+        {
+            boost::filesystem::remove(mPath);
+        }
+
+        ~ScriptCacheTest()
+        {
+            boost::filesystem::remove(mPath);
+        }
+
+        MWWorld::ContentFileKey makeKey(const std::vector<std::string>& contentFiles = {},
+            const std::string& engineVersion = "OpenMW version 0.45.0")
+        {
+            return MWWorld::ContentFileKey(mCollections, contentFiles, engineVersion);
+        }
+
+        static MWScript::ScriptCache::CompiledScript makeScript()
+        {
+            MWScript::ScriptCache::CompiledScript script;
+            script.first = {3, 0, 0, 0, 0x12345678, 0xc8000001, 0x80000000};
+            script.second.declare('s', "counter");
+            script.second.declare('l', "state");
+            script.second.declare('f', "timer");
+            script.second.declare('f', "speed");
+            return script;
+        }
+    };
+
+    TEST_F(ScriptCacheTest, get_should_return_script_written_before)
+    {
+        const MWScript::ScriptCache::CompiledScript script = makeScript();
+        {
+            MWScript::ScriptCache cache(mPath, makeKey());
+            cache.add("test", "begin test\nend", script);
+            cache.write();
+        }
+
+        MWScript::ScriptCache cache(mPath, makeKey());
+        MWScript::ScriptCache::CompiledScript result;
+        ASSERT_TRUE(cache.get("test", "begin test\nend", result));
+        const Compiler::Locals& locals = result.second;
+        EXPECT_EQ(result.first, script.first);
+        EXPECT_EQ(locals.get('s'), std::vector<std::string>({"counter"}));
+        EXPECT_EQ(locals.get('l'), std::vector<std::string>({"state"}));
+        EXPECT_EQ(locals.get('f'), std::vector<std::string>({"timer", "speed"}));
+    }
+
+    TEST_F(ScriptCacheTest, get_should_ignore_script_with_changed_text)
+    {
+        {
+            MWScript::ScriptCache cache(mPath, makeKey());
+            cache.add("test", "begin test\nend", makeScript());
+            cache.write();
+        }
+
+        MWScript::ScriptCache cache(mPath, makeKey());
+        MWScript::ScriptCache::CompiledScript result;
+        EXPECT_FALSE(cache.get("test", "begin test\nshort a\nend", result));
+        EXPECT_FALSE(cache.get("other", "begin test\nend", result));
+    }
+
+    TEST_F(ScriptCacheTest, cache_should_be_dropped_for_other_content_files)
+    {
+        {
+            MWScript::ScriptCache cache(mPath, makeKey());
+            cache.add("test", "begin test\nend", makeScript());
+            cache.write();
+        }
+
+        MWScript::ScriptCache cache(mPath, makeKey({"missing.esm"}));
+        MWScript::ScriptCache::CompiledScript result;
+        EXPECT_FALSE(cache.get("test", "begin test\nend", result));
+    }
+
+    TEST_F(ScriptCacheTest, cache_should_be_dropped_for_other_engine_version)
+    {
+        {
+            MWScript::ScriptCache cache(mPath, makeKey());
+            cache.add("test", "begin test\nend", makeScript());
+            cache.write();
+        }
+
+        MWScript::ScriptCache cache(mPath, makeKey({}, "OpenMW version 0.45.0\nRevision: 0123456789"));
+        MWScript::ScriptCache::CompiledScript result;
+        EXPECT_FALSE(cache.get("test", "begin test\nend", result));
+    }
+}
@@ -1,13 +1,20 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
 #include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
 
 #include <components/files/configurationmanager.hpp>
 #include <components/esm/esmreader.hpp>
 #include <components/esm/esmwriter.hpp>
+#include <components/files/collections.hpp>
 #include <components/loadinglistener/loadinglistener.hpp>
 
 #include "apps/openmw/mwworld/esmstore.hpp"
+#include "apps/openmw/mwworld/recordcache.hpp"
 
 static Loading::Listener dummyListener;
 
@@ -219,14 +226,15 @@ protected:
 
 /// Create an ESM file in-memory containing the specified record.
 /// @param deleted Write record with deleted flag?
+/// @param flags Record header flags
 template <typename T>
-Files::IStreamPtr getEsmFile(T record, bool deleted)
+Files::IStreamPtr getEsmFile(T record, bool deleted, std::uint32_t flags = 0)
 {
     ESM::ESMWriter writer;
     std::stringstream* stream = new std::stringstream;
     writer.setFormat(0);
     writer.save(*stream);
-    writer.startRecord(T::sRecordId);
+    writer.startRecord(T::sRecordId, flags);
     record.save(writer, deleted);
     writer.endRecord(T::sRecordId);
 
@@ -313,3 +321,251 @@ TEST_F(StoreTest, overwrite_test)
 
     ASSERT_TRUE (overwrittenRec && overwrittenRec->mModel == "the_new_model");
 }
+
+/// Tests that records read ahead by ESMStore::stage are merged like records read by ESMStore::load.
+TEST_F(StoreTest, staged_load_test)
+{
+    const std::string recordId = "foobar";
+
+    typedef ESM::Apparatus RecordType;
+
+    RecordType record;
+    record.blank();
+    record.mId = recordId;
+
+    ESM::ESMReader reader;
+    std::vector<ESM::ESMReader> readerList;
+    readerList.push_back(reader);
+    reader.setGlobalReaderList(&readerList);
+
+    // master file inserts a record
+    MWWorld::ESMStore::StagedRecords staged;
+    reader.open(getEsmFile(record, false), "filename");
+    mEsmStore.stage(reader, staged);
+    ASSERT_EQ (staged.size(), 1u);
+    ASSERT_TRUE (staged.front() != nullptr);
+    reader.open(getEsmFile(record, false), "filename");
+    mEsmStore.load(reader, &dummyListener, &staged);
+    mEsmStore.setUp();
+
+    ASSERT_TRUE (mEsmStore.get<RecordType>().getSize() == 1);
+
+    // now a plugin overwrites it with changed data
+    record.mId = "Foobar";
+    record.mModel = "the_new_model";
+    staged.clear();
+    reader.open(getEsmFile(record, false), "filename");
+    mEsmStore.stage(reader, staged);
+    reader.open(getEsmFile(record, false), "filename");
+    mEsmStore.load(reader, &dummyListener, &staged);
+    mEsmStore.setUp();
+
+    const RecordType* overwrittenRec = mEsmStore.get<RecordType>().search(recordId);
+    ASSERT_TRUE (overwrittenRec != nullptr);
+    ASSERT_TRUE (overwrittenRec && overwrittenRec->mModel == "the_new_model");
+
+    // and another plugin deletes it
+    staged.clear();
+    reader.open(getEsmFile(record, true), "filename");
+    mEsmStore.stage(reader, staged);
+    reader.open(getEsmFile(record, true), "filename");
+    mEsmStore.load(reader, &dummyListener, &staged);
+    mEsmStore.setUp();
+
+    ASSERT_TRUE (mEsmStore.get<RecordType>().getSize() == 0);
+}
+
+/// Tests that records written by writeCache() replace the matching records of content files.
+TEST_F(StoreTest, record_cache_test)
+{
+    typedef ESM::Apparatus RecordType;
+
+    RecordType record;
+    record.blank();
+    record.mId = "Foobar";
+    record.mModel = "the_model";
+
+    ESM::ESMReader reader;
+    std::vector<ESM::ESMReader> readerList;
+    readerList.push_back(reader);
+    reader.setGlobalReaderList(&readerList);
+
+    reader.open(getEsmFile(record, false), "filename");
+    mEsmStore.load(reader, &dummyListener);
+
+    ESM::ESMWriter writer;
+    std::stringstream* stream = new std::stringstream;
+    writer.setFormat(0);
+    writer.save(*stream);
+    mEsmStore.writeCache(writer);
+    writer.close();
+
+    MWWorld::ESMStore cachedStore;
+    reader.open(Files::IStreamPtr(stream), "cache");
+    cachedStore.readCache(reader);
+    ASSERT_EQ (cachedStore.get<RecordType>().getSize(), 1u);
+
+    // records of cached types are skipped in content files
+    record.mModel = "the_new_model";
+    reader.open(getEsmFile(record, false), "filename");
+    cachedStore.load(reader, &dummyListener);
+    cachedStore.setUp();
+
+    const RecordType* cachedRec = cachedStore.get<RecordType>().search("foobar");
+    ASSERT_TRUE (cachedRec != nullptr);
+    ASSERT_EQ (cachedRec->mModel, "the_model");
+}
+
+/// Tests that records read from the cache keep the record flags of content files.
+TEST_F(StoreTest, record_cache_should_keep_persistent_flag)
+{
+    ESM::NPC npc;
+    npc.blank();
+    npc.mId = "persistent_npc";
+    ESM::Creature creature;
+    creature.blank();
+    creature.mId = "persistent_creature";
+
+    ESM::ESMReader reader;
+    std::vector<ESM::ESMReader> readerList;
+    readerList.push_back(reader);
+    reader.setGlobalReaderList(&readerList);
+
+    reader.open(getEsmFile(npc, false, 0x0400), "filename");
+    mEsmStore.load(reader, &dummyListener);
+    reader.open(getEsmFile(creature, false, 0x0400), "filename");
+    mEsmStore.load(reader, &dummyListener);
+    ASSERT_TRUE (mEsmStore.get<ESM::NPC>().find("persistent_npc")->mPersistent);
+    ASSERT_TRUE (mEsmStore.get<ESM::Creature>().find("persistent_creature")->mPersistent);
+
+    ESM::ESMWriter writer;
+    std::stringstream* stream = new std::stringstream;
+    writer.setFormat(0);
+    writer.save(*stream);
+    mEsmStore.writeCache(writer);
+    writer.close();
+
+    MWWorld::ESMStore cachedStore;
+    reader.open(Files::IStreamPtr(stream), "cache");
+    cachedStore.readCache(reader);
+
+    EXPECT_TRUE (cachedStore.get<ESM::NPC>().find("persistent_npc")->mPersistent);
+    EXPECT_TRUE (cachedStore.get<ESM::Creature>().find("persistent_creature")->mPersistent);
+}
+
+/// Tests that the record cache is only read by the engine version that wrote it.
+TEST_F(StoreTest, record_cache_should_be_out_of_date_for_other_engine_version)
+{
+    const std::string path = (boost::filesystem::temp_directory_path() / "openmw_test_records.cache").string();
+    const Files::Collections collections;
+
+    ESM::Apparatus record;
+    record.blank();
+    record.mId = "Foobar";
+
+    ESM::ESMReader reader;
+    std::vector<ESM::ESMReader> readerList;
+    readerList.push_back(reader);
+    reader.setGlobalReaderList(&readerList);
+    reader.open(getEsmFile(record, false), "filename");
+    mEsmStore.load(reader, &dummyListener);
+
+    MWWorld::RecordCache(path, collections, {}, nullptr, "OpenMW version 0.45.0").write(mEsmStore);
+
+    MWWorld::ESMStore otherVersionStore;
+    EXPECT_FALSE (MWWorld::RecordCache(path, collections, {}, nullptr, "OpenMW version 0.46.0").read(otherVersionStore));
+    EXPECT_EQ (otherVersionStore.get<ESM::Apparatus>().getSize(), 0u);
+
+    MWWorld::ESMStore sameVersionStore;
+    EXPECT_TRUE (MWWorld::RecordCache(path, collections, {}, nullptr, "OpenMW version 0.45.0").read(sameVersionStore));
+    EXPECT_EQ (sameVersionStore.get<ESM::Apparatus>().getSize(), 1u);
+
+    boost::filesystem::remove(path);
+}
+
+/// Tests lookups and iteration order of static and dynamic records.
+TEST_F(StoreTest, search_and_iteration_order_test)
+{
+    typedef ESM::Apparatus RecordType;
+    MWWorld::Store<RecordType>& store = const_cast<MWWorld::Store<RecordType>&>(mEsmStore.get<RecordType>());
+
+    RecordType record;
+    record.blank();
+    const char* ids[] = {"zeta", "Alpha", "mu"};
+    for (const char* id : ids)
+    {
+        record.mId = id;
+        store.insertStatic(record);
+    }
+    record.mId = "Dynamic_B";
+    store.insert(record);
+    record.mId = "dynamic_a";
+    store.insert(record);
+
+    ASSERT_EQ (store.getSize(), 5u);
+    ASSERT_EQ (store.getDynamicSize(), 2);
+    ASSERT_TRUE (store.search("ALPHA") != nullptr);
+    ASSERT_EQ (store.search("ALPHA")->mId, "Alpha");
+    ASSERT_TRUE (store.isDynamic("DYNAMIC_B"));
+    ASSERT_FALSE (store.isDynamic("alpha"));
+    ASSERT_TRUE (store.search("alph") == nullptr);
+
+    // records are iterated in the order they were inserted, static records first
+    std::vector<std::string> list;
+    store.listIdentifier(list);
+    ASSERT_EQ (list, std::vector<std::string>({"zeta", "Alpha", "mu", "Dynamic_B", "dynamic_a"}));
+
+    ASSERT_TRUE (store.erase("dynamic_b"));
+    store.eraseStatic("ZETA");
+    list.clear();
+    store.listIdentifier(list);
+    ASSERT_EQ (list, std::vector<std::string>({"Alpha", "mu", "dynamic_a"}));
+    ASSERT_TRUE (store.search("zeta") == nullptr);
+    ASSERT_TRUE (store.search("dynamic_b") == nullptr);
+
+    store.clearDynamic();
+    ASSERT_EQ (store.getSize(), 2u);
+    ASSERT_TRUE (store.search("dynamic_a") == nullptr);
+}
+
+/// Measures the lookup throughput of a store holding as many records as Morrowind.esm has statics.
+TEST_F(StoreTest, search_throughput_for_20k_records)
+{
+    typedef ESM::Static RecordType;
+    MWWorld::Store<RecordType>& store = const_cast<MWWorld::Store<RecordType>&>(mEsmStore.get<RecordType>());
+
+    const std::size_t count = 20000;
+    std::vector<std::string> ids;
+    ids.reserve(count);
+    RecordType record;
+    record.blank();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        record.mId = "Generated_Static_" + std::to_string(i);
+        ids.push_back(Misc::StringUtils::lowerCase(record.mId));
+        store.insertStatic(record);
+    }
+    std::vector<std::string> mixedCase = ids;
+    for (std::string& id : mixedCase)
+        id[0] = Misc::StringUtils::toLower(id[0]) == id[0] ? 'G' : 'g';
+
+    const std::size_t rounds = 50;
+    auto start = std::chrono::steady_clock::now();
+    std::size_t found = 0;
+    for (std::size_t round = 0; round < rounds; ++round)
+        for (const std::string& id : ids)
+            found += store.search(id) != nullptr;
+    const std::chrono::duration<double> lowerTime = std::chrono::steady_clock::now() - start;
+    ASSERT_EQ (found, count * rounds);
+
+    start = std::chrono::steady_clock::now();
+    found = 0;
+    for (std::size_t round = 0; round < rounds; ++round)
+        for (const std::string& id : mixedCase)
+            found += store.search(id) != nullptr;
+    const std::chrono::duration<double> mixedTime = std::chrono::steady_clock::now() - start;
+    ASSERT_EQ (found, count * rounds);
+
+    std::cout << "search: " << count * rounds / lowerTime.count() << " lookups/s, "
+        << "search with mixed case: " << count * rounds / mixedTime.count() << " lookups/s" << std::endl;
+}
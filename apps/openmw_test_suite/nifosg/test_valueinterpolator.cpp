@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include <components/nifosg/controller.hpp>
+
+namespace
+{
+    using namespace testing;
+    using namespace NifOsg;
+
+    std::shared_ptr<Nif::FloatKeyMap> makeFloatKeys(const std::vector<std::pair<float, float>>& keys)
+    {
+        std::shared_ptr<Nif::FloatKeyMap> result = std::make_shared<Nif::FloatKeyMap>();
+        for (const auto& key : keys)
+        {
+            result->mTimes.push_back(key.first);
+            result->mKeys.push_back(Nif::FloatKey {key.second});
+        }
+        result->sortKeys();
+        return result;
+    }
+
+    /// Interpolates without any caching
+    float expectedValue(const Nif::FloatKeyMap& keys, float time)
+    {
+        if (time <= keys.mTimes.front())
+            return keys.mKeys.front().mValue;
+        for (std::size_t i = 1; i < keys.mTimes.size(); ++i)
+        {
+            if (time <= keys.mTimes[i])
+            {
+                const float a = (time - keys.mTimes[i - 1]) / (keys.mTimes[i] - keys.mTimes[i - 1]);
+                return keys.mKeys[i - 1].mValue + (keys.mKeys[i].mValue - keys.mKeys[i - 1].mValue) * a;
+            }
+        }
+        return keys.mKeys.back().mValue;
+    }
+
+    TEST(NifOsgValueInterpolatorTest, interp_key_without_keys_should_return_default_value)
+    {
+        EXPECT_EQ(FloatInterpolator().interpKey(1), 0);
+        EXPECT_EQ(FloatInterpolator(makeFloatKeys({}), 3).interpKey(1), 3);
+    }
+
+    TEST(NifOsgValueInterpolatorTest, interp_key_should_clamp_to_first_and_last_key)
+    {
+        const FloatInterpolator interpolator(makeFloatKeys({{1, 10}, {2, 20}, {4, 40}}));
+        EXPECT_EQ(interpolator.interpKey(-5), 10);
+        EXPECT_EQ(interpolator.interpKey(1), 10);
+        EXPECT_EQ(interpolator.interpKey(4), 40);
+        EXPECT_EQ(interpolator.interpKey(100), 40);
+        EXPECT_EQ(FloatInterpolator(makeFloatKeys({{1, 10}})).interpKey(2), 10);
+    }
+
+    TEST(NifOsgValueInterpolatorTest, interp_key_should_interpolate_linearly_in_any_order)
+    {
+        const std::shared_ptr<Nif::FloatKeyMap> keys = makeFloatKeys({{0, 0}, {1, 10}, {1.5f, -5}, {2, 20}, {4, 40}, {10, 0}});
+        const FloatInterpolator interpolator(keys);
+        std::vector<float> times;
+        for (float time = -1; time < 12; time += 0.1f)
+            times.push_back(time);
+        for (float time = 12; time > -1; time -= 0.3f)
+            times.push_back(time);
+        std::minstd_rand random(42);
+        std::uniform_real_distribution<float> distribution(-1, 12);
+        for (int i = 0; i < 100; ++i)
+            times.push_back(distribution(random));
+
+        for (float time : times)
+            EXPECT_NEAR(interpolator.interpKey(time), expectedValue(*keys, time), 1e-4f) << time;
+    }
+
+    TEST(NifOsgValueInterpolatorTest, sort_keys_should_keep_the_last_of_keys_with_the_same_time)
+    {
+        const std::shared_ptr<Nif::FloatKeyMap> keys = makeFloatKeys({{2, 20}, {1, 10}, {2, 21}, {0, 0}, {1, 11}});
+        EXPECT_EQ(keys->mTimes, std::vector<float>({0, 1, 2}));
+        ASSERT_EQ(keys->mKeys.size(), 3u);
+        EXPECT_EQ(keys->mKeys[0].mValue, 0);
+        EXPECT_EQ(keys->mKeys[1].mValue, 11);
+        EXPECT_EQ(keys->mKeys[2].mValue, 21);
+    }
+
+    /// Animates the rotation, translation and scale of every bone of 100 actors with a skeleton of 60 bones for 10 seconds at 60 fps,
+    /// like the KeyframeControllers of the actors would, with 100 keys per track.
+    TEST(NifOsgValueInterpolatorTest, keyframes_interpolated_per_second)
+    {
+        const int actors = 100;
+        const int bones = 60;
+        const int keysPerTrack = 100;
+        const int frames = 600;
+        const float duration = 5;
+
+        std::minstd_rand random(7);
+        std::uniform_real_distribution<float> distribution(-1, 1);
+
+        std::vector<Nif::QuaternionKeyMapPtr> rotations;
+        std::vector<Nif::Vector3KeyMapPtr> translations;
+        std::vector<Nif::FloatKeyMapPtr> scales;
+        for (int bone = 0; bone < bones; ++bone)
+        {
+            rotations.push_back(std::make_shared<Nif::QuaternionKeyMap>());
+            translations.push_back(std::make_shared<Nif::Vector3KeyMap>());
+            scales.push_back(std::make_shared<Nif::FloatKeyMap>());
+            for (int key = 0; key < keysPerTrack; ++key)
+            {
+                const float time = duration * key / (keysPerTrack - 1);
+                osg::Quat rotation(distribution(random), distribution(random), distribution(random), distribution(random));
+                rotation /= rotation.length();
+                rotations.back()->mTimes.push_back(time);
+                rotations.back()->mKeys.push_back(Nif::QuaternionKey {rotation});
+                translations.back()->mTimes.push_back(time);
+                translations.back()->mKeys.push_back(Nif::Vector3Key {osg::Vec3f(distribution(random), distribution(random), distribution(random))});
+                scales.back()->mTimes.push_back(time);
+                scales.back()->mKeys.push_back(Nif::FloatKey {1 + distribution(random) / 10});
+            }
+        }
+
+        struct Tracks
+        {
+            QuaternionInterpolator mRotation;
+            Vec3Interpolator mTranslation;
+            FloatInterpolator mScale;
+        };
+        std::vector<Tracks> tracks;
+        std::vector<float> startTimes;
+        for (int actor = 0; actor < actors; ++actor)
+        {
+            startTimes.push_back((distribution(random) + 1) * duration / 2);
+            for (int bone = 0; bone < bones; ++bone)
+                tracks.push_back(Tracks {QuaternionInterpolator(rotations[bone]), Vec3Interpolator(translations[bone]),
+                    FloatInterpolator(scales[bone])});
+        }
+
+        float checksum = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            for (int actor = 0; actor < actors; ++actor)
+            {
+                // Loop the animation like a looping animation group would
+                const float time = std::fmod(startTimes[actor] + frame / 60.f, duration);
+                for (int bone = 0; bone < bones; ++bone)
+                {
+                    const Tracks& track = tracks[actor * bones + bone];
+                    checksum += track.mRotation.interpKey(time).w() + track.mTranslation.interpKey(time).x()
+                        + track.mScale.interpKey(time);
+                }
+            }
+        }
+        const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+        std::cout << 3.0 * actors * bones * frames / time.count() << " keyframes interpolated per second, "
+            << time.count() / frames * 1000 << " ms per frame (checksum " << checksum << ")" << std::endl;
+    }
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+#include <osg/Geometry>
+#include <osg/Group>
+
+#include <components/sceneutil/geometryupdatequeue.hpp>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    struct CountingUpdater : GeometryUpdater
+    {
+        std::atomic<int> mCount {0};
+
+        void updateGeometry(osg::Geometry&) override
+        {
+            ++mCount;
+        }
+    };
+
+    /// Schedules updates like RigGeometries culled below the node of the JoinCallback would
+    struct ScheduleCallback : osg::NodeCallback
+    {
+        GeometryUpdateQueue& mQueue;
+        GeometryUpdater& mUpdater;
+        osg::ref_ptr<osg::Geometry> mGeometry;
+        int mCount;
+
+        ScheduleCallback(GeometryUpdateQueue& queue, GeometryUpdater& updater, int count)
+            : mQueue(queue), mUpdater(updater), mGeometry(new osg::Geometry), mCount(count) {}
+
+        void operator()(osg::Node* node, osg::NodeVisitor* nv) override
+        {
+            for (int i = 0; i < mCount; ++i)
+                mQueue.schedule(mUpdater, *mGeometry);
+            traverse(node, nv);
+        }
+    };
+
+    TEST(SceneUtilGeometryUpdateQueueTest, schedule_outside_of_join_callback_should_update_right_away)
+    {
+        osg::ref_ptr<GeometryUpdateQueue> queue = new GeometryUpdateQueue(2);
+        CountingUpdater updater;
+        osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+        queue->schedule(updater, *geometry);
+        EXPECT_EQ(updater.mCount, 1);
+    }
+
+    TEST(SceneUtilGeometryUpdateQueueTest, join_callback_should_wait_for_all_scheduled_updates)
+    {
+        osg::ref_ptr<GeometryUpdateQueue> queue = new GeometryUpdateQueue(2);
+        CountingUpdater updater;
+        osg::ref_ptr<GeometryUpdateQueue::JoinCallback> callback = new GeometryUpdateQueue::JoinCallback(queue);
+        callback->setNestedCallback(new ScheduleCallback(*queue, updater, 103));
+        osg::ref_ptr<osg::Group> node = new osg::Group;
+        osg::NodeVisitor visitor;
+
+        for (int frame = 1; frame <= 3; ++frame)
+        {
+            (*callback)(node, &visitor);
+            EXPECT_EQ(updater.mCount, 103 * frame);
+            EXPECT_EQ(queue->getNumUpdates(), 103u);
+            EXPECT_LE(queue->getBeginTick(), queue->getEndTick());
+        }
+    }
+}
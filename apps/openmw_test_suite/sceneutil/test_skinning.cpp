@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <osg/Vec4f>
+
+#include <components/sceneutil/skinning.hpp>
+
+namespace
+{
+    using namespace testing;
+    using namespace SceneUtil;
+
+    const SkinningKernel sKernels[] = {SkinningKernel::Scalar, SkinningKernel::SSE, SkinningKernel::AVX};
+
+    osg::Matrixf makeMatrix(std::minstd_rand& random)
+    {
+        std::uniform_real_distribution<float> distribution(-2.f, 2.f);
+        osg::Matrixf matrix;
+        for (int row = 0; row < 4; ++row)
+            for (int column = 0; column < 3; ++column)
+                matrix(row, column) = distribution(random);
+        return matrix;
+    }
+
+    std::vector<osg::Vec3f> makeVertices(std::size_t count, std::minstd_rand& random)
+    {
+        std::uniform_real_distribution<float> distribution(-100.f, 100.f);
+        std::vector<osg::Vec3f> result;
+        for (std::size_t i = 0; i < count; ++i)
+            result.emplace_back(distribution(random), distribution(random), distribution(random));
+        return result;
+    }
+
+    struct SoaVertices
+    {
+        std::vector<float> mX;
+        std::vector<float> mY;
+        std::vector<float> mZ;
+        std::vector<unsigned short> mIndices;
+
+        /// Gather \a vertices in reverse order, so that the kernels have to scatter
+        explicit SoaVertices(const std::vector<osg::Vec3f>& vertices)
+        {
+            for (std::size_t i = vertices.size(); i-- > 0;)
+            {
+                mX.push_back(vertices[i].x());
+                mY.push_back(vertices[i].y());
+                mZ.push_back(vertices[i].z());
+                mIndices.push_back(static_cast<unsigned short>(i));
+            }
+        }
+    };
+
+    TEST(SceneUtilSkinningTest, scalar_kernel_should_always_be_supported)
+    {
+        EXPECT_TRUE(isSkinningKernelSupported(SkinningKernel::Scalar));
+        EXPECT_TRUE(isSkinningKernelSupported(selectSkinningKernel("auto")));
+        EXPECT_EQ(selectSkinningKernel("scalar"), SkinningKernel::Scalar);
+        EXPECT_EQ(selectSkinningKernel("no such kernel"), selectSkinningKernel("auto"));
+    }
+
+    TEST(SceneUtilSkinningTest, kernels_should_transform_like_osg_matrix)
+    {
+        std::minstd_rand random(42);
+        // Odd counts to cover the remainders of the vectorized loops
+        for (std::size_t count : {0, 1, 3, 4, 7, 8, 9, 17, 250})
+        {
+            const osg::Matrixf matrix = makeMatrix(random);
+            SkinningMatrix skinningMatrix;
+            skinningMatrix.set(matrix);
+
+            const std::vector<osg::Vec3f> vertices = makeVertices(count, random);
+            const SoaVertices source(vertices);
+
+            for (SkinningKernel kernel : sKernels)
+            {
+                if (!isSkinningKernelSupported(kernel))
+                    continue;
+
+                std::vector<osg::Vec3f> positions(count);
+                std::vector<osg::Vec4f> directions(count, osg::Vec4f(0, 0, 0, 0.5f));
+                skinPositions(kernel, skinningMatrix, source.mX.data(), source.mY.data(), source.mZ.data(), count,
+                    source.mIndices.data(), positions.data()->ptr(), 3);
+                skinDirections(kernel, skinningMatrix, source.mX.data(), source.mY.data(), source.mZ.data(), count,
+                    source.mIndices.data(), directions.data()->ptr(), 4);
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    const osg::Vec3f expectedPosition = matrix.preMult(vertices[i]);
+                    const osg::Vec3f expectedDirection = osg::Matrixf::transform3x3(vertices[i], matrix);
+                    for (int component = 0; component < 3; ++component)
+                    {
+                        EXPECT_NEAR(positions[i][component], expectedPosition[component], 1e-3f)
+                            << getSkinningKernelName(kernel) << " vertex " << i;
+                        EXPECT_NEAR(directions[i][component], expectedDirection[component], 1e-3f)
+                            << getSkinningKernelName(kernel) << " vertex " << i;
+                    }
+                    EXPECT_EQ(directions[i][3], 0.5f);
+                }
+            }
+        }
+    }
+
+    TEST(SceneUtilSkinningTest, accumulate_should_blend_matrices_by_weight)
+    {
+        std::minstd_rand random(7);
+        const osg::Matrixf first = makeMatrix(random);
+        const osg::Matrixf second = makeMatrix(random);
+
+        SkinningMatrix a;
+        a.set(first);
+        SkinningMatrix b;
+        b.set(second);
+        SkinningMatrix blended;
+        blended.setZero();
+        blended.accumulate(a, 0.25f);
+        blended.accumulate(b, 0.75f);
+
+        for (int row = 0; row < 3; ++row)
+            for (int column = 0; column < 4; ++column)
+                EXPECT_NEAR(blended.mValues[row][column], first(column, row) * 0.25f + second(column, row) * 0.75f, 1e-5f);
+    }
+
+    /// Compares the kernels with transforming every vertex with an osg::Matrixf, like RigGeometry used to,
+    /// for a mesh of 2000 vertices in groups of 40 vertices with the same bone weights.
+    TEST(SceneUtilSkinningTest, vertices_skinned_per_second)
+    {
+        const std::size_t vertexCount = 2000;
+        const std::size_t groupSize = 40;
+        const int iterations = 500;
+
+        std::minstd_rand random(3);
+        const std::vector<osg::Vec3f> vertices = makeVertices(vertexCount, random);
+        const std::vector<osg::Vec3f> normals = makeVertices(vertexCount, random);
+        const osg::Matrixf matrix = makeMatrix(random);
+        SkinningMatrix skinningMatrix;
+        skinningMatrix.set(matrix);
+        const SoaVertices sourceVertices(vertices);
+        const SoaVertices sourceNormals(normals);
+        std::vector<unsigned short> indices;
+        for (std::size_t i = 0; i < vertexCount; ++i)
+            indices.push_back(static_cast<unsigned short>(i));
+
+        std::vector<osg::Vec3f> positionsDst(vertexCount);
+        std::vector<osg::Vec3f> normalsDst(vertexCount);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int iteration = 0; iteration < iterations; ++iteration)
+        {
+            for (std::size_t group = 0; group < vertexCount; group += groupSize)
+            {
+                for (std::size_t i = group; i < group + groupSize; ++i)
+                {
+                    positionsDst[indices[i]] = matrix.preMult(vertices[indices[i]]);
+                    normalsDst[indices[i]] = osg::Matrixf::transform3x3(normals[indices[i]], matrix);
+                }
+            }
+        }
+        const std::chrono::duration<double> matrixTime = std::chrono::steady_clock::now() - start;
+        std::cout << "osg::Matrixf: " << vertexCount * iterations / matrixTime.count() << " vertices/s" << std::endl;
+
+        for (SkinningKernel kernel : sKernels)
+        {
+            if (!isSkinningKernelSupported(kernel))
+                continue;
+
+            start = std::chrono::steady_clock::now();
+            for (int iteration = 0; iteration < iterations; ++iteration)
+            {
+                for (std::size_t group = 0; group < vertexCount; group += groupSize)
+                {
+                    skinPositions(kernel, skinningMatrix, &sourceVertices.mX[group], &sourceVertices.mY[group], &sourceVertices.mZ[group],
+                        groupSize, &sourceVertices.mIndices[group], positionsDst.data()->ptr(), 3);
+                    skinDirections(kernel, skinningMatrix, &sourceNormals.mX[group], &sourceNormals.mY[group], &sourceNormals.mZ[group],
+                        groupSize, &sourceNormals.mIndices[group], normalsDst.data()->ptr(), 3);
+                }
+            }
+            const std::chrono::duration<double> kernelTime = std::chrono::steady_clock::now() - start;
+            std::cout << getSkinningKernelName(kernel) << ": " << vertexCount * iterations / kernelTime.count() << " vertices/s, "
+                << matrixTime.count() / kernelTime.count() << " times as fast" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,167 @@
+#include <components/vfs/manager.hpp>
+#include <components/vfs/archive.hpp>
+#include <components/files/memorystream.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+    using namespace testing;
+
+    struct TestFile : VFS::File
+    {
+        std::string mContent;
+
+        TestFile(const std::string& content) : mContent(content) {}
+
+        Files::IStreamPtr open() override
+        {
+            return Files::IStreamPtr(new Files::IMemStream(mContent.data(), mContent.size()));
+        }
+    };
+
+    struct TestArchive : VFS::Archive
+    {
+        std::map<std::string, TestFile> mFiles;
+
+        void listResources(std::map<std::string, VFS::File*>& out, char (*normalize_function) (char)) override
+        {
+            for (auto& file : mFiles)
+            {
+                std::string name = file.first;
+                std::transform(name.begin(), name.end(), name.begin(), normalize_function);
+                out[name] = &file.second;
+            }
+        }
+    };
+
+    std::string readAll(const Files::IStreamPtr& stream)
+    {
+        std::ostringstream out;
+        out << stream->rdbuf();
+        return out.str();
+    }
+
+    struct VFSManagerTest : Test
+    {
+        VFS::Manager mManager {false};
+
+        void addArchive(const std::vector<std::pair<std::string, std::string>>& files)
+        {
+            std::unique_ptr<TestArchive> archive(new TestArchive);
+            for (const auto& file : files)
+                archive->mFiles.emplace(file.first, TestFile(file.second));
+            mManager.addArchive(archive.release());
+        }
+    };
+
+    TEST_F(VFSManagerTest, exists_should_return_false_for_empty_index)
+    {
+        mManager.buildIndex();
+        EXPECT_FALSE(mManager.exists("meshes/a.nif"));
+    }
+
+    TEST_F(VFSManagerTest, exists_should_ignore_case_and_slash_kind)
+    {
+        addArchive({{"Meshes\\Foo\\Bar.NIF", "bar"}});
+        mManager.buildIndex();
+        EXPECT_TRUE(mManager.exists("meshes/foo/bar.nif"));
+        EXPECT_TRUE(mManager.exists("MESHES\\FOO\\BAR.NIF"));
+        EXPECT_TRUE(mManager.exists("Meshes/foo\\Bar.nif"));
+        EXPECT_FALSE(mManager.exists("meshes/foo/bar.ni"));
+        EXPECT_FALSE(mManager.exists("meshes/foo/bar.nif2"));
+        EXPECT_FALSE(mManager.exists(""));
+    }
+
+    TEST_F(VFSManagerTest, strict_manager_should_only_convert_slashes)
+    {
+        VFS::Manager manager(true);
+        std::unique_ptr<TestArchive> archive(new TestArchive);
+        archive->mFiles.emplace("Meshes\\Bar.nif", TestFile("bar"));
+        manager.addArchive(archive.release());
+        manager.buildIndex();
+        EXPECT_TRUE(manager.exists("Meshes/Bar.nif"));
+        EXPECT_TRUE(manager.exists("Meshes\\Bar.nif"));
+        EXPECT_FALSE(manager.exists("meshes/bar.nif"));
+    }
+
+    TEST_F(VFSManagerTest, get_should_return_file_from_last_added_archive)
+    {
+        addArchive({{"textures/a.dds", "first"}, {"textures/b.dds", "b"}});
+        addArchive({{"Textures/A.dds", "second"}});
+        mManager.buildIndex();
+        EXPECT_EQ(readAll(mManager.get("textures\\a.dds")), "second");
+        EXPECT_EQ(readAll(mManager.getNormalized("textures/b.dds")), "b");
+        EXPECT_EQ(mManager.getIndex().size(), 2u);
+    }
+
+    TEST_F(VFSManagerTest, get_should_throw_for_missing_file)
+    {
+        addArchive({{"textures/a.dds", "a"}});
+        mManager.buildIndex();
+        EXPECT_THROW(mManager.get("Textures/Missing.dds"), std::runtime_error);
+        EXPECT_THROW(mManager.getNormalized("textures/missing.dds"), std::runtime_error);
+    }
+
+    TEST_F(VFSManagerTest, reset_should_clear_index)
+    {
+        addArchive({{"textures/a.dds", "a"}});
+        mManager.buildIndex();
+        mManager.reset();
+        EXPECT_FALSE(mManager.exists("textures/a.dds"));
+    }
+
+    TEST_F(VFSManagerTest, lookup_throughput_for_500k_entries)
+    {
+        const std::size_t count = 500000;
+        std::unique_ptr<TestArchive> archive(new TestArchive);
+        std::vector<std::string> names;
+        names.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            names.push_back("Meshes\\Generated\\Dir" + std::to_string(i % 1000) + "\\File" + std::to_string(i) + ".NIF");
+            archive->mFiles.emplace(names.back(), TestFile(std::string()));
+        }
+        mManager.addArchive(archive.release());
+        mManager.buildIndex();
+
+        std::vector<std::string> normalized = names;
+        std::vector<std::string> missing;
+        missing.reserve(count);
+        for (auto& name : normalized)
+        {
+            mManager.normalizeFilename(name);
+            missing.push_back(name + "x");
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::size_t found = 0;
+        for (const auto& name : names)
+            found += mManager.exists(name);
+        const std::chrono::duration<double> existsTime = std::chrono::steady_clock::now() - start;
+        EXPECT_EQ(found, count);
+
+        start = std::chrono::steady_clock::now();
+        found = 0;
+        for (const auto& name : normalized)
+            found += mManager.getNormalized(name) != nullptr;
+        const std::chrono::duration<double> getNormalizedTime = std::chrono::steady_clock::now() - start;
+        EXPECT_EQ(found, count);
+
+        start = std::chrono::steady_clock::now();
+        found = 0;
+        for (const auto& name : missing)
+            found += mManager.exists(name);
+        const std::chrono::duration<double> missingTime = std::chrono::steady_clock::now() - start;
+        EXPECT_EQ(found, 0u);
+
+        std::cout << "exists: " << count / existsTime.count() << " lookups/s, "
+            << "getNormalized: " << count / getNormalizedTime.count() << " lookups/s, "
+            << "exists for missing files: " << count / missingTime.count() << " lookups/s" << std::endl;
+    }
+}
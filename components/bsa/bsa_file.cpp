@@ -160,12 +160,21 @@ int BSAFile::getIndex(const char *str) const
 }
 
 /// Open an archive file.
-void BSAFile::open(const string &file)
+void BSAFile::open(const string &file, bool memoryMapped)
 {
     mFilename = file;
+    if (memoryMapped)
+        mMappedFile = std::make_shared<Files::MemoryMappedFile>(file);
     readHeader();
 }
 
+Files::IStreamPtr BSAFile::openStream(size_t offset, size_t size) const
+{
+    if (mMappedFile)
+        return Files::openMemoryMappedFileStream(mMappedFile, offset, size);
+    return Files::openConstrainedFileStream(mFilename.c_str(), offset, size);
+}
+
 Files::IStreamPtr BSAFile::getFile(const char *file)
 {
     assert(file);
@@ -175,10 +184,10 @@ Files::IStreamPtr BSAFile::getFile(const char *file)
 
     const FileStruct &fs = mFiles[i];
 
-    return Files::openConstrainedFileStream (mFilename.c_str (), fs.offset, fs.fileSize);
+    return openStream(fs.offset, fs.fileSize);
 }
 
 Files::IStreamPtr BSAFile::getFile(const FileStruct *file)
 {
-    return Files::openConstrainedFileStream (mFilename.c_str (), file->offset, file->fileSize);
+    return openStream(file->offset, file->fileSize);
 }
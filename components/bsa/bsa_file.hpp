@@ -32,6 +32,7 @@
 #include <components/misc/stringops.hpp>
 
 #include <components/files/constrainedfilestream.hpp>
+#include <components/files/memorymappedfile.hpp>
 
 
 namespace Bsa
@@ -69,6 +70,9 @@ protected:
     /// Used for error messages
     std::string mFilename;
 
+    /// Whole archive mapped into memory, or null when files are read through file streams
+    Files::MemoryMappedFilePtr mMappedFile;
+
     /// Case insensitive string comparison
     struct iltstr
     {
@@ -96,6 +100,10 @@ protected:
     /// @note Thread safe.
     int getIndex(const char *str) const;
 
+    /// Open a stream over a region of the archive, reading from the mapping when available
+    /// @note Thread safe.
+    Files::IStreamPtr openStream(size_t offset, size_t size) const;
+
 public:
     /* -----------------------------------
      * BSA management methods
@@ -110,7 +118,13 @@ public:
     { }
 
     /// Open an archive file.
-    void open(const std::string &file);
+    /// @param memoryMapped Map the whole archive once and read files directly from the mapping
+    ///                     instead of opening a file stream per file.
+    void open(const std::string &file, bool memoryMapped = false);
+
+    /// Check if the archive is read through a memory mapping
+    bool isMemoryMapped() const
+    { return mMappedFile != nullptr; }
 
     /* -----------------------------------
      * Archive file routines
@@ -328,7 +328,7 @@ Files::IStreamPtr CompressedBSAFile::getFile(const char* file)
 Files::IStreamPtr CompressedBSAFile::getFile(const FileRecord& fileRecord)
 {
     if (fileRecord.isCompressed(mCompressedByDefault)) {
-        Files::IStreamPtr streamPtr = Files::openConstrainedFileStream(mFilename.c_str(), fileRecord.offset, fileRecord.getSizeWithoutCompressionFlag());
+        Files::IStreamPtr streamPtr = openStream(fileRecord.offset, fileRecord.getSizeWithoutCompressionFlag());
 
         std::istream* fileStream = streamPtr.get();
 
@@ -352,7 +352,7 @@ Files::IStreamPtr CompressedBSAFile::getFile(const FileRecord& fileRecord)
         return std::shared_ptr<std::istream>(memoryStreamPtr, (std::istream*)memoryStreamPtr.get());
     }
 
-    return Files::openConstrainedFileStream(mFilename.c_str(), fileRecord.offset, fileRecord.size);
+    return openStream(fileRecord.offset, fileRecord.size);
 }
 
 BsaVersion CompressedBSAFile::detectVersion(std::string filePath)
@@ -407,7 +407,7 @@ void CompressedBSAFile::convertCompressedSizesToUncompressed()
             continue;
         }
 
-        Files::IStreamPtr dataBegin = Files::openConstrainedFileStream(mFilename.c_str(), fileRecord.offset, fileRecord.getSizeWithoutCompressionFlag());
+        Files::IStreamPtr dataBegin = openStream(fileRecord.offset, fileRecord.getSizeWithoutCompressionFlag());
 
         if (mEmbeddedFileNames)
         {
@@ -5,6 +5,11 @@
 
 #include <components/debug/debuglog.hpp>
 
+#include <osg/Stats>
+#include <osg/Vec2f>
+
+#include <algorithm>
+
 namespace
 {
     using DetourNavigator::ChangeType;
@@ -15,12 +20,29 @@ namespace
         return std::abs(lhs.x() - rhs.x()) + std::abs(lhs.y() - rhs.y());
     }
 
-    std::tuple<ChangeType, int, int> makePriority(const TilePosition& position, const ChangeType changeType,
-                                                    const TilePosition& playerTile)
+    bool isAdjacentOrSame(const TilePosition& lhs, const TilePosition& rhs)
+    {
+        return std::abs(lhs.x() - rhs.x()) <= 1 && std::abs(lhs.y() - rhs.y()) <= 1;
+    }
+
+    /// Distance to the closest tile on the way from player tile to predicted player tile
+    float getDistanceToPlayerWay(const TilePosition& position, const TilePosition& playerTile,
+                                 const TilePosition& predictedPlayerTile)
+    {
+        const osg::Vec2f way(predictedPlayerTile.x() - playerTile.x(), predictedPlayerTile.y() - playerTile.y());
+        const osg::Vec2f toPosition(position.x() - playerTile.x(), position.y() - playerTile.y());
+        const float wayLength2 = way.length2();
+        const float factor = wayLength2 > 0 ? std::min(std::max(toPosition * way / wayLength2, 0.0f), 1.0f) : 0.0f;
+        const osg::Vec2f closest = way * factor;
+        return std::abs(toPosition.x() - closest.x()) + std::abs(toPosition.y() - closest.y());
+    }
+
+    std::tuple<ChangeType, float, int> makePriority(const TilePosition& position, const ChangeType changeType,
+                                                    const TilePosition& playerTile, const TilePosition& predictedPlayerTile)
     {
         return std::make_tuple(
             changeType,
-            getManhattanDistance(position, playerTile),
+            getDistanceToPlayerWay(position, playerTile, predictedPlayerTile),
             getManhattanDistance(position, TilePosition {0, 0})
         );
     }
@@ -50,8 +72,23 @@ namespace DetourNavigator
         , mRecastMeshManager(recastMeshManager)
         , mOffMeshConnectionsManager(offMeshConnectionsManager)
         , mShouldStop()
-        , mNavMeshTilesCache(settings.mMaxNavMeshTilesCacheSize)
+        , mHasPredictedPlayerTile(false)
+        , mProcessedJobs(0)
+        , mProcessedJobsLatency(0)
+        , mNavMeshTilesCache(settings.mMaxNavMeshTilesCacheSize, settings.mVerifyNavMeshTilesCacheKeys)
     {
+        if (settings.mEnableNavMeshDiskCache && !settings.mNavMeshDiskCachePath.empty())
+        {
+            try
+            {
+                mNavMeshDiskCache.reset(new NavMeshDiskCache(settings.mNavMeshDiskCachePath, settings));
+            }
+            catch (const std::exception& e)
+            {
+                ::Log(Debug::Warning) << "Nav mesh disk cache is disabled: " << e.what();
+            }
+        }
+
         for (std::size_t i = 0; i < mSettings.get().mAsyncNavMeshUpdaterThreads; ++i)
             mThreads.emplace_back([&] { process(); });
     }
@@ -73,16 +110,32 @@ namespace DetourNavigator
     {
         *mPlayerTile.lock() = playerTile;
 
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        // Until the next prediction, a prediction made before the player jumped to a far tile points the wrong way
+        if (!mHasPredictedPlayerTile || !isAdjacentOrSame(mPrioritizedPlayerTile, playerTile))
+        {
+            mPredictedPlayerTile = playerTile;
+            mHasPredictedPlayerTile = false;
+        }
+
+        if (mPrioritizedPlayerTile != playerTile)
+        {
+            // Tiles behind the player are no longer important
+            mPrioritizedPlayerTile = playerTile;
+            updatePriorities();
+        }
+
         if (changedTiles.empty())
             return;
 
-        const std::lock_guard<std::mutex> lock(mMutex);
+        const auto now = std::chrono::steady_clock::now();
 
         for (const auto& changedTile : changedTiles)
         {
             if (mPushed[agentHalfExtents].insert(changedTile.first).second)
-                mJobs.push(Job {agentHalfExtents, navMeshCacheItem, changedTile.first,
-                                makePriority(changedTile.first, changedTile.second, playerTile)});
+                mJobs.push(Job {agentHalfExtents, navMeshCacheItem, changedTile.first, changedTile.second, now,
+                                makePriority(changedTile.first, changedTile.second, playerTile, mPredictedPlayerTile)});
         }
 
         log("posted ", mJobs.size(), " jobs");
@@ -90,12 +143,57 @@ namespace DetourNavigator
         mHasJob.notify_all();
     }
 
+    void AsyncNavMeshUpdater::setPredictedPlayerTile(const TilePosition& predictedPlayerTile)
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        mHasPredictedPlayerTile = true;
+
+        if (mPredictedPlayerTile == predictedPlayerTile)
+            return;
+
+        mPredictedPlayerTile = predictedPlayerTile;
+        updatePriorities();
+    }
+
     void AsyncNavMeshUpdater::wait()
     {
         std::unique_lock<std::mutex> lock(mMutex);
         mDone.wait(lock, [&] { return mJobs.empty(); });
     }
 
+    void AsyncNavMeshUpdater::reportStats(unsigned int frameNumber, osg::Stats& stats)
+    {
+        std::size_t jobs = 0;
+        std::size_t processedJobs = 0;
+        std::chrono::steady_clock::duration processedJobsLatency(0);
+
+        {
+            const std::lock_guard<std::mutex> lock(mMutex);
+            jobs = mJobs.size();
+            std::swap(processedJobs, mProcessedJobs);
+            std::swap(processedJobsLatency, mProcessedJobsLatency);
+        }
+
+        if (!stats.collectStats("resource"))
+            return;
+
+        using FloatMs = std::chrono::duration<double, std::milli>;
+
+        stats.setAttribute(frameNumber, "NavMesh Jobs", jobs);
+        if (processedJobs > 0)
+            stats.setAttribute(frameNumber, "NavMesh Job Latency ms",
+                std::chrono::duration_cast<FloatMs>(processedJobsLatency).count() / processedJobs);
+
+        if (mNavMeshDiskCache)
+        {
+            const auto diskCacheStats = mNavMeshDiskCache->getStats();
+            stats.setAttribute(frameNumber, "NavMesh Disk Hit", diskCacheStats.mHits);
+            stats.setAttribute(frameNumber, "NavMesh Disk Miss", diskCacheStats.mMisses);
+            stats.setAttribute(frameNumber, "NavMesh Disk Tile", diskCacheStats.mTiles);
+        }
+    }
+
     void AsyncNavMeshUpdater::process() throw()
     {
         log("start process jobs");
@@ -127,10 +225,16 @@ namespace DetourNavigator
         const auto offMeshConnections = mOffMeshConnectionsManager.get().get(job.mChangedTile);
 
         const auto status = updateNavMesh(job.mAgentHalfExtents, recastMesh.get(), job.mChangedTile, playerTile,
-            offMeshConnections, mSettings, job.mNavMeshCacheItem, mNavMeshTilesCache);
+            offMeshConnections, mSettings, job.mNavMeshCacheItem, mNavMeshTilesCache, mNavMeshDiskCache.get());
 
         const auto finish = std::chrono::steady_clock::now();
 
+        {
+            const std::lock_guard<std::mutex> lock(mMutex);
+            ++mProcessedJobs;
+            mProcessedJobsLatency += finish - job.mPostTime;
+        }
+
         writeDebugFiles(job, recastMesh.get());
 
         using FloatMs = std::chrono::duration<float, std::milli>;
@@ -164,6 +268,26 @@ namespace DetourNavigator
         return job;
     }
 
+    void AsyncNavMeshUpdater::updatePriorities()
+    {
+        if (mJobs.empty())
+            return;
+
+        std::deque<Job> jobs;
+        while (!mJobs.empty())
+        {
+            jobs.push_back(mJobs.top());
+            mJobs.pop();
+        }
+
+        for (auto& job : jobs)
+            job.mPriority = makePriority(job.mChangedTile, job.mChangeType, mPrioritizedPlayerTile, mPredictedPlayerTile);
+
+        mJobs = Jobs(std::less<Job>(), std::move(jobs));
+
+        log("updated priorities of ", mJobs.size(), " jobs");
+    }
+
     void AsyncNavMeshUpdater::writeDebugFiles(const Job& job, const RecastMesh* recastMesh) const
     {
         std::string revision;
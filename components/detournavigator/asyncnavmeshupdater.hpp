@@ -6,6 +6,7 @@
 #include "tilecachedrecastmeshmanager.hpp"
 #include "tileposition.hpp"
 #include "navmeshtilescache.hpp"
+#include "navmeshdiskcache.hpp"
 
 #include <osg/Vec3f>
 
@@ -22,6 +23,11 @@
 
 class dtNavMesh;
 
+namespace osg
+{
+    class Stats;
+}
+
 namespace DetourNavigator
 {
     enum class ChangeType
@@ -42,15 +48,25 @@ namespace DetourNavigator
         void post(const osg::Vec3f& agentHalfExtents, const SharedNavMeshCacheItem& mNavMeshCacheItem,
             const TilePosition& playerTile, const std::map<TilePosition, ChangeType>& changedTiles);
 
+        /**
+         * @brief setPredictedPlayerTile makes posted jobs for tiles closer to the way from player tile to this one
+         * processed first
+         */
+        void setPredictedPlayerTile(const TilePosition& predictedPlayerTile);
+
         void wait();
 
+        void reportStats(unsigned int frameNumber, osg::Stats& stats);
+
     private:
         struct Job
         {
             osg::Vec3f mAgentHalfExtents;
             SharedNavMeshCacheItem mNavMeshCacheItem;
             TilePosition mChangedTile;
-            std::tuple<ChangeType, int, int> mPriority;
+            ChangeType mChangeType;
+            std::chrono::steady_clock::time_point mPostTime;
+            std::tuple<ChangeType, float, int> mPriority;
 
             friend inline bool operator <(const Job& lhs, const Job& rhs)
             {
@@ -69,9 +85,15 @@ namespace DetourNavigator
         std::condition_variable mDone;
         Jobs mJobs;
         std::map<osg::Vec3f, std::set<TilePosition>> mPushed;
+        TilePosition mPrioritizedPlayerTile;
+        TilePosition mPredictedPlayerTile;
+        bool mHasPredictedPlayerTile;
+        std::size_t mProcessedJobs;
+        std::chrono::steady_clock::duration mProcessedJobsLatency;
         Misc::ScopeGuarded<TilePosition> mPlayerTile;
         Misc::ScopeGuarded<boost::optional<std::chrono::steady_clock::time_point>> mFirstStart;
         NavMeshTilesCache mNavMeshTilesCache;
+        std::unique_ptr<NavMeshDiskCache> mNavMeshDiskCache;
         std::vector<std::thread> mThreads;
 
         void process() throw();
@@ -80,6 +102,8 @@ namespace DetourNavigator
 
         boost::optional<Job> getNextJob();
 
+        void updatePriorities();
+
         void writeDebugFiles(const Job& job, const RecastMesh* recastMesh) const;
 
         std::chrono::steady_clock::time_point setFirstStart(const std::chrono::steady_clock::time_point& value);
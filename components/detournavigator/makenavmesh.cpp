@@ -9,6 +9,7 @@
 #include "sharednavmesh.hpp"
 #include "flags.hpp"
 #include "navmeshtilescache.hpp"
+#include "navmeshdiskcache.hpp"
 
 #include <components/misc/convert.hpp>
 
@@ -496,7 +497,8 @@ namespace DetourNavigator
     UpdateNavMeshStatus updateNavMesh(const osg::Vec3f& agentHalfExtents, const RecastMesh* recastMesh,
         const TilePosition& changedTile, const TilePosition& playerTile,
         const std::vector<OffMeshConnection>& offMeshConnections, const Settings& settings,
-        const SharedNavMeshCacheItem& navMeshCacheItem, NavMeshTilesCache& navMeshTilesCache)
+        const SharedNavMeshCacheItem& navMeshCacheItem, NavMeshTilesCache& navMeshTilesCache,
+        NavMeshDiskCache* navMeshDiskCache)
     {
         log("update NavMesh with mutiple tiles:",
             " agentHeight=", std::setprecision(std::numeric_limits<float>::max_exponent10),
@@ -556,17 +558,28 @@ namespace DetourNavigator
 
         if (!cachedNavMeshData)
         {
-            const auto tileBounds = makeTileBounds(settings, changedTile);
-            const osg::Vec3f tileBorderMin(tileBounds.mMin.x(), recastMeshBounds.mMin.y() - 1, tileBounds.mMin.y());
-            const osg::Vec3f tileBorderMax(tileBounds.mMax.x(), recastMeshBounds.mMax.y() + 1, tileBounds.mMax.y());
+            NavMeshData navMeshData;
 
-            auto navMeshData = makeNavMeshTileData(agentHalfExtents, *recastMesh, offMeshConnections, changedTile,
-                tileBorderMin, tileBorderMax, settings);
+            if (navMeshDiskCache)
+                navMeshData = navMeshDiskCache->get(agentHalfExtents, changedTile, *recastMesh, offMeshConnections);
 
             if (!navMeshData.mValue)
             {
-                log("ignore add tile: NavMeshData is null");
-                return removeTile();
+                const auto tileBounds = makeTileBounds(settings, changedTile);
+                const osg::Vec3f tileBorderMin(tileBounds.mMin.x(), recastMeshBounds.mMin.y() - 1, tileBounds.mMin.y());
+                const osg::Vec3f tileBorderMax(tileBounds.mMax.x(), recastMeshBounds.mMax.y() + 1, tileBounds.mMax.y());
+
+                navMeshData = makeNavMeshTileData(agentHalfExtents, *recastMesh, offMeshConnections, changedTile,
+                    tileBorderMin, tileBorderMax, settings);
+
+                if (!navMeshData.mValue)
+                {
+                    log("ignore add tile: NavMeshData is null");
+                    return removeTile();
+                }
+
+                if (navMeshDiskCache)
+                    navMeshDiskCache->set(agentHalfExtents, changedTile, *recastMesh, offMeshConnections, navMeshData);
             }
 
             try
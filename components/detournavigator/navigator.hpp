@@ -7,6 +7,11 @@
 #include "objectid.hpp"
 #include "navmeshcacheitem.hpp"
 
+namespace osg
+{
+    class Stats;
+}
+
 namespace DetourNavigator
 {
     struct ObjectShapes
@@ -46,7 +51,7 @@ namespace DetourNavigator
         /**
          * @brief addAgent should be called for each agent even if all of them has same half extents.
          * @param agentHalfExtents allows to setup bounding cylinder for each agent, for each different half extents
-         * there is different navmesh.
+         * there is different navmesh. Half extents are rounded up by Settings::mAgentHalfExtentsStep.
          */
         virtual void addAgent(const osg::Vec3f& agentHalfExtents) = 0;
 
@@ -143,6 +148,13 @@ namespace DetourNavigator
          */
         virtual void update(const osg::Vec3f& playerPosition) = 0;
 
+        /**
+         * @brief setPredictedPlayerPosition reorders pending tiles updates to build first the ones closer to the way
+         * from current to predicted player position, so moving player doesn't wait for tiles behind.
+         * @param predictedPlayerPosition where player is expected to be soon.
+         */
+        virtual void setPredictedPlayerPosition(const osg::Vec3f& predictedPlayerPosition) = 0;
+
         /**
          * @brief wait locks thread until all tiles are updated from last update call.
          */
@@ -192,6 +204,12 @@ namespace DetourNavigator
         virtual std::map<osg::Vec3f, SharedNavMeshCacheItem> getNavMeshes() const = 0;
 
         virtual Settings getSettings() const = 0;
+
+        /**
+         * @brief reportStats reports nav mesh update queue size, average latency of tiles updates since last report
+         * and totals of nav mesh disk cache use to stats
+         */
+        virtual void reportStats(unsigned int frameNumber, osg::Stats& stats) = 0;
     };
 }
 
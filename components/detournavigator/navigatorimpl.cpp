@@ -14,17 +14,19 @@ namespace DetourNavigator
 
     void NavigatorImpl::addAgent(const osg::Vec3f& agentHalfExtents)
     {
-        ++mAgents[agentHalfExtents];
-        mNavMeshManager.addAgent(agentHalfExtents);
+        const auto bucket = getAgentHalfExtentsBucket(mSettings, agentHalfExtents);
+        ++mAgents[bucket];
+        mNavMeshManager.addAgent(bucket);
     }
 
     void NavigatorImpl::removeAgent(const osg::Vec3f& agentHalfExtents)
     {
-        const auto it = mAgents.find(agentHalfExtents);
+        const auto bucket = getAgentHalfExtentsBucket(mSettings, agentHalfExtents);
+        const auto it = mAgents.find(bucket);
         if (it == mAgents.end() || --it->second)
             return;
         mAgents.erase(it);
-        mNavMeshManager.reset(agentHalfExtents);
+        mNavMeshManager.reset(bucket);
     }
 
     bool NavigatorImpl::addObject(const ObjectId id, const btCollisionShape& shape, const btTransform& transform)
@@ -117,6 +119,11 @@ namespace DetourNavigator
             mNavMeshManager.update(playerPosition, v.first);
     }
 
+    void NavigatorImpl::setPredictedPlayerPosition(const osg::Vec3f& predictedPlayerPosition)
+    {
+        mNavMeshManager.setPredictedPlayerPosition(predictedPlayerPosition);
+    }
+
     void NavigatorImpl::wait()
     {
         mNavMeshManager.wait();
@@ -124,7 +131,7 @@ namespace DetourNavigator
 
     SharedNavMeshCacheItem NavigatorImpl::getNavMesh(const osg::Vec3f& agentHalfExtents) const
     {
-        return mNavMeshManager.getNavMesh(agentHalfExtents);
+        return mNavMeshManager.getNavMesh(getAgentHalfExtentsBucket(mSettings, agentHalfExtents));
     }
 
     std::map<osg::Vec3f, SharedNavMeshCacheItem> NavigatorImpl::getNavMeshes() const
@@ -137,6 +144,11 @@ namespace DetourNavigator
         return mSettings;
     }
 
+    void NavigatorImpl::reportStats(unsigned int frameNumber, osg::Stats& stats)
+    {
+        mNavMeshManager.reportStats(frameNumber, stats);
+    }
+
     void NavigatorImpl::updateAvoidShapeId(const ObjectId id, const ObjectId avoidId)
     {
         updateId(id, avoidId, mWaterIds);
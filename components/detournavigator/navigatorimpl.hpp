@@ -40,6 +40,8 @@ namespace DetourNavigator
 
         void update(const osg::Vec3f& playerPosition) override;
 
+        void setPredictedPlayerPosition(const osg::Vec3f& predictedPlayerPosition) override;
+
         void wait() override;
 
         SharedNavMeshCacheItem getNavMesh(const osg::Vec3f& agentHalfExtents) const override;
@@ -48,6 +50,8 @@ namespace DetourNavigator
 
         Settings getSettings() const override;
 
+        void reportStats(unsigned int frameNumber, osg::Stats& stats) override;
+
     private:
         Settings mSettings;
         NavMeshManager mNavMeshManager;
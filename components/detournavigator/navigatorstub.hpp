@@ -61,6 +61,8 @@ namespace DetourNavigator
 
         void update(const osg::Vec3f& /*playerPosition*/) override {}
 
+        void setPredictedPlayerPosition(const osg::Vec3f& /*predictedPlayerPosition*/) override {}
+
         void wait() override {}
 
         SharedNavMeshCacheItem getNavMesh(const osg::Vec3f& /*agentHalfExtents*/) const override
@@ -77,6 +79,8 @@ namespace DetourNavigator
         {
             return Settings {};
         }
+
+        void reportStats(unsigned int /*frameNumber*/, osg::Stats& /*stats*/) override {}
     };
 }
 
@@ -0,0 +1,238 @@
+#include "navmeshdiskcache.hpp"
+#include "debug.hpp"
+#include "settings.hpp"
+
+#include <DetourAlloc.h>
+#include <DetourNavMesh.h>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <stdexcept>
+
+namespace DetourNavigator
+{
+    namespace
+    {
+        /// Increase when the record layout or the meaning of the hashed data changes.
+        const std::uint32_t formatVersion = 3;
+        const std::uint32_t magic = 0x434e4d4f; // "OMNC"
+        const std::uint64_t headerSize = 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t);
+        const std::uint64_t recordHeaderSize = 3 * sizeof(float) + 3 * sizeof(std::int32_t) + 3 * sizeof(std::uint64_t);
+
+        /// Covers everything besides the input geometry that changes the generated tiles.
+        std::uint64_t getSettingsHash(const Settings& settings)
+        {
+            Hash128 hash;
+            hash.addValue(DT_NAVMESH_VERSION);
+            hash.addValue(settings.mCellHeight);
+            hash.addValue(settings.mCellSize);
+            hash.addValue(settings.mDetailSampleDist);
+            hash.addValue(settings.mDetailSampleMaxError);
+            hash.addValue(settings.mMaxClimb);
+            hash.addValue(settings.mMaxSimplificationError);
+            hash.addValue(settings.mMaxSlope);
+            hash.addValue(settings.mRecastScaleFactor);
+            hash.addValue(settings.mSwimHeightScale);
+            hash.addValue(settings.mBorderSize);
+            hash.addValue(settings.mMaxEdgeLen);
+            hash.addValue(settings.mMaxPolys);
+            hash.addValue(settings.mMaxVertsPerPoly);
+            hash.addValue(settings.mRegionMergeSize);
+            hash.addValue(settings.mRegionMinSize);
+            hash.addValue(settings.mTileSize);
+            return hash.getValue().mHigh;
+        }
+
+        template <class T>
+        void write(std::ostream& stream, const T& value)
+        {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        template <class T>
+        bool read(std::istream& stream, T& value)
+        {
+            return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(value)));
+        }
+    }
+
+    NavMeshDiskCache::NavMeshDiskCache(const std::string& path, const Settings& settings)
+        : mPath(path)
+        , mSettingsHash(getSettingsHash(settings))
+        , mMaxFileSize(settings.mMaxNavMeshDiskCacheSize)
+        , mFileSize(0)
+        , mHits(0)
+        , mMisses(0)
+    {
+        open();
+    }
+
+    NavMeshData NavMeshDiskCache::get(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+        const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections)
+    {
+        const auto key = makeKey(agentHalfExtents, changedTile, recastMesh, offMeshConnections);
+
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        const auto record = mRecords.find(key);
+        if (record == mRecords.end())
+        {
+            ++mMisses;
+            return NavMeshData();
+        }
+
+        NavMeshData result(static_cast<unsigned char*>(dtAlloc(record->second.mSize, DT_ALLOC_PERM)),
+                           record->second.mSize);
+        if (!result.mValue)
+        {
+            ++mMisses;
+            return NavMeshData();
+        }
+
+        mFile.clear();
+        mFile.seekg(static_cast<std::streamoff>(record->second.mOffset));
+        if (!mFile.read(reinterpret_cast<char*>(result.mValue.get()), result.mSize))
+        {
+            log("failed to read nav mesh tile from disk cache at offset ", record->second.mOffset);
+            mRecords.erase(record);
+            ++mMisses;
+            return NavMeshData();
+        }
+
+        ++mHits;
+        return result;
+    }
+
+    void NavMeshDiskCache::set(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+        const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections,
+        const NavMeshData& value)
+    {
+        const auto key = makeKey(agentHalfExtents, changedTile, recastMesh, offMeshConnections);
+
+        const std::lock_guard<std::mutex> lock(mMutex);
+
+        if (mRecords.count(key))
+            return;
+
+        const auto recordSize = recordHeaderSize + static_cast<std::uint64_t>(value.mSize);
+        if (mFileSize + recordSize > mMaxFileSize)
+            return;
+
+        mFile.clear();
+        mFile.seekp(static_cast<std::streamoff>(mFileSize));
+        for (int i = 0; i < 3; ++i)
+            write(mFile, key.mAgentHalfExtents[i]);
+        write(mFile, std::int32_t(key.mChangedTile.x()));
+        write(mFile, std::int32_t(key.mChangedTile.y()));
+        write(mFile, key.mNavMeshKey.mHigh);
+        write(mFile, key.mNavMeshKey.mLow);
+        write(mFile, key.mNavMeshKey.mSize);
+        write(mFile, std::int32_t(value.mSize));
+        mFile.write(reinterpret_cast<const char*>(value.mValue.get()), value.mSize);
+        mFile.flush();
+
+        // An incomplete record is overwritten by the next one or dropped when the file is opened again
+        if (!mFile)
+        {
+            log("failed to write nav mesh tile to disk cache at offset ", mFileSize);
+            return;
+        }
+
+        mRecords.emplace(key, Record {mFileSize + recordHeaderSize, value.mSize});
+        mFileSize += recordSize;
+    }
+
+    NavMeshDiskCache::Stats NavMeshDiskCache::getStats() const
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        return Stats {mHits, mMisses, mRecords.size(), static_cast<std::size_t>(mFileSize)};
+    }
+
+    void NavMeshDiskCache::open()
+    {
+        if (boost::filesystem::exists(mPath))
+        {
+            mFile.open(mPath, std::ios::in | std::ios::out | std::ios::binary);
+            if (mFile.is_open() && readIndex())
+                return;
+            mFile.close();
+            log("nav mesh disk cache ", mPath, " is outdated or broken, creating new one");
+        }
+        create();
+    }
+
+    void NavMeshDiskCache::create()
+    {
+        mRecords.clear();
+        mFile.clear();
+        mFile.open(mPath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!mFile.is_open())
+            throw std::runtime_error("Failed to create nav mesh disk cache file: " + mPath);
+        write(mFile, magic);
+        write(mFile, formatVersion);
+        write(mFile, mSettingsHash);
+        mFile.flush();
+        if (!mFile)
+            throw std::runtime_error("Failed to write nav mesh disk cache file: " + mPath);
+        mFileSize = headerSize;
+    }
+
+    bool NavMeshDiskCache::readIndex()
+    {
+        std::uint32_t fileMagic = 0;
+        std::uint32_t fileFormatVersion = 0;
+        std::uint64_t fileSettingsHash = 0;
+        if (!read(mFile, fileMagic) || fileMagic != magic
+                || !read(mFile, fileFormatVersion) || fileFormatVersion != formatVersion
+                || !read(mFile, fileSettingsHash) || fileSettingsHash != mSettingsHash)
+            return false;
+
+        mFile.seekg(0, std::ios::end);
+        const auto fileSize = static_cast<std::uint64_t>(mFile.tellg());
+
+        std::uint64_t offset = headerSize;
+        while (offset + recordHeaderSize <= fileSize)
+        {
+            Key key;
+            std::int32_t x = 0;
+            std::int32_t y = 0;
+            std::int32_t size = 0;
+            mFile.seekg(static_cast<std::streamoff>(offset));
+            bool valid = true;
+            for (int i = 0; i < 3; ++i)
+                valid = valid && read(mFile, key.mAgentHalfExtents[i]);
+            valid = valid && read(mFile, x) && read(mFile, y) && read(mFile, key.mNavMeshKey.mHigh)
+                && read(mFile, key.mNavMeshKey.mLow) && read(mFile, key.mNavMeshKey.mSize) && read(mFile, size);
+            if (!valid || size <= 0 || offset + recordHeaderSize + static_cast<std::uint64_t>(size) > fileSize)
+                break;
+            key.mChangedTile = TilePosition(x, y);
+            mRecords[key] = Record {offset + recordHeaderSize, size};
+            offset += recordHeaderSize + static_cast<std::uint64_t>(size);
+        }
+
+        if (offset < fileSize)
+        {
+            log("drop incomplete record from nav mesh disk cache at offset ", offset);
+            mFile.close();
+            boost::system::error_code error;
+            boost::filesystem::resize_file(mPath, offset, error);
+            if (error)
+                return false;
+            mFile.clear();
+            mFile.open(mPath, std::ios::in | std::ios::out | std::ios::binary);
+            if (!mFile.is_open())
+                return false;
+        }
+
+        mFile.clear();
+        mFileSize = offset;
+        return true;
+    }
+
+    NavMeshDiskCache::Key NavMeshDiskCache::makeKey(const osg::Vec3f& agentHalfExtents,
+        const TilePosition& changedTile, const RecastMesh& recastMesh,
+        const std::vector<OffMeshConnection>& offMeshConnections)
+    {
+        return Key {agentHalfExtents, changedTile, makeNavMeshKey(recastMesh, offMeshConnections)};
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVMESHDISKCACHE_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVMESHDISKCACHE_H
+
+#include "navmeshdata.hpp"
+#include "navmeshkey.hpp"
+#include "offmeshconnection.hpp"
+#include "tileposition.hpp"
+
+#include <osg/Vec3f>
+
+#include <boost/filesystem/fstream.hpp>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace DetourNavigator
+{
+    class RecastMesh;
+    struct Settings;
+
+    /**
+     * @brief NavMeshDiskCache keeps generated nav mesh tiles in a file to reuse them in the next sessions.
+     * Tiles are identified by agent half extents, tile position and NavMeshKey of the recast mesh and off mesh
+     * connections used to generate them. The file is an append-only sequence of records indexed in memory when opened. It is
+     * started anew when it was written with different generation settings.
+     */
+    class NavMeshDiskCache
+    {
+    public:
+        struct Stats
+        {
+            std::size_t mHits;
+            std::size_t mMisses;
+            std::size_t mTiles;
+            std::size_t mFileSize;
+        };
+
+        /**
+         * @throws std::runtime_error if the file can't be opened or created
+         */
+        NavMeshDiskCache(const std::string& path, const Settings& settings);
+
+        /**
+         * @return NavMeshData with null value if there is no such tile
+         */
+        NavMeshData get(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+            const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections);
+
+        /**
+         * @brief set writes tile to the file unless it is already there or the file would exceed max size
+         */
+        void set(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+            const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections,
+            const NavMeshData& value);
+
+        Stats getStats() const;
+
+    private:
+        struct Key
+        {
+            osg::Vec3f mAgentHalfExtents;
+            TilePosition mChangedTile;
+            NavMeshKey mNavMeshKey;
+
+            friend inline bool operator <(const Key& lhs, const Key& rhs)
+            {
+                return std::tie(lhs.mAgentHalfExtents, lhs.mChangedTile, lhs.mNavMeshKey)
+                    < std::tie(rhs.mAgentHalfExtents, rhs.mChangedTile, rhs.mNavMeshKey);
+            }
+        };
+
+        struct Record
+        {
+            std::uint64_t mOffset;
+            int mSize;
+        };
+
+        const std::string mPath;
+        const std::uint64_t mSettingsHash;
+        const std::uint64_t mMaxFileSize;
+        mutable std::mutex mMutex;
+        boost::filesystem::fstream mFile;
+        std::uint64_t mFileSize;
+        std::map<Key, Record> mRecords;
+        std::size_t mHits;
+        std::size_t mMisses;
+
+        void open();
+
+        void create();
+
+        bool readIndex();
+
+        static Key makeKey(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
+            const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections);
+    };
+}
+
+#endif
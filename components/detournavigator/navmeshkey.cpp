@@ -0,0 +1,221 @@
+#include "navmeshkey.hpp"
+#include "recastmesh.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace DetourNavigator
+{
+    namespace
+    {
+        const std::uint64_t c1 = 0x87c37b91114253d5ull;
+        const std::uint64_t c2 = 0x4cf5ad432745937full;
+
+        inline std::uint64_t rotl(std::uint64_t value, int shift)
+        {
+            return (value << shift) | (value >> (64 - shift));
+        }
+
+        inline std::uint64_t fmix(std::uint64_t value)
+        {
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccdull;
+            value ^= value >> 33;
+            value *= 0xc4ceb9fe1a85ec53ull;
+            value ^= value >> 33;
+            return value;
+        }
+
+        inline std::uint64_t load(const unsigned char* data, std::size_t size)
+        {
+            std::uint64_t result = 0;
+            for (std::size_t i = 0; i < size; ++i)
+                result |= std::uint64_t(data[i]) << (8 * i);
+            return result;
+        }
+
+        template <class Visitor>
+        void visitNavMeshKeyParts(const RecastMesh& recastMesh,
+            const std::vector<OffMeshConnection>& offMeshConnections, Visitor&& visitor)
+        {
+            visitor(recastMesh.getIndices());
+            visitor(recastMesh.getVertices());
+            visitor(recastMesh.getAreaTypes());
+            // Water has padding bytes with unspecified values, only its fields identify it
+            for (const RecastMesh::Water& water : recastMesh.getWater())
+            {
+                visitor(water.mCellSize);
+                const btMatrix3x3& basis = water.mTransform.getBasis();
+                for (int row = 0; row < 3; ++row)
+                    for (int column = 0; column < 3; ++column)
+                        visitor(basis[row][column]);
+                const btVector3& origin = water.mTransform.getOrigin();
+                for (int i = 0; i < 3; ++i)
+                    visitor(origin[i]);
+            }
+            visitor(offMeshConnections);
+        }
+
+        struct AddToHash
+        {
+            Hash128& mHash;
+
+            template <class T>
+            void operator ()(const std::vector<T>& values) const
+            {
+                mHash.add(values);
+            }
+
+            template <class T>
+            void operator ()(const T& value) const
+            {
+                mHash.addValue(value);
+            }
+        };
+
+        struct AddSize
+        {
+            std::size_t& mSize;
+
+            template <class T>
+            void operator ()(const std::vector<T>& values) const
+            {
+                mSize += values.size() * sizeof(T);
+            }
+
+            template <class T>
+            void operator ()(const T& /*value*/) const
+            {
+                mSize += sizeof(T);
+            }
+        };
+
+        struct AppendToString
+        {
+            std::string& mString;
+
+            template <class T>
+            void operator ()(const std::vector<T>& values) const
+            {
+                mString.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+            }
+
+            template <class T>
+            void operator ()(const T& value) const
+            {
+                mString.append(reinterpret_cast<const char*>(&value), sizeof(T));
+            }
+        };
+    }
+
+    Hash128::Hash128(std::uint64_t seed)
+        : mH1(seed)
+        , mH2(seed)
+        , mSize(0)
+        , mTailSize(0)
+    {
+    }
+
+    void Hash128::add(const void* data, std::size_t size)
+    {
+        auto bytes = static_cast<const unsigned char*>(data);
+        mSize += size;
+
+        if (mTailSize > 0)
+        {
+            const auto count = std::min(size, sizeof(mTail) - mTailSize);
+            std::memcpy(mTail + mTailSize, bytes, count);
+            mTailSize += count;
+            bytes += count;
+            size -= count;
+            if (mTailSize < sizeof(mTail))
+                return;
+            addBlock(mTail);
+            mTailSize = 0;
+        }
+
+        for (; size >= sizeof(mTail); bytes += sizeof(mTail), size -= sizeof(mTail))
+            addBlock(bytes);
+
+        std::memcpy(mTail, bytes, size);
+        mTailSize = size;
+    }
+
+    NavMeshKey Hash128::getValue() const
+    {
+        std::uint64_t h1 = mH1;
+        std::uint64_t h2 = mH2;
+
+        if (mTailSize > 8)
+        {
+            std::uint64_t k2 = load(mTail + 8, mTailSize - 8);
+            k2 *= c2;
+            k2 = rotl(k2, 33);
+            k2 *= c1;
+            h2 ^= k2;
+        }
+
+        if (mTailSize > 0)
+        {
+            std::uint64_t k1 = load(mTail, std::min(mTailSize, std::size_t(8)));
+            k1 *= c1;
+            k1 = rotl(k1, 31);
+            k1 *= c2;
+            h1 ^= k1;
+        }
+
+        h1 ^= mSize;
+        h2 ^= mSize;
+        h1 += h2;
+        h2 += h1;
+        h1 = fmix(h1);
+        h2 = fmix(h2);
+        h1 += h2;
+        h2 += h1;
+
+        return NavMeshKey {h1, h2, mSize};
+    }
+
+    void Hash128::addBlock(const unsigned char* block)
+    {
+        // Native byte order, like the reference implementation
+        std::uint64_t k1;
+        std::uint64_t k2;
+        std::memcpy(&k1, block, sizeof(k1));
+        std::memcpy(&k2, block + sizeof(k1), sizeof(k2));
+
+        k1 *= c1;
+        k1 = rotl(k1, 31);
+        k1 *= c2;
+        mH1 ^= k1;
+        mH1 = rotl(mH1, 27);
+        mH1 += mH2;
+        mH1 = mH1 * 5 + 0x52dce729;
+
+        k2 *= c2;
+        k2 = rotl(k2, 33);
+        k2 *= c1;
+        mH2 ^= k2;
+        mH2 = rotl(mH2, 31);
+        mH2 += mH1;
+        mH2 = mH2 * 5 + 0x38495ab5;
+    }
+
+    NavMeshKey makeNavMeshKey(const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections)
+    {
+        Hash128 hash;
+        visitNavMeshKeyParts(recastMesh, offMeshConnections, AddToHash {hash});
+        return hash.getValue();
+    }
+
+    std::string makeNavMeshKeyData(const RecastMesh& recastMesh,
+        const std::vector<OffMeshConnection>& offMeshConnections)
+    {
+        std::size_t size = 0;
+        visitNavMeshKeyParts(recastMesh, offMeshConnections, AddSize {size});
+        std::string result;
+        result.reserve(size);
+        visitNavMeshKeyParts(recastMesh, offMeshConnections, AppendToString {result});
+        return result;
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVMESHKEY_H
+#define OPENMW_COMPONENTS_DETOURNAVIGATOR_NAVMESHKEY_H
+
+#include "offmeshconnection.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace DetourNavigator
+{
+    class RecastMesh;
+
+    /**
+     * @brief NavMeshKey identifies the input of nav mesh tile generation by 128-bit MurmurHash3 of recast mesh
+     * and off mesh connections data and the size of this data.
+     */
+    struct NavMeshKey
+    {
+        std::uint64_t mHigh;
+        std::uint64_t mLow;
+        std::uint64_t mSize;
+
+        friend inline bool operator ==(const NavMeshKey& lhs, const NavMeshKey& rhs)
+        {
+            return std::tie(lhs.mHigh, lhs.mLow, lhs.mSize) == std::tie(rhs.mHigh, rhs.mLow, rhs.mSize);
+        }
+
+        friend inline bool operator <(const NavMeshKey& lhs, const NavMeshKey& rhs)
+        {
+            return std::tie(lhs.mHigh, lhs.mLow, lhs.mSize) < std::tie(rhs.mHigh, rhs.mLow, rhs.mSize);
+        }
+    };
+
+    /**
+     * @brief Streaming MurmurHash3_x64_128 giving the same result for data split into any number of parts.
+     */
+    class Hash128
+    {
+    public:
+        explicit Hash128(std::uint64_t seed = 0);
+
+        void add(const void* data, std::size_t size);
+
+        template <class T>
+        void add(const std::vector<T>& values)
+        {
+            add(values.data(), values.size() * sizeof(T));
+        }
+
+        template <class T>
+        void addValue(const T& value)
+        {
+            add(&value, sizeof(value));
+        }
+
+        NavMeshKey getValue() const;
+
+    private:
+        std::uint64_t mH1;
+        std::uint64_t mH2;
+        std::uint64_t mSize;
+        unsigned char mTail[16];
+        std::size_t mTailSize;
+
+        void addBlock(const unsigned char* block);
+    };
+
+    NavMeshKey makeNavMeshKey(const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections);
+
+    /**
+     * @return all data hashed by makeNavMeshKey to compare inputs with the same key
+     */
+    std::string makeNavMeshKeyData(const RecastMesh& recastMesh,
+        const std::vector<OffMeshConnection>& offMeshConnections);
+}
+
+#endif
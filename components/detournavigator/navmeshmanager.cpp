@@ -176,6 +176,12 @@ namespace DetourNavigator
             " recastMeshManagerRevision=", lastRevision);
     }
 
+    void NavMeshManager::setPredictedPlayerPosition(osg::Vec3f predictedPlayerPosition)
+    {
+        mAsyncNavMeshUpdater.setPredictedPlayerTile(
+            getTilePosition(mSettings, toNavMeshCoordinates(mSettings, predictedPlayerPosition)));
+    }
+
     void NavMeshManager::wait()
     {
         mAsyncNavMeshUpdater.wait();
@@ -191,6 +197,11 @@ namespace DetourNavigator
         return mCache;
     }
 
+    void NavMeshManager::reportStats(unsigned int frameNumber, osg::Stats& stats)
+    {
+        mAsyncNavMeshUpdater.reportStats(frameNumber, stats);
+    }
+
     void NavMeshManager::addChangedTiles(const btCollisionShape& shape, const btTransform& transform,
             const ChangeType changeType)
     {
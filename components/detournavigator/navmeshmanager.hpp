@@ -44,12 +44,16 @@ namespace DetourNavigator
 
         void update(osg::Vec3f playerPosition, const osg::Vec3f& agentHalfExtents);
 
+        void setPredictedPlayerPosition(osg::Vec3f predictedPlayerPosition);
+
         void wait();
 
         SharedNavMeshCacheItem getNavMesh(const osg::Vec3f& agentHalfExtents) const;
 
         std::map<osg::Vec3f, SharedNavMeshCacheItem> getNavMeshes() const;
 
+        void reportStats(unsigned int frameNumber, osg::Stats& stats);
+
     private:
         const Settings& mSettings;
         TileCachedRecastMeshManager mRecastMeshManager;
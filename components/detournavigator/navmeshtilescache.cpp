@@ -1,56 +1,19 @@
 #include "navmeshtilescache.hpp"
+#include "debug.hpp"
 #include "exceptions.hpp"
 
 namespace DetourNavigator
 {
-    namespace
-    {
-        inline std::string makeNavMeshKey(const RecastMesh& recastMesh,
-            const std::vector<OffMeshConnection>& offMeshConnections)
-        {
-            std::string result;
-            result.reserve(
-                recastMesh.getIndices().size() * sizeof(int)
-                + recastMesh.getVertices().size() * sizeof(float)
-                + recastMesh.getAreaTypes().size() * sizeof(AreaType)
-                + recastMesh.getWater().size() * sizeof(RecastMesh::Water)
-                + offMeshConnections.size() * sizeof(OffMeshConnection)
-            );
-            std::copy(
-                reinterpret_cast<const char*>(recastMesh.getIndices().data()),
-                reinterpret_cast<const char*>(recastMesh.getIndices().data() + recastMesh.getIndices().size()),
-                std::back_inserter(result)
-            );
-            std::copy(
-                reinterpret_cast<const char*>(recastMesh.getVertices().data()),
-                reinterpret_cast<const char*>(recastMesh.getVertices().data() + recastMesh.getVertices().size()),
-                std::back_inserter(result)
-            );
-            std::copy(
-                reinterpret_cast<const char*>(recastMesh.getAreaTypes().data()),
-                reinterpret_cast<const char*>(recastMesh.getAreaTypes().data() + recastMesh.getAreaTypes().size()),
-                std::back_inserter(result)
-            );
-            std::copy(
-                reinterpret_cast<const char*>(recastMesh.getWater().data()),
-                reinterpret_cast<const char*>(recastMesh.getWater().data() + recastMesh.getWater().size()),
-                std::back_inserter(result)
-            );
-            std::copy(
-                reinterpret_cast<const char*>(offMeshConnections.data()),
-                reinterpret_cast<const char*>(offMeshConnections.data() + offMeshConnections.size()),
-                std::back_inserter(result)
-            );
-            return result;
-        }
-    }
-
-    NavMeshTilesCache::NavMeshTilesCache(const std::size_t maxNavMeshDataSize)
-        : mMaxNavMeshDataSize(maxNavMeshDataSize), mUsedNavMeshDataSize(0), mFreeNavMeshDataSize(0) {}
+    NavMeshTilesCache::NavMeshTilesCache(const std::size_t maxNavMeshDataSize, const bool verifyKeys)
+        : mVerifyKeys(verifyKeys), mMaxNavMeshDataSize(maxNavMeshDataSize), mUsedNavMeshDataSize(0),
+          mFreeNavMeshDataSize(0) {}
 
     NavMeshTilesCache::Value NavMeshTilesCache::get(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
         const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections)
     {
+        const auto navMeshKey = makeNavMeshKey(recastMesh, offMeshConnections);
+        const auto navMeshKeyData = mVerifyKeys ? makeNavMeshKeyData(recastMesh, offMeshConnections) : std::string();
+
         const std::lock_guard<std::mutex> lock(mMutex);
 
         const auto agentValues = mValues.find(agentHalfExtents);
@@ -61,11 +24,16 @@ namespace DetourNavigator
         if (tileValues == agentValues->second.end())
             return Value();
 
-        // TODO: use different function to make key to avoid unnecessary std::string allocation
-        const auto tile = tileValues->second.Map.find(makeNavMeshKey(recastMesh, offMeshConnections));
+        const auto tile = tileValues->second.Map.find(navMeshKey);
         if (tile == tileValues->second.Map.end())
             return Value();
 
+        if (tile->second->mNavMeshKeyData != navMeshKeyData)
+        {
+            log("nav mesh tiles cache key collision for agent=", agentHalfExtents, " tile=", changedTile);
+            return Value();
+        }
+
         acquireItemUnsafe(tile->second);
 
         return Value(*this, tile->second);
@@ -76,6 +44,8 @@ namespace DetourNavigator
         NavMeshData&& value)
     {
         const auto navMeshSize = static_cast<std::size_t>(value.mSize);
+        const auto navMeshKey = makeNavMeshKey(recastMesh, offMeshConnections);
+        auto navMeshKeyData = mVerifyKeys ? makeNavMeshKeyData(recastMesh, offMeshConnections) : std::string();
 
         const std::lock_guard<std::mutex> lock(mMutex);
 
@@ -85,8 +55,7 @@ namespace DetourNavigator
         if (navMeshSize > mFreeNavMeshDataSize + (mMaxNavMeshDataSize - mUsedNavMeshDataSize))
             return Value();
 
-        const auto navMeshKey = makeNavMeshKey(recastMesh, offMeshConnections);
-        const auto itemSize = navMeshSize + 2 * navMeshKey.size();
+        const auto itemSize = navMeshSize + 2 * sizeof(navMeshKey) + navMeshKeyData.size();
 
         if (itemSize > mFreeNavMeshDataSize + (mMaxNavMeshDataSize - mUsedNavMeshDataSize))
             return Value();
@@ -94,8 +63,8 @@ namespace DetourNavigator
         while (!mFreeItems.empty() && mUsedNavMeshDataSize + itemSize > mMaxNavMeshDataSize)
             removeLeastRecentlyUsed();
 
-        const auto iterator = mFreeItems.emplace(mFreeItems.end(), agentHalfExtents, changedTile, navMeshKey);
-        // TODO: use std::string_view or some alternative to avoid navMeshKey copy into both mFreeItems and mValues
+        const auto iterator = mFreeItems.emplace(mFreeItems.end(), agentHalfExtents, changedTile, navMeshKey,
+                                                 std::move(navMeshKeyData));
         const auto emplaced = mValues[agentHalfExtents][changedTile].Map.emplace(navMeshKey, iterator);
 
         if (!emplaced.second)
@@ -3,6 +3,7 @@
 
 #include "offmeshconnection.hpp"
 #include "navmeshdata.hpp"
+#include "navmeshkey.hpp"
 #include "recastmesh.hpp"
 #include "tileposition.hpp"
 
@@ -27,14 +28,17 @@ namespace DetourNavigator
             std::atomic<std::int64_t> mUseCount;
             osg::Vec3f mAgentHalfExtents;
             TilePosition mChangedTile;
-            std::string mNavMeshKey;
+            NavMeshKey mNavMeshKey;
+            std::string mNavMeshKeyData;
             NavMeshData mNavMeshData;
 
-            Item(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile, std::string navMeshKey)
+            Item(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile, const NavMeshKey& navMeshKey,
+                    std::string navMeshKeyData)
                 : mUseCount(0)
                 , mAgentHalfExtents(agentHalfExtents)
                 , mChangedTile(changedTile)
-                , mNavMeshKey(std::move(navMeshKey))
+                , mNavMeshKey(navMeshKey)
+                , mNavMeshKeyData(std::move(navMeshKeyData))
             {}
         };
 
@@ -95,7 +99,11 @@ namespace DetourNavigator
             ItemIterator mIterator;
         };
 
-        NavMeshTilesCache(const std::size_t maxNavMeshDataSize);
+        /**
+         * @param verifyKeys keep all the data hashed into the key of each item and compare it on lookup
+         * to never return a tile for other input with the same key at the cost of memory
+         */
+        NavMeshTilesCache(const std::size_t maxNavMeshDataSize, const bool verifyKeys = false);
 
         Value get(const osg::Vec3f& agentHalfExtents, const TilePosition& changedTile,
             const RecastMesh& recastMesh, const std::vector<OffMeshConnection>& offMeshConnections);
@@ -108,10 +116,11 @@ namespace DetourNavigator
 
         struct TileMap
         {
-            std::map<std::string, ItemIterator> Map;
+            std::map<NavMeshKey, ItemIterator> Map;
         };
 
         std::mutex mMutex;
+        const bool mVerifyKeys;
         std::size_t mMaxNavMeshDataSize;
         std::size_t mUsedNavMeshDataSize;
         std::size_t mFreeNavMeshDataSize;
@@ -127,7 +136,8 @@ namespace DetourNavigator
 
         static std::size_t getSize(const Item& item)
         {
-            return static_cast<std::size_t>(item.mNavMeshData.mSize) + 2 * item.mNavMeshKey.size();
+            return static_cast<std::size_t>(item.mNavMeshData.mSize) + 2 * sizeof(item.mNavMeshKey)
+                + item.mNavMeshKeyData.size();
         }
     };
 }
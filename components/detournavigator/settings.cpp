@@ -11,6 +11,7 @@ namespace DetourNavigator
 
         Settings navigatorSettings;
 
+        navigatorSettings.mAgentHalfExtentsStep = ::Settings::Manager::getFloat("agent half extents step", "Navigator");
         navigatorSettings.mBorderSize = ::Settings::Manager::getInt("border size", "Navigator");
         navigatorSettings.mCellHeight = ::Settings::Manager::getFloat("cell height", "Navigator");
         navigatorSettings.mCellSize = ::Settings::Manager::getFloat("cell size", "Navigator");
@@ -30,6 +31,9 @@ namespace DetourNavigator
         navigatorSettings.mTileSize = ::Settings::Manager::getInt("tile size", "Navigator");
         navigatorSettings.mAsyncNavMeshUpdaterThreads = static_cast<std::size_t>(::Settings::Manager::getInt("async nav mesh updater threads", "Navigator"));
         navigatorSettings.mMaxNavMeshTilesCacheSize = static_cast<std::size_t>(::Settings::Manager::getInt("max nav mesh tiles cache size", "Navigator"));
+        navigatorSettings.mVerifyNavMeshTilesCacheKeys = ::Settings::Manager::getBool("verify nav mesh tiles cache keys", "Navigator");
+        navigatorSettings.mEnableNavMeshDiskCache = ::Settings::Manager::getBool("enable nav mesh disk cache", "Navigator");
+        navigatorSettings.mMaxNavMeshDiskCacheSize = static_cast<std::size_t>(::Settings::Manager::getInt("max nav mesh disk cache size", "Navigator"));
         navigatorSettings.mMaxPolygonPathSize = static_cast<std::size_t>(::Settings::Manager::getInt("max polygon path size", "Navigator"));
         navigatorSettings.mMaxSmoothPathSize = static_cast<std::size_t>(::Settings::Manager::getInt("max smooth path size", "Navigator"));
         navigatorSettings.mTrianglesPerChunk = static_cast<std::size_t>(::Settings::Manager::getInt("triangles per chunk", "Navigator"));
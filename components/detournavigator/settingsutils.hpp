@@ -12,6 +12,8 @@
 #include <osg/Vec2i>
 #include <osg/Vec3f>
 
+#include <algorithm>
+#include <cmath>
 #include <utility>
 
 namespace DetourNavigator
@@ -31,6 +33,18 @@ namespace DetourNavigator
         return agentHalfExtents.x() * settings.mRecastScaleFactor;
     }
 
+    /// Rounds agent half extents up to multiple of mAgentHalfExtentsStep so agents of close sizes share navmesh.
+    /// Horizontal half extents are made equal because radius is the only horizontal size of recast agent.
+    inline osg::Vec3f getAgentHalfExtentsBucket(const Settings& settings, const osg::Vec3f& agentHalfExtents)
+    {
+        const auto step = settings.mAgentHalfExtentsStep;
+        if (step <= 0)
+            return agentHalfExtents;
+        const auto roundUp = [&] (float value) { return std::ceil(value / step) * step; };
+        const auto radius = roundUp(std::max(agentHalfExtents.x(), agentHalfExtents.y()));
+        return osg::Vec3f(radius, radius, roundUp(agentHalfExtents.z()));
+    }
+
     inline osg::Vec3f toNavMeshCoordinates(const Settings& settings, osg::Vec3f position)
     {
         std::swap(position.y(), position.z());
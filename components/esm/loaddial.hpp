@@ -63,6 +63,10 @@ struct Dialogue
     /// @param merge Merge with existing list, or just push each record to the end of the list?
     void readInfo (ESM::ESMReader& esm, bool merge);
 
+    /// Add an info record that has already been read
+    /// @param merge Merge with existing list, or just push each record to the end of the list?
+    void addInfo (const ESM::DialInfo& info, bool isDeleted, bool merge);
+
     void blank();
     ///< Set record to default state (does not touch the ID and does not change the type).
 };
@@ -0,0 +1,204 @@
+#include "memorymappedfile.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <sstream>
+#include <streambuf>
+
+#if FILE_API == FILE_API_POSIX
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#elif FILE_API == FILE_API_WIN32
+#include <boost/locale.hpp>
+#endif
+
+#if FILE_API != FILE_API_STDIO
+namespace
+{
+    void failOpen(const std::string& filename, const std::string& reason)
+    {
+        std::ostringstream os;
+        os << "Failed to map '" << filename << "' for reading: " << reason;
+        throw std::runtime_error (os.str ());
+    }
+}
+#endif
+
+namespace Files
+{
+
+#if FILE_API == FILE_API_STDIO
+
+    MemoryMappedFile::MemoryMappedFile(const std::string& filename)
+        : mData(nullptr)
+        , mSize(0)
+    {
+        LowLevelFile file;
+        file.open(filename.c_str());
+        mBuffer.resize(file.size());
+        if (!mBuffer.empty())
+            file.read(&mBuffer[0], mBuffer.size());
+        mData = mBuffer.data();
+        mSize = mBuffer.size();
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+    }
+
+#elif FILE_API == FILE_API_POSIX
+
+    MemoryMappedFile::MemoryMappedFile(const std::string& filename)
+        : mData(nullptr)
+        , mSize(0)
+    {
+        int fd = ::open(filename.c_str(), O_RDONLY, 0);
+        if (fd == -1)
+            failOpen(filename, strerror(errno));
+
+        struct stat info;
+        if (fstat(fd, &info) != 0)
+        {
+            const int error = errno;
+            ::close(fd);
+            failOpen(filename, strerror(error));
+        }
+
+        mSize = static_cast<size_t>(info.st_size);
+        if (mSize != 0)
+        {
+            void* data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED)
+            {
+                const int error = errno;
+                ::close(fd);
+                failOpen(filename, strerror(error));
+            }
+            mData = static_cast<const char*>(data);
+        }
+
+        // The mapping stays valid after the descriptor is closed
+        ::close(fd);
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        if (mData != nullptr)
+            munmap(const_cast<char*>(mData), mSize);
+    }
+
+#elif FILE_API == FILE_API_WIN32
+
+    MemoryMappedFile::MemoryMappedFile(const std::string& filename)
+        : mData(nullptr)
+        , mSize(0)
+        , mFile(INVALID_HANDLE_VALUE)
+        , mMapping(nullptr)
+    {
+        std::wstring wname = boost::locale::conv::utf_to_utf<wchar_t>(filename);
+        mFile = CreateFileW(wname.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 0, 0);
+        if (mFile == INVALID_HANDLE_VALUE)
+            failOpen(filename, "cannot open file");
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(mFile, &size))
+        {
+            CloseHandle(mFile);
+            failOpen(filename, "cannot query file size");
+        }
+        mSize = static_cast<size_t>(size.QuadPart);
+
+        if (mSize != 0)
+        {
+            mMapping = CreateFileMappingW(mFile, 0, PAGE_READONLY, 0, 0, 0);
+            if (mMapping == nullptr)
+            {
+                CloseHandle(mFile);
+                failOpen(filename, "cannot create file mapping");
+            }
+
+            mData = static_cast<const char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+            if (mData == nullptr)
+            {
+                CloseHandle(mMapping);
+                CloseHandle(mFile);
+                failOpen(filename, "cannot map view of file");
+            }
+        }
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        if (mData != nullptr)
+            UnmapViewOfFile(mData);
+        if (mMapping != nullptr)
+            CloseHandle(mMapping);
+        if (mFile != INVALID_HANDLE_VALUE)
+            CloseHandle(mFile);
+    }
+
+#endif
+
+    /// Reads straight out of the mapped region, so no buffer or file descriptor is involved.
+    class MemoryMappedFileStreamBuf : public std::streambuf
+    {
+    public:
+        MemoryMappedFileStreamBuf(const MemoryMappedFilePtr& file, size_t start, size_t length)
+            : mFile(file)
+        {
+            if (start > file->size())
+                throw std::runtime_error("Memory mapped stream starts outside of the file");
+
+            const size_t size = std::min(length, file->size() - start);
+            char* begin = const_cast<char*>(file->data() + start);
+            setg(begin, begin, begin + size);
+        }
+
+        virtual pos_type seekoff(off_type offset, std::ios_base::seekdir whence, std::ios_base::openmode mode)
+        {
+            if((mode&std::ios_base::out) || !(mode&std::ios_base::in))
+                return traits_type::eof();
+
+            off_type newPos;
+            switch (whence)
+            {
+                case std::ios_base::beg:
+                    newPos = offset;
+                    break;
+                case std::ios_base::cur:
+                    newPos = (gptr() - eback()) + offset;
+                    break;
+                case std::ios_base::end:
+                    newPos = (egptr() - eback()) + offset;
+                    break;
+                default:
+                    return traits_type::eof();
+            }
+
+            if (newPos < 0 || newPos > egptr() - eback())
+                return traits_type::eof();
+
+            setg(eback(), eback() + newPos, egptr());
+            return newPos;
+        }
+
+        virtual pos_type seekpos(pos_type pos, std::ios_base::openmode mode)
+        {
+            return seekoff(off_type(pos), std::ios_base::beg, mode);
+        }
+
+    private:
+        MemoryMappedFilePtr mFile;
+    };
+
+    IStreamPtr openMemoryMappedFileStream(const MemoryMappedFilePtr& file, size_t start, size_t length)
+    {
+        auto buf = std::unique_ptr<std::streambuf>(new MemoryMappedFileStreamBuf(file, start, length));
+        return IStreamPtr(new ConstrainedFileStream(std::move(buf)));
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef COMPONENTS_FILES_MEMORYMAPPEDFILE_HPP
+#define COMPONENTS_FILES_MEMORYMAPPEDFILE_HPP
+
+#include <memory>
+#include <vector>
+
+#include "lowlevelfile.hpp"
+#include "constrainedfilestream.hpp"
+
+namespace Files
+{
+
+/// A read-only view of a whole file, mapped into the address space once.
+/// @note Falls back to reading the file into memory when the platform has no mapping support.
+class MemoryMappedFile
+{
+public:
+    MemoryMappedFile(const std::string& filename);
+    ~MemoryMappedFile();
+
+    const char* data() const { return mData; }
+    size_t size() const { return mSize; }
+
+private:
+    MemoryMappedFile(const MemoryMappedFile&);
+    MemoryMappedFile& operator=(const MemoryMappedFile&);
+
+    const char* mData;
+    size_t mSize;
+
+#if FILE_API == FILE_API_STDIO
+    std::vector<char> mBuffer;
+#elif FILE_API == FILE_API_WIN32
+    HANDLE mFile;
+    HANDLE mMapping;
+#endif
+};
+
+typedef std::shared_ptr<const MemoryMappedFile> MemoryMappedFilePtr;
+
+/// Open a stream reading directly from a region of the mapping, without copying.
+/// @note The stream keeps the mapping alive.
+IStreamPtr openMemoryMappedFileStream(const MemoryMappedFilePtr& file, size_t start=0, size_t length=0xFFFFFFFF);
+
+}
+
+#endif
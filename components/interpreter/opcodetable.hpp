@@ -0,0 +1,82 @@
+#ifndef INTERPRETER_OPCODETABLE_H_INCLUDED
+#define INTERPRETER_OPCODETABLE_H_INCLUDED
+
+#include <cassert>
+#include <vector>
+
+namespace Interpreter
+{
+    /// \brief Opcodes of one code segment, indexed by opcode.
+    ///
+    /// The opcodes of a segment form a few dense ranges (the generic opcodes at the start of the
+    /// segment and the OpenMW extensions further up), so they are kept in flat pages of fixed size,
+    /// one for each range of opcodes that is in use.
+    template<class T>
+    class OpcodeTable
+    {
+            static const int sPageBits = 10;
+            static const int sPageSize = 1 << sPageBits;
+
+            struct Page
+            {
+                int mIndex;
+                std::vector<T *> mOpcodes;
+            };
+
+            std::vector<Page> mPages;
+
+            // not implemented
+            OpcodeTable (const OpcodeTable&);
+            OpcodeTable& operator= (const OpcodeTable&);
+
+        public:
+
+            OpcodeTable() {}
+
+            ~OpcodeTable()
+            {
+                for (typename std::vector<Page>::iterator page (mPages.begin()); page!=mPages.end(); ++page)
+                    for (typename std::vector<T *>::iterator iter (page->mOpcodes.begin());
+                        iter!=page->mOpcodes.end(); ++iter)
+                        delete *iter;
+            }
+
+            void install (int code, T *opcode)
+            ///< ownership of \a opcode is transferred to *this.
+            {
+                assert (code>=0);
+                assert (find (code)==nullptr);
+
+                const int index = code>>sPageBits;
+
+                typename std::vector<Page>::iterator page (mPages.begin());
+                while (page!=mPages.end() && page->mIndex!=index)
+                    ++page;
+
+                if (page==mPages.end())
+                {
+                    mPages.push_back (Page());
+                    page = mPages.end()-1;
+                    page->mIndex = index;
+                    page->mOpcodes.resize (sPageSize, nullptr);
+                }
+
+                page->mOpcodes[code & (sPageSize-1)] = opcode;
+            }
+
+            T *find (int code) const
+            ///< \return nullptr, if no opcode is installed for \a code.
+            {
+                const int index = code>>sPageBits;
+
+                // There are only a few pages per segment, a linear search is the fastest way to find them
+                for (typename std::vector<Page>::const_iterator page (mPages.begin()); page!=mPages.end(); ++page)
+                    if (page->mIndex==index)
+                        return page->mOpcodes[code & (sPageSize-1)];
+
+                return nullptr;
+            }
+    };
+}
+
+#endif
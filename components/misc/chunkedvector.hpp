@@ -0,0 +1,197 @@
+#ifndef OPENMW_COMPONENTS_MISC_CHUNKEDVECTOR_H
+#define OPENMW_COMPONENTS_MISC_CHUNKEDVECTOR_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace Misc
+{
+    /// \class ChunkedVector
+    /// Sequence container storing its elements in a few contiguous chunks that are never reallocated,
+    /// so that adding elements keeps pointers and references to the existing ones valid, like std::list,
+    /// while iterating over them touches mostly adjacent memory.
+    /// \note Each chunk is as large as all the chunks before it together, up to MaxChunkSize elements.
+    /// \attention Erasing an element moves the following elements of the same chunk.
+    template <class T, std::size_t MinChunkSize = 8, std::size_t MaxChunkSize = 1024>
+    class ChunkedVector
+    {
+        typedef std::vector<std::vector<T> > Chunks;
+
+        template <class Value, class ChunksType>
+        class Iterator
+        {
+            public:
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef T value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef Value* pointer;
+                typedef Value& reference;
+
+                Iterator() : mChunks(nullptr), mChunk(0), mIndex(0) {}
+
+                Iterator(ChunksType* chunks, std::size_t chunk, std::size_t index)
+                    : mChunks(chunks), mChunk(chunk), mIndex(index) {}
+
+                template <class OtherValue, class OtherChunks,
+                    class = typename std::enable_if<std::is_convertible<OtherChunks*, ChunksType*>::value>::type>
+                Iterator(const Iterator<OtherValue, OtherChunks>& other)
+                    : mChunks(other.mChunks), mChunk(other.mChunk), mIndex(other.mIndex) {}
+
+                reference operator*() const
+                {
+                    return (*mChunks)[mChunk][mIndex];
+                }
+
+                pointer operator->() const
+                {
+                    return &**this;
+                }
+
+                Iterator& operator++()
+                {
+                    if (++mIndex == (*mChunks)[mChunk].size())
+                    {
+                        ++mChunk;
+                        mIndex = 0;
+                    }
+                    return *this;
+                }
+
+                Iterator operator++(int)
+                {
+                    Iterator result = *this;
+                    ++*this;
+                    return result;
+                }
+
+                Iterator& operator--()
+                {
+                    if (mIndex == 0)
+                        mIndex = (*mChunks)[--mChunk].size();
+                    --mIndex;
+                    return *this;
+                }
+
+                Iterator operator--(int)
+                {
+                    Iterator result = *this;
+                    --*this;
+                    return result;
+                }
+
+                template <class OtherValue, class OtherChunks>
+                bool operator==(const Iterator<OtherValue, OtherChunks>& other) const
+                {
+                    return mChunks == other.mChunks && mChunk == other.mChunk && mIndex == other.mIndex;
+                }
+
+                template <class OtherValue, class OtherChunks>
+                bool operator!=(const Iterator<OtherValue, OtherChunks>& other) const
+                {
+                    return !(*this == other);
+                }
+
+            private:
+                template <class, class>
+                friend class Iterator;
+                friend class ChunkedVector;
+
+                ChunksType* mChunks;
+                std::size_t mChunk;
+                std::size_t mIndex;
+        };
+
+    public:
+        typedef T value_type;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef std::size_t size_type;
+        typedef Iterator<T, Chunks> iterator;
+        typedef Iterator<const T, const Chunks> const_iterator;
+
+        ChunkedVector() : mSize(0) {}
+
+        iterator begin() { return iterator(&mChunks, 0, 0); }
+        iterator end() { return iterator(&mChunks, mChunks.size(), 0); }
+        const_iterator begin() const { return const_iterator(&mChunks, 0, 0); }
+        const_iterator end() const { return const_iterator(&mChunks, mChunks.size(), 0); }
+
+        bool empty() const { return mSize == 0; }
+        std::size_t size() const { return mSize; }
+
+        reference front() { return mChunks.front().front(); }
+        const_reference front() const { return mChunks.front().front(); }
+        reference back() { return mChunks.back().back(); }
+        const_reference back() const { return mChunks.back().back(); }
+
+        void push_back(const T& value)
+        {
+            getLastChunk().push_back(value);
+            ++mSize;
+        }
+
+        void push_back(T&& value)
+        {
+            getLastChunk().push_back(std::move(value));
+            ++mSize;
+        }
+
+        template <class ... Args>
+        reference emplace_back(Args&& ... args)
+        {
+            std::vector<T>& chunk = getLastChunk();
+            chunk.emplace_back(std::forward<Args>(args) ...);
+            ++mSize;
+            return chunk.back();
+        }
+
+        /// \attention Invalidates references to the elements after \a position in its chunk, and all iterators.
+        iterator erase(const_iterator position)
+        {
+            assert(position.mChunks == &mChunks);
+            std::vector<T>& chunk = mChunks[position.mChunk];
+            chunk.erase(chunk.begin() + position.mIndex);
+            --mSize;
+
+            // Chunks are never empty, so that iterators don't have to skip any
+            if (chunk.empty())
+            {
+                mChunks.erase(mChunks.begin() + position.mChunk);
+                return iterator(&mChunks, position.mChunk, 0);
+            }
+
+            if (position.mIndex == chunk.size())
+                return iterator(&mChunks, position.mChunk + 1, 0);
+
+            return iterator(&mChunks, position.mChunk, position.mIndex);
+        }
+
+        void clear()
+        {
+            mChunks.clear();
+            mSize = 0;
+        }
+
+    private:
+        Chunks mChunks;
+        std::size_t mSize;
+
+        /// \return Chunk with room for one more element.
+        std::vector<T>& getLastChunk()
+        {
+            if (mChunks.empty() || mChunks.back().size() == mChunks.back().capacity())
+            {
+                // Moving a std::vector keeps its elements where they are
+                mChunks.emplace_back();
+                mChunks.back().reserve(std::min(std::max(mSize, MinChunkSize), MaxChunkSize));
+            }
+            return mChunks.back();
+        }
+    };
+}
+
+#endif
@@ -135,9 +135,42 @@ std::string NIFFile::printVersion(unsigned int version)
     return stream.str();
 }
 
+/// Read everything left in the stream into the buffer
+static void readAll(std::istream& stream, std::vector<char>& buffer)
+{
+    const size_t blockSize = 1 << 16;
+    size_t size = 0;
+
+    // Read in one go when the stream knows its length
+    const std::streampos start = stream.tellg();
+    if (start != std::streampos(-1) && stream.seekg(0, std::ios_base::end))
+    {
+        const std::streampos end = stream.tellg();
+        stream.seekg(start);
+        if (end != std::streampos(-1) && end > start)
+        {
+            buffer.resize(static_cast<size_t>(end - start));
+            stream.read(buffer.data(), buffer.size());
+            size = static_cast<size_t>(stream.gcount());
+        }
+    }
+    stream.clear(stream.rdstate() & ~std::ios_base::failbit);
+
+    while (stream && stream.peek() != std::char_traits<char>::eof())
+    {
+        buffer.resize(size + blockSize);
+        stream.read(buffer.data() + size, blockSize);
+        size += static_cast<size_t>(stream.gcount());
+    }
+    buffer.resize(size);
+}
+
 void NIFFile::parse(Files::IStreamPtr stream)
 {
-    NIFStream nif (this, stream);
+    // Records are decoded from memory, which is much faster than many small reads from the stream
+    std::vector<char> buffer;
+    readAll(*stream, buffer);
+    NIFStream nif (this, buffer.data(), buffer.size());
 
     // Check the header string
     std::string head = nif.getVersionString();
@@ -5,8 +5,10 @@
 
 #include "nifstream.hpp"
 
+#include <algorithm>
+#include <numeric>
 #include <sstream>
-#include <map>
+#include <vector>
 
 #include "niffile.hpp"
 
@@ -31,10 +33,9 @@ typedef KeyT<osg::Vec3f> Vector3Key;
 typedef KeyT<osg::Vec4f> Vector4Key;
 typedef KeyT<osg::Quat> QuaternionKey;
 
+/// Keys sorted by time, with the times and the keys in separate arrays so that searching the times is cache friendly.
 template<typename T, T (NIFStream::*getValue)()>
 struct KeyMapT {
-    typedef std::map< float, KeyT<T> > MapType;
-
     typedef T ValueType;
     typedef KeyT<T> KeyType;
 
@@ -44,7 +45,10 @@ struct KeyMapT {
     static const unsigned int sXYZInterpolation = 4;
 
     unsigned int mInterpolationType;
-    MapType mKeys;
+    // Strictly increasing
+    std::vector<float> mTimes;
+    // The key at each time in mTimes
+    std::vector<KeyT<T>> mKeys;
 
     KeyMapT() : mInterpolationType(sLinearInterpolation) {}
 
@@ -59,6 +63,7 @@ struct KeyMapT {
         if(count == 0 && !force)
             return;
 
+        mTimes.clear();
         mKeys.clear();
 
         mInterpolationType = nif->getUInt();
@@ -70,27 +75,27 @@ struct KeyMapT {
         {
             for(size_t i = 0;i < count;i++)
             {
-                float time = nif->getFloat();
+                mTimes.push_back(nif->getFloat());
                 readValue(nifReference, key);
-                mKeys[time] = key;
+                mKeys.push_back(key);
             }
         }
         else if(mInterpolationType == sQuadraticInterpolation)
         {
             for(size_t i = 0;i < count;i++)
             {
-                float time = nif->getFloat();
+                mTimes.push_back(nif->getFloat());
                 readQuadratic(nifReference, key);
-                mKeys[time] = key;
+                mKeys.push_back(key);
             }
         }
         else if(mInterpolationType == sTBCInterpolation)
         {
             for(size_t i = 0;i < count;i++)
             {
-                float time = nif->getFloat();
+                mTimes.push_back(nif->getFloat());
                 readTBC(nifReference, key);
-                mKeys[time] = key;
+                mKeys.push_back(key);
             }
         }
         //XYZ keys aren't actually read here.
@@ -120,6 +125,42 @@ struct KeyMapT {
             error << "Unhandled interpolation type: " << mInterpolationType;
             nif->file->fail(error.str());
         }
+
+        sortKeys();
+    }
+
+    bool empty() const
+    {
+        return mTimes.empty();
+    }
+
+    /// Sort the keys by time. Of keys with the same time, only the last one is kept.
+    void sortKeys()
+    {
+        bool sorted = true;
+        for (size_t i = 1; i < mTimes.size() && sorted; ++i)
+            sorted = mTimes[i - 1] < mTimes[i];
+        if (sorted)
+            return;
+
+        std::vector<size_t> order(mTimes.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [this] (size_t a, size_t b) { return mTimes[a] < mTimes[b]; });
+
+        std::vector<float> times;
+        std::vector<KeyT<T>> keys;
+        for (size_t index : order)
+        {
+            if (!times.empty() && times.back() == mTimes[index])
+            {
+                keys.back() = mKeys[index];
+                continue;
+            }
+            times.push_back(mTimes[index]);
+            keys.push_back(mKeys[index]);
+        }
+        mTimes.swap(times);
+        mKeys.swap(keys);
     }
 
 private:
@@ -2,12 +2,22 @@
 //For error reporting
 #include "niffile.hpp"
 
+#include <sstream>
+
 namespace Nif
 {
+    void NIFStream::failEndOfFile(size_t length) const
+    {
+        std::stringstream error;
+        error << "Attempt to read " << length << " bytes at offset " << mPosition << " past the end of the file ("
+              << mSize << " bytes)";
+        file->fail(error.str());
+    }
+
     osg::Quat NIFStream::getQuaternion()
     {
         float f[4];
-        readLittleEndianBufferOfType<4, float,uint32_t>(inp, (float*)&f);
+        readBuffer<4, float,uint32_t>((float*)&f);
         osg::Quat quat;
         quat.w() = f[0];
         quat.x() = f[1];
@@ -24,4 +34,19 @@ namespace Nif
         t.scale = getFloat();
         return t;
     }
+
+    void NIFStream::getQuaternions(std::vector<osg::Quat> &quat, size_t size)
+    {
+        std::vector<float> values;
+        getFloats(values, size * 4);
+        quat.resize(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            const float* f = &values[i * 4];
+            quat[i].w() = f[0];
+            quat[i].x() = f[1];
+            quat[i].y() = f[2];
+            quat[i].z() = f[3];
+        }
+    }
 }
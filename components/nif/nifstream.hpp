@@ -3,13 +3,14 @@
 #ifndef OPENMW_COMPONENTS_NIF_NIFSTREAM_HPP
 #define OPENMW_COMPONENTS_NIF_NIFSTREAM_HPP
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <stdint.h>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
-#include <components/files/constrainedfilestream.hpp>
-
 #include <osg/Vec3f>
 #include <osg/Vec4f>
 #include <osg/Quat>
@@ -21,16 +22,14 @@ namespace Nif
 
 class NIFFile;
 
-/* 
+/*
     readLittleEndianBufferOfType: This template should only be used with non POD data types
 */
-template <uint32_t numInstances, typename T, typename IntegerT> inline void readLittleEndianBufferOfType(Files::IStreamPtr &pIStream, T* dest)
+template <uint32_t numInstances, typename T, typename IntegerT> inline void readLittleEndianBufferOfType(const char* source, T* dest)
 {
-#if defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)
-    pIStream->read((char*)dest, numInstances * sizeof(T));
-#else
-    uint8_t* destByteBuffer = (uint8_t*)dest;
-    pIStream->read((char*)dest, numInstances * sizeof(T));
+    std::memcpy(dest, source, numInstances * sizeof(T));
+#if !(defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86))
+    const uint8_t* sourceByteBuffer = (const uint8_t*)source;
     /*
         Due to the loop iterations being known at compile time,
         this nested loop will most likely be unrolled
@@ -44,7 +43,7 @@ template <uint32_t numInstances, typename T, typename IntegerT> inline void read
     {
         u = { 0 };
         for (uint32_t byte = 0; byte < sizeof(T); byte++)
-            u.i |= (((IntegerT)destByteBuffer[i * sizeof(T) + byte]) << (byte * 8));
+            u.i |= (((IntegerT)sourceByteBuffer[i * sizeof(T) + byte]) << (byte * 8));
         dest[i] = u.t;
     }
 #endif
@@ -53,101 +52,133 @@ template <uint32_t numInstances, typename T, typename IntegerT> inline void read
 /*
     readLittleEndianDynamicBufferOfType: This template should only be used with non POD data types
 */
-template <typename T, typename IntegerT> inline void readLittleEndianDynamicBufferOfType(Files::IStreamPtr &pIStream, T* dest, uint32_t numInstances)
+template <typename T, typename IntegerT> inline void readLittleEndianDynamicBufferOfType(const char* source, T* dest, size_t numInstances)
 {
-#if defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86)
-    pIStream->read((char*)dest, numInstances * sizeof(T));
-#else
-    uint8_t* destByteBuffer = (uint8_t*)dest;
-    pIStream->read((char*)dest, numInstances * sizeof(T));
+    if (numInstances == 0)
+        return;
+    std::memcpy(dest, source, numInstances * sizeof(T));
+#if !(defined(__x86_64__) || defined(_M_X64) || defined(__i386) || defined(_M_IX86))
+    const uint8_t* sourceByteBuffer = (const uint8_t*)source;
     union {
         IntegerT i;
         T t;
     } u;
-    for (uint32_t i = 0; i < numInstances; i++)
+    for (size_t i = 0; i < numInstances; i++)
     {
         u.i = 0;
         for (uint32_t byte = 0; byte < sizeof(T); byte++)
-            u.i |= ((IntegerT)destByteBuffer[i * sizeof(T) + byte]) << (byte * 8);
+            u.i |= ((IntegerT)sourceByteBuffer[i * sizeof(T) + byte]) << (byte * 8);
         dest[i] = u.t;
     }
 #endif
 }
-template<typename type, typename IntegerT> type inline readLittleEndianType(Files::IStreamPtr &pIStream)
+template<typename type, typename IntegerT> type inline readLittleEndianType(const char* source)
 {
     type val;
-    readLittleEndianBufferOfType<1,type,IntegerT>(pIStream, (type*)&val);
+    readLittleEndianBufferOfType<1,type,IntegerT>(source, (type*)&val);
     return val;
 }
 
+/// Decodes the contents of a .nif file that has been read into memory as a whole.
+/// Arrays are copied from the buffer in bulk rather than element by element.
 class NIFStream
 {
-    /// Input stream
-    Files::IStreamPtr inp;
+    /// Contents of the file, owned by the caller
+    const char* mData;
+    size_t mSize;
+    size_t mPosition;
+
+    /// Throws through NIFFile::fail
+    void failEndOfFile(size_t length) const;
+
+    /// Return the next \a length bytes and move past them
+    const char* read(size_t length)
+    {
+        if (length > mSize - mPosition)
+            failEndOfFile(length);
+        const char* result = mData + mPosition;
+        mPosition += length;
+        return result;
+    }
+
+    template <uint32_t numInstances, typename T, typename IntegerT> void readBuffer(T* dest)
+    {
+        readLittleEndianBufferOfType<numInstances,T,IntegerT>(read(numInstances * sizeof(T)), dest);
+    }
+
+    template <typename T, typename IntegerT> void readDynamicBuffer(T* dest, size_t numInstances)
+    {
+        readLittleEndianDynamicBufferOfType<T,IntegerT>(read(numInstances * sizeof(T)), dest, numInstances);
+    }
+
+    template <typename type, typename IntegerT> type readType()
+    {
+        return readLittleEndianType<type,IntegerT>(read(sizeof(type)));
+    }
 
 public:
 
     NIFFile * const file;
 
-    NIFStream (NIFFile * file, Files::IStreamPtr inp): inp (inp), file (file) {}
+    NIFStream (NIFFile * file, const char* data, size_t size): mData (data), mSize (size), mPosition (0), file (file) {}
 
-    void skip(size_t size) { inp->ignore(size); }
+    void skip(size_t size) { read(size); }
 
     char getChar()
     {
-        return readLittleEndianType<char,char>(inp);
+        return readType<char,char>();
     }
 
     short getShort()
     {
-        return readLittleEndianType<short,short>(inp);
+        return readType<short,short>();
     }
 
     unsigned short getUShort()
     {
-        return readLittleEndianType<unsigned short,unsigned short>(inp);
+        return readType<unsigned short,unsigned short>();
     }
 
     int getInt()
     {
-        return readLittleEndianType<int,int>(inp);
+        return readType<int,int>();
     }
 
     unsigned int getUInt()
     {
-        return readLittleEndianType<unsigned int,unsigned int>(inp);
+        return readType<unsigned int,unsigned int>();
     }
 
     float getFloat()
     {
-        return readLittleEndianType<float,uint32_t>(inp);
+        return readType<float,uint32_t>();
     }
 
     osg::Vec2f getVector2()
     {
         osg::Vec2f vec;
-        readLittleEndianBufferOfType<2,float,uint32_t>(inp, (float*)&vec._v[0]);
+        readBuffer<2,float,uint32_t>((float*)&vec._v[0]);
         return vec;
     }
 
     osg::Vec3f getVector3()
     {
         osg::Vec3f vec;
-        readLittleEndianBufferOfType<3, float,uint32_t>(inp, (float*)&vec._v[0]);
+        readBuffer<3, float,uint32_t>((float*)&vec._v[0]);
         return vec;
     }
 
     osg::Vec4f getVector4()
     {
         osg::Vec4f vec;
-        readLittleEndianBufferOfType<4, float,uint32_t>(inp, (float*)&vec._v[0]);
+        readBuffer<4, float,uint32_t>((float*)&vec._v[0]);
         return vec;
     }
 
     Matrix3 getMatrix3()
     {
         Matrix3 mat;
-        readLittleEndianBufferOfType<9, float,uint32_t>(inp, (float*)&mat.mValues);
+        readBuffer<9, float,uint32_t>((float*)&mat.mValues);
         return mat;
     }
 
@@ -158,65 +189,61 @@ public:
     ///Read in a string of the given length
     std::string getString(size_t length)
     {
-        std::vector<char> str(length + 1, 0);
-
-        inp->read(&str[0], length);
-
-        return &str[0];
+        const char* str = read(length);
+        // The string ends at the first null character, if there is one
+        return std::string(str, std::find(str, str + length, '\0'));
     }
     ///Read in a string of the length specified in the file
     std::string getString()
     {
-        size_t size = readLittleEndianType<uint32_t,uint32_t>(inp);
+        size_t size = readType<uint32_t,uint32_t>();
         return getString(size);
     }
     ///This is special since the version string doesn't start with a number, and ends with "\n"
     std::string getVersionString()
     {
-        std::string result;
-        std::getline(*inp, result);
-        return result;
+        const char* begin = mData + mPosition;
+        const char* end = std::find(begin, mData + mSize, '\n');
+        mPosition += end - begin;
+        if (mPosition < mSize)
+            ++mPosition;
+        return std::string(begin, end);
     }
 
     void getUShorts(std::vector<unsigned short> &vec, size_t size)
     {
         vec.resize(size);
-        readLittleEndianDynamicBufferOfType<unsigned short,unsigned short>(inp, &vec.front(), size);
+        readDynamicBuffer<unsigned short,unsigned short>(vec.data(), size);
     }
 
     void getFloats(std::vector<float> &vec, size_t size)
     {
         vec.resize(size);
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp, &vec.front(), size);
+        readDynamicBuffer<float,uint32_t>(vec.data(), size);
     }
 
     void getVector2s(std::vector<osg::Vec2f> &vec, size_t size)
     {
         vec.resize(size);
         /* The packed storage of each Vec2f is 2 floats exactly */
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp,(float*) &vec.front(), size*2);
+        readDynamicBuffer<float,uint32_t>((float*) vec.data(), size*2);
     }
 
     void getVector3s(std::vector<osg::Vec3f> &vec, size_t size)
     {
         vec.resize(size);
         /* The packed storage of each Vec3f is 3 floats exactly */
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp, (float*) &vec.front(), size*3);
+        readDynamicBuffer<float,uint32_t>((float*) vec.data(), size*3);
     }
 
     void getVector4s(std::vector<osg::Vec4f> &vec, size_t size)
     {
         vec.resize(size);
         /* The packed storage of each Vec4f is 4 floats exactly */
-        readLittleEndianDynamicBufferOfType<float,uint32_t>(inp, (float*) &vec.front(), size*4);
+        readDynamicBuffer<float,uint32_t>((float*) vec.data(), size*4);
     }
 
-    void getQuaternions(std::vector<osg::Quat> &quat, size_t size)
-    {
-        quat.resize(size);
-        for (size_t i = 0;i < quat.size();i++)
-            quat[i] = getQuaternion();
-    }
+    void getQuaternions(std::vector<osg::Quat> &quat, size_t size);
 };
 
 }
@@ -42,19 +42,16 @@ namespace NifOsg
         typedef typename MapT::ValueType ValueT;
 
         ValueInterpolator()
-            : mDefaultVal(ValueT())
+            : mLastHighKey(1)
+            , mDefaultVal(ValueT())
         {
         }
 
         ValueInterpolator(std::shared_ptr<const MapT> keys, ValueT defaultVal = ValueT())
-            : mKeys(keys)
+            : mLastHighKey(1)
+            , mKeys(keys)
             , mDefaultVal(defaultVal)
         {
-            if (keys)
-            {
-                mLastLowKey = mKeys->mKeys.end();
-                mLastHighKey = mKeys->mKeys.end();
-            }
         }
 
         ValueT interpKey(float time) const
@@ -62,59 +59,43 @@ namespace NifOsg
             if (empty())
                 return mDefaultVal;
 
-            const typename MapT::MapType & keys = mKeys->mKeys;
+            const std::vector<float>& times = mKeys->mTimes;
+            const auto& keys = mKeys->mKeys;
 
-            if(time <= keys.begin()->first)
-                return keys.begin()->second.mValue;
+            if (time <= times.front())
+                return keys.front().mValue;
+            if (time >= times.back())
+                return keys.back().mValue;
 
-            // retrieve the current position in the map, optimized for the most common case
+            // Now there are at least two keys, and the key after time is one of keys[1] to keys[size - 1].
+            // Start looking at the key used last time, optimized for the most common case
             // where time moves linearly along the keyframe track
-            typename MapT::MapType::const_iterator it = mLastHighKey;
-            if (mLastHighKey != keys.end())
+            std::size_t high = mLastHighKey;
+            if (high >= times.size() || time > times[high] || time <= times[high - 1])
             {
-                if (time > mLastHighKey->first)
-                {
-                    // try if we're there by incrementing one
-                    ++mLastLowKey;
-                    ++mLastHighKey;
-                    it = mLastHighKey;
-                }
-                if (mLastHighKey == keys.end() || (time < mLastLowKey->first || time > mLastHighKey->first))
-                    it = keys.lower_bound(time); // still not there, reorient by performing lower_bound check on the whole map
+                // try if we're there by incrementing one
+                if (high + 1 < times.size() && time > times[high] && time <= times[high + 1])
+                    ++high;
+                else // still not there, reorient by searching all keys
+                    high = std::lower_bound(times.begin(), times.end(), time) - times.begin();
             }
-            else
-                it = keys.lower_bound(time);
-
-            // now do the actual interpolation
-            if (it != keys.end())
-            {
-                float aTime = it->first;
-                const typename MapT::KeyType* aKey = &it->second;
-
-                // cache for next time
-                mLastHighKey = it;
 
-                typename MapT::MapType::const_iterator last = --it;
-                mLastLowKey = last;
-                float aLastTime = last->first;
-                const typename MapT::KeyType* aLastKey = &last->second;
+            // cache for next time
+            mLastHighKey = high;
 
-                float a = (time - aLastTime) / (aTime - aLastTime);
+            const std::size_t low = high - 1;
+            float a = (time - times[low]) / (times[high] - times[low]);
 
-                return InterpolationFunc()(aLastKey->mValue, aKey->mValue, a);
-            }
-            else
-                return keys.rbegin()->second.mValue;
+            return InterpolationFunc()(keys[low].mValue, keys[high].mValue, a);
         }
 
         bool empty() const
         {
-            return !mKeys || mKeys->mKeys.empty();
+            return !mKeys || mKeys->empty();
         }
 
     private:
-        mutable typename MapT::MapType::const_iterator mLastLowKey;
-        mutable typename MapT::MapType::const_iterator mLastHighKey;
+        mutable std::size_t mLastHighKey;
 
         std::shared_ptr<const MapT> mKeys;
 
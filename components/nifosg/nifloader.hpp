@@ -3,6 +3,8 @@
 
 #include <components/nif/niffile.hpp>
 
+#include <map>
+
 #include <osg/ref_ptr>
 #include <osg/Referenced>
 
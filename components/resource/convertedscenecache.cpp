@@ -0,0 +1,311 @@
+#include "convertedscenecache.hpp"
+
+#include <cstring>
+
+#include <osg/Node>
+#include <osg/Drawable>
+#include <osg/Texture>
+#include <osg/UserDataContainer>
+
+#include <osgDB/Registry>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <components/debug/debuglog.hpp>
+#include <components/nifosg/nifloader.hpp>
+#include <components/nifosg/userdata.hpp>
+#include <components/sceneutil/serialize.hpp>
+
+#include "imagemanager.hpp"
+
+namespace
+{
+    // Increase whenever NifOsg::Loader creates different scene graphs from the same NIF file
+    const std::uint32_t sLoaderVersion = 1;
+
+    void hashBytes(std::uint64_t& hash, const char* data, std::size_t size)
+    {
+        // 64-bit FNV-1a
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+    }
+
+    template <class T>
+    void hashValue(std::uint64_t& hash, T value)
+    {
+        hashBytes(hash, reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    bool isOsgObject(const osg::Object& object)
+    {
+        return std::strcmp(object.libraryName(), "osg") == 0;
+    }
+
+    /// Finds out whether a scene graph only uses classes the osg serializers and SceneUtil::registerCompleteSerializers()
+    /// can write without losing data. Callbacks are never written in full, and images are only written by file name.
+    class CompleteSerializationVisitor : public osg::NodeVisitor
+    {
+    public:
+        CompleteSerializationVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            , mComplete(true)
+        {
+        }
+
+        void apply(osg::Node& node) override
+        {
+            if (!mComplete)
+                return;
+
+            if (!isComplete(node))
+            {
+                mComplete = false;
+                return;
+            }
+
+            traverse(node);
+        }
+
+        bool isComplete() const
+        {
+            return mComplete;
+        }
+
+    private:
+        bool mComplete;
+
+        bool isComplete(const osg::Node& node) const
+        {
+            if (!isOsgObject(node))
+                return false;
+
+            if (node.getUpdateCallback() || node.getEventCallback() || node.getCullCallback()
+                    || node.getComputeBoundingSphereCallback())
+                return false;
+
+            if (const osg::Drawable* drawable = node.asDrawable())
+            {
+                if (drawable->getDrawCallback() || drawable->getComputeBoundingBoxCallback())
+                    return false;
+            }
+
+            if (const osg::UserDataContainer* container = node.getUserDataContainer())
+            {
+                if (!isOsgObject(*container) || container->getUserData())
+                    return false;
+
+                for (unsigned int i = 0; i < container->getNumUserObjects(); ++i)
+                {
+                    const osg::Object* object = container->getUserObject(i);
+                    if (!isOsgObject(*object) && !dynamic_cast<const NifOsg::NodeUserData*>(object))
+                        return false;
+                }
+            }
+
+            return isComplete(node.getStateSet());
+        }
+
+        bool isComplete(const osg::StateSet* stateset) const
+        {
+            if (!stateset)
+                return true;
+
+            if (stateset->getUpdateCallback() || stateset->getEventCallback())
+                return false;
+
+            if (!isComplete(stateset->getAttributeList()))
+                return false;
+
+            for (const auto& attributes : stateset->getTextureAttributeList())
+                if (!isComplete(attributes))
+                    return false;
+
+            for (const auto& uniform : stateset->getUniformList())
+                if (uniform.second.first->getUpdateCallback() || uniform.second.first->getEventCallback())
+                    return false;
+
+            return true;
+        }
+
+        bool isComplete(const osg::StateSet::AttributeList& attributes) const
+        {
+            for (const auto& attribute : attributes)
+            {
+                const osg::StateAttribute* stateAttribute = attribute.second.first.get();
+                if (!isOsgObject(*stateAttribute) || stateAttribute->getUpdateCallback() || stateAttribute->getEventCallback())
+                    return false;
+
+                if (const osg::Texture* texture = stateAttribute->asTexture())
+                {
+                    for (unsigned int i = 0; i < texture->getNumImages(); ++i)
+                    {
+                        const osg::Image* image = texture->getImage(i);
+                        if (image && image->getFileName().empty())
+                            return false;
+                    }
+                }
+            }
+            return true;
+        }
+    };
+
+    /// Reads the images of cached scenes through the ImageManager, so that they are shared with other scenes.
+    class ImageReadCallback : public osgDB::ReadFileCallback
+    {
+    public:
+        ImageReadCallback(Resource::ImageManager* imageManager)
+            : mImageManager(imageManager)
+        {
+        }
+
+        osgDB::ReaderWriter::ReadResult readImage(const std::string& filename, const osgDB::Options* options) override
+        {
+            try
+            {
+                return osgDB::ReaderWriter::ReadResult(mImageManager->getImage(filename), osgDB::ReaderWriter::ReadResult::FILE_LOADED);
+            }
+            catch (std::exception& e)
+            {
+                return osgDB::ReaderWriter::ReadResult(e.what());
+            }
+        }
+
+    private:
+        Resource::ImageManager* mImageManager;
+    };
+}
+
+namespace Resource
+{
+
+    ConvertedSceneCache::ConvertedSceneCache(const std::string& path, Resource::ImageManager* imageManager)
+        : mPath(path)
+        , mReadOptions(new osgDB::Options)
+        , mWriteOptions(new osgDB::Options("WriteImageHint=UseExternal"))
+        , mHits(0)
+        , mMisses(0)
+        , mWritten(0)
+    {
+        SceneUtil::registerCompleteSerializers();
+
+        mReaderWriter = osgDB::Registry::instance()->getReaderWriterForExtension("osgb");
+        if (!mReaderWriter)
+            Log(Debug::Warning) << "Warning: can not find readerwriter for osgb, converted scenes will not be cached";
+
+        mReadOptions->setReadFileCallback(new ImageReadCallback(imageManager));
+
+        try
+        {
+            boost::filesystem::create_directories(mPath);
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Warning: can not create converted scene cache directory " << mPath << ": " << e.what();
+            mPath.clear();
+        }
+    }
+
+    ConvertedSceneCache::~ConvertedSceneCache()
+    {
+        Log(Debug::Verbose) << "Converted scene cache: " << mHits.load() << " hits, " << mMisses.load() << " misses, "
+                            << mWritten.load() << " scenes written";
+    }
+
+    std::uint64_t ConvertedSceneCache::getKey(const std::string& normalizedFilename, std::istream& contents)
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+
+        hashValue(hash, sLoaderVersion);
+        hashValue(hash, NifOsg::Loader::getShowMarkers());
+        hashBytes(hash, normalizedFilename.data(), normalizedFilename.size());
+
+        char buffer[1 << 16];
+        while (contents)
+        {
+            contents.read(buffer, sizeof(buffer));
+            hashBytes(hash, buffer, static_cast<std::size_t>(contents.gcount()));
+        }
+
+        return hash;
+    }
+
+    osg::ref_ptr<osg::Node> ConvertedSceneCache::read(std::uint64_t key)
+    {
+        if (!isUsable())
+            return nullptr;
+
+        boost::filesystem::ifstream stream(getFilename(key), std::ios::binary);
+        if (!stream.is_open())
+        {
+            ++mMisses;
+            return nullptr;
+        }
+
+        osgDB::ReaderWriter::ReadResult result = mReaderWriter->readNode(stream, mReadOptions);
+        if (!result.success() || !result.getNode())
+        {
+            Log(Debug::Warning) << "Warning: failed to read converted scene " << getFilename(key) << ": " << result.message();
+            ++mMisses;
+            return nullptr;
+        }
+
+        ++mHits;
+        return result.getNode();
+    }
+
+    void ConvertedSceneCache::write(std::uint64_t key, osg::Node& node)
+    {
+        if (!isUsable())
+            return;
+
+        CompleteSerializationVisitor visitor;
+        node.accept(visitor);
+        if (!visitor.isComplete())
+            return;
+
+        // Write to a file of our own first, so that a scene being read is never incomplete
+        const boost::filesystem::path filename = getFilename(key);
+        const boost::filesystem::path temporary = filename.parent_path() / boost::filesystem::unique_path("%%%%-%%%%-%%%%.tmp");
+
+        try
+        {
+            {
+                boost::filesystem::ofstream stream(temporary, std::ios::binary);
+                if (!stream.is_open())
+                    throw std::runtime_error("can not open " + temporary.string());
+
+                osgDB::ReaderWriter::WriteResult result = mReaderWriter->writeNode(node, stream, mWriteOptions);
+                if (!result.success())
+                    throw std::runtime_error(result.message());
+            }
+            boost::filesystem::rename(temporary, filename);
+            ++mWritten;
+        }
+        catch (const std::exception& e)
+        {
+            Log(Debug::Warning) << "Warning: failed to write converted scene " << filename.string() << ": " << e.what();
+            boost::system::error_code ec;
+            boost::filesystem::remove(temporary, ec);
+        }
+    }
+
+    bool ConvertedSceneCache::isUsable() const
+    {
+        // Scenes written after the debugging serializers replaced the osg::Geometry one would have no vertices
+        return !mPath.empty() && mReaderWriter && !SceneUtil::serializersOmitGeometryData();
+    }
+
+    std::string ConvertedSceneCache::getFilename(std::uint64_t key) const
+    {
+        static const char digits[] = "0123456789abcdef";
+        std::string name(16, '0');
+        for (int i = 15; i >= 0; --i, key >>= 4)
+            name[i] = digits[key & 0xf];
+        return (boost::filesystem::path(mPath) / (name + ".osgb")).string();
+    }
+
+}
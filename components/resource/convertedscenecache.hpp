@@ -0,0 +1,63 @@
+#ifndef OPENMW_COMPONENTS_RESOURCE_CONVERTEDSCENECACHE_H
+#define OPENMW_COMPONENTS_RESOURCE_CONVERTEDSCENECACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <istream>
+#include <string>
+
+#include <osg/ref_ptr>
+
+namespace osg
+{
+    class Node;
+}
+
+namespace osgDB
+{
+    class Options;
+    class ReaderWriter;
+}
+
+namespace Resource
+{
+
+    class ImageManager;
+
+    /// @brief Keeps the scene graphs converted from NIF files in a directory, one binary .osgb file per NIF,
+    /// so that later sessions can read them back instead of parsing and converting the NIF again.
+    /// @par Only scene graphs made of osg classes and NifOsg::NodeUserData are cached, since these can be
+    /// written in full. Textures are stored by file name and read through the ImageManager.
+    /// @note Thread safe.
+    class ConvertedSceneCache
+    {
+    public:
+        ConvertedSceneCache(const std::string& path, Resource::ImageManager* imageManager);
+        ~ConvertedSceneCache();
+
+        /// Key of the scene converted from a NIF file with the given contents using the current NifOsg::Loader settings.
+        static std::uint64_t getKey(const std::string& normalizedFilename, std::istream& contents);
+
+        /// @return The cached scene, or nullptr if there is none.
+        osg::ref_ptr<osg::Node> read(std::uint64_t key);
+
+        /// Cache \a node if it can be written in full. Call before the node is modified by shaders or the optimizer.
+        void write(std::uint64_t key, osg::Node& node);
+
+    private:
+        std::string mPath;
+        osg::ref_ptr<osgDB::ReaderWriter> mReaderWriter;
+        osg::ref_ptr<osgDB::Options> mReadOptions;
+        osg::ref_ptr<osgDB::Options> mWriteOptions;
+        std::atomic<std::size_t> mHits;
+        std::atomic<std::size_t> mMisses;
+        std::atomic<std::size_t> mWritten;
+
+        bool isUsable() const;
+
+        std::string getFilename(std::uint64_t key) const;
+    };
+
+}
+
+#endif
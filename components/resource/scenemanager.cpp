@@ -33,6 +33,7 @@
 #include "niffilemanager.hpp"
 #include "objectcache.hpp"
 #include "multiobjectcache.hpp"
+#include "convertedscenecache.hpp"
 
 namespace
 {
@@ -310,6 +311,11 @@ namespace Resource
         mShaderManager->setShaderPath(path);
     }
 
+    void SceneManager::setConvertedSceneCachePath(const std::string &path)
+    {
+        mConvertedSceneCache.reset(new ConvertedSceneCache(path, mImageManager));
+    }
+
     bool SceneManager::checkLoaded(const std::string &name, double timeStamp)
     {
         std::string normalized = name;
@@ -351,11 +357,24 @@ namespace Resource
         return std::string();
     }
 
-    osg::ref_ptr<osg::Node> load (Files::IStreamPtr file, const std::string& normalizedFilename, Resource::ImageManager* imageManager, Resource::NifFileManager* nifFileManager)
+    osg::ref_ptr<osg::Node> load (Files::IStreamPtr file, const std::string& normalizedFilename, Resource::ImageManager* imageManager, Resource::NifFileManager* nifFileManager,
+                                  Resource::ConvertedSceneCache* convertedSceneCache)
     {
         std::string ext = getFileExtension(normalizedFilename);
         if (ext == "nif")
-            return NifOsg::Loader::load(nifFileManager->get(normalizedFilename), imageManager);
+        {
+            if (!convertedSceneCache)
+                return NifOsg::Loader::load(nifFileManager->get(normalizedFilename), imageManager);
+
+            const std::uint64_t key = ConvertedSceneCache::getKey(normalizedFilename, *file);
+            osg::ref_ptr<osg::Node> converted = convertedSceneCache->read(key);
+            if (!converted)
+            {
+                converted = NifOsg::Loader::load(nifFileManager->get(normalizedFilename), imageManager);
+                convertedSceneCache->write(key, *converted);
+            }
+            return converted;
+        }
         else
         {
             osgDB::ReaderWriter* reader = osgDB::Registry::instance()->getReaderWriterForExtension(ext);
@@ -492,7 +511,7 @@ namespace Resource
             {
                 Files::IStreamPtr file = mVFS->get(normalized);
 
-                loaded = load(file, normalized, mImageManager, mNifFileManager);
+                loaded = load(file, normalized, mImageManager, mNifFileManager, mConvertedSceneCache.get());
             }
             catch (std::exception& e)
             {
@@ -505,7 +524,7 @@ namespace Resource
                     {
                         Log(Debug::Error) << "Failed to load '" << name << "': " << e.what() << ", using marker_error." << sMeshTypes[i] << " instead";
                         Files::IStreamPtr file = mVFS->get(normalized);
-                        loaded = load(file, normalized, mImageManager, mNifFileManager);
+                        loaded = load(file, normalized, mImageManager, mNifFileManager, mConvertedSceneCache.get());
                         break;
                     }
                 }
@@ -38,6 +38,7 @@ namespace Resource
 {
 
     class MultiObjectCache;
+    class ConvertedSceneCache;
 
     /// @brief Handles loading and caching of scenes, e.g. .nif files or .osg files
     /// @note Some methods of the scene manager can be used from any thread, see the methods documentation for more details.
@@ -79,6 +80,11 @@ namespace Resource
 
         void setShaderPath(const std::string& path);
 
+        /// Keep the scenes converted from NIF files in the given directory, so they don't have to be converted again
+        /// in later sessions.
+        /// @note Not thread safe, call before loading scenes.
+        void setConvertedSceneCachePath(const std::string& path);
+
         /// Check if a given scene is loaded and if so, update its usage timestamp to prevent it from being unloaded
         bool checkLoaded(const std::string& name, double referenceTime);
 
@@ -164,6 +170,8 @@ namespace Resource
 
         osg::ref_ptr<MultiObjectCache> mInstanceCache;
 
+        std::unique_ptr<ConvertedSceneCache> mConvertedSceneCache;
+
         osg::ref_ptr<Resource::SharedStateManager> mSharedStateManager;
         mutable OpenThreads::Mutex mSharedStateMutex;
 
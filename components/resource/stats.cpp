@@ -269,7 +269,7 @@ void StatsHandler::setUpScene(osgViewer::ViewerBase *viewer)
         _resourceStatsChildNum = _switch->getNumChildren();
         _switch->addChild(group, false);
 
-        const char* statNames[] = {"Compiling", "WorkQueue", "WorkThread", "", "Texture", "StateSet", "Node", "Node Instance", "Shape", "Shape Instance", "Image", "Nif", "Keyframe", "", "Terrain Chunk", "Terrain Texture", "Land", "Composite", "", "UnrefQueue"};
+        const char* statNames[] = {"Compiling", "WorkQueue", "WorkThread", "", "Texture", "StateSet", "Node", "Node Instance", "Shape", "Shape Instance", "Image", "Nif", "Keyframe", "", "Terrain Chunk", "Terrain Texture", "Land", "Composite", "", "UnrefQueue", "", "Physics Actor", "Physics Parallel", "", "Geometry Update", "", "Ptr Search", "Ptr Search Fallback", "", "Sound Cache Hit", "Sound Cache Miss", "Sound Decoded", "Sound Decode ms", "", "NavMesh Jobs", "NavMesh Job Latency ms", "NavMesh Disk Hit", "NavMesh Disk Miss", "NavMesh Disk Tile"};
 
         int numLines = sizeof(statNames) / sizeof(statNames[0]);
 
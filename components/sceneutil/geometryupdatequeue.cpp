@@ -0,0 +1,160 @@
+#include "geometryupdatequeue.hpp"
+
+#include <osg/Geometry>
+
+#include "workqueue.hpp"
+
+namespace
+{
+    // Geometries updated per work item, to keep the overhead of the queue small compared to the work
+    const std::size_t sBatchSize = 4;
+
+    SceneUtil::GeometryUpdateQueue* sQueue = nullptr;
+}
+
+namespace SceneUtil
+{
+
+    class GeometryUpdateQueue::Batch : public WorkItem
+    {
+    public:
+        Batch(std::atomic<osg::Timer_t>& updateTicks)
+            : mUpdateTicks(updateTicks)
+            , mClaimed(false)
+        {
+            mUpdates.reserve(sBatchSize);
+        }
+
+        void add(GeometryUpdater& updater, osg::Geometry& geometry)
+        {
+            mUpdates.emplace_back(&updater, &geometry);
+        }
+
+        std::size_t size() const
+        {
+            return mUpdates.size();
+        }
+
+        virtual void doWork() override
+        {
+            run();
+        }
+
+        /// Do the updates unless another thread started them.
+        /// @return Were the updates done by this call?
+        bool run()
+        {
+            if (mClaimed.exchange(true))
+                return false;
+
+            const osg::Timer_t startTick = osg::Timer::instance()->tick();
+            for (const auto& update : mUpdates)
+                update.first->updateGeometry(*update.second);
+            mUpdateTicks += osg::Timer::instance()->tick() - startTick;
+            return true;
+        }
+
+    private:
+        std::atomic<osg::Timer_t>& mUpdateTicks;
+        std::atomic<bool> mClaimed;
+        std::vector<std::pair<GeometryUpdater*, osg::Geometry*>> mUpdates;
+    };
+
+    GeometryUpdateQueue::GeometryUpdateQueue(int numThreads)
+        : mWorkQueue(new WorkQueue(numThreads))
+        , mOpen(false)
+        , mNumUpdates(0)
+        , mUpdateTicks(0)
+        , mBeginTick(0)
+        , mLastNumUpdates(0)
+        , mLastUpdateTime(0)
+        , mLastBeginTick(0)
+        , mLastEndTick(0)
+    {
+    }
+
+    GeometryUpdateQueue::~GeometryUpdateQueue()
+    {
+    }
+
+    GeometryUpdateQueue::JoinCallback::JoinCallback(GeometryUpdateQueue* queue)
+        : mQueue(queue)
+    {
+    }
+
+    void GeometryUpdateQueue::JoinCallback::operator()(osg::Node* node, osg::NodeVisitor* nv)
+    {
+        mQueue->open();
+        traverse(node, nv);
+        mQueue->join();
+    }
+
+    void GeometryUpdateQueue::schedule(GeometryUpdater& updater, osg::Geometry& geometry)
+    {
+        if (!mOpen)
+        {
+            updater.updateGeometry(geometry);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mNumUpdates == 0)
+            mBeginTick = osg::Timer::instance()->tick();
+        ++mNumUpdates;
+
+        if (!mBatch)
+            mBatch = new Batch(mUpdateTicks);
+        mBatch->add(updater, geometry);
+        if (mBatch->size() < sBatchSize)
+            return;
+
+        mWorkQueue->addWorkItem(mBatch);
+        mDispatched.push_back(mBatch);
+        mBatch = nullptr;
+    }
+
+    void GeometryUpdateQueue::open()
+    {
+        mOpen = true;
+    }
+
+    void GeometryUpdateQueue::join()
+    {
+        mOpen = false;
+
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        // Work on the last batch and the ones no worker started yet instead of waiting
+        if (mBatch)
+            mBatch->run();
+        std::vector<Batch*> running;
+        for (const auto& batch : mDispatched)
+            if (!batch->run())
+                running.push_back(batch.get());
+        for (Batch* batch : running)
+            batch->waitTillDone();
+
+        mLastNumUpdates = mNumUpdates;
+        mLastUpdateTime = osg::Timer::instance()->delta_s(0, mUpdateTicks.exchange(0));
+        mLastEndTick = osg::Timer::instance()->tick();
+        mLastBeginTick = mNumUpdates == 0 ? mLastEndTick : mBeginTick;
+
+        mBatch = nullptr;
+        mDispatched.clear();
+        mNumUpdates = 0;
+    }
+
+    void setGeometryUpdateQueue(GeometryUpdateQueue* queue)
+    {
+        sQueue = queue;
+    }
+
+    void scheduleGeometryUpdate(GeometryUpdater& updater, osg::Geometry& geometry)
+    {
+        if (sQueue)
+            sQueue->schedule(updater, geometry);
+        else
+            updater.updateGeometry(geometry);
+    }
+
+}
@@ -0,0 +1,101 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_GEOMETRYUPDATEQUEUE_H
+#define OPENMW_COMPONENTS_SCENEUTIL_GEOMETRYUPDATEQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include <osg/NodeCallback>
+#include <osg/Referenced>
+#include <osg/Timer>
+#include <osg/ref_ptr>
+
+namespace osg
+{
+    class Geometry;
+}
+
+namespace SceneUtil
+{
+
+    class WorkQueue;
+
+    /// Drawable updating the vertices of one of its internal geometries, e.g. by skinning or morphing.
+    class GeometryUpdater
+    {
+    public:
+        virtual ~GeometryUpdater() {}
+
+        /// Update the vertices of \a geometry.
+        /// @note May be called on a worker thread, between the cull traversal that scheduled it and the end of that traversal.
+        virtual void updateGeometry(osg::Geometry& geometry) = 0;
+    };
+
+    /// @brief Updates the vertices of the geometries visited by a cull traversal on worker threads.
+    /// @par Updates scheduled while a JoinCallback traverses its node are dispatched to the workers in batches,
+    /// and the callback waits for all of them before the traversal ends, so that they are done before anything is drawn.
+    /// Updates scheduled at any other time are done right away.
+    class GeometryUpdateQueue : public osg::Referenced
+    {
+    public:
+        GeometryUpdateQueue(int numThreads);
+        ~GeometryUpdateQueue();
+
+        /// Cull callback joining the updates scheduled while culling the children of its node, usually the main camera.
+        class JoinCallback : public osg::NodeCallback
+        {
+        public:
+            JoinCallback(GeometryUpdateQueue* queue);
+
+            virtual void operator()(osg::Node* node, osg::NodeVisitor* nv) override;
+
+        private:
+            osg::ref_ptr<GeometryUpdateQueue> mQueue;
+        };
+
+        /// Update \a geometry now, or queue the update if a JoinCallback is traversing.
+        void schedule(GeometryUpdater& updater, osg::Geometry& geometry);
+
+        /// Number of geometries updated by the last join.
+        std::size_t getNumUpdates() const { return mLastNumUpdates; }
+
+        /// Time the updates of the last join took, summed over all threads.
+        double getUpdateTime() const { return mLastUpdateTime; }
+
+        /// Time from the first update scheduled to the end of the last join.
+        osg::Timer_t getBeginTick() const { return mLastBeginTick; }
+        osg::Timer_t getEndTick() const { return mLastEndTick; }
+
+    private:
+        class Batch;
+
+        osg::ref_ptr<WorkQueue> mWorkQueue;
+        std::atomic<bool> mOpen;
+        std::mutex mMutex;
+        osg::ref_ptr<Batch> mBatch;
+        std::vector<osg::ref_ptr<Batch>> mDispatched;
+        std::size_t mNumUpdates;
+        std::atomic<osg::Timer_t> mUpdateTicks;
+        osg::Timer_t mBeginTick;
+
+        std::size_t mLastNumUpdates;
+        double mLastUpdateTime;
+        osg::Timer_t mLastBeginTick;
+        osg::Timer_t mLastEndTick;
+
+        void open();
+
+        void join();
+    };
+
+    /// Set the queue RigGeometry and MorphGeometry schedule their updates with. nullptr updates them on the cull thread.
+    /// @note Not thread safe, call while nothing is culled.
+    void setGeometryUpdateQueue(GeometryUpdateQueue* queue);
+
+    /// Update \a geometry with \a updater, through the GeometryUpdateQueue if there is one.
+    void scheduleGeometryUpdate(GeometryUpdater& updater, osg::Geometry& geometry);
+
+}
+
+#endif
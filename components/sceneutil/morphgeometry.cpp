@@ -160,6 +160,15 @@ void MorphGeometry::cull(osg::NodeVisitor *nv)
     mLastFrameNumber = nv->getTraversalNumber();
     osg::Geometry& geom = *getGeometry(mLastFrameNumber);
 
+    nv->pushOntoNodePath(&geom);
+    nv->apply(geom);
+    nv->popFromNodePath();
+
+    scheduleGeometryUpdate(*this, geom);
+}
+
+void MorphGeometry::updateGeometry(osg::Geometry& geom)
+{
     const osg::Vec3Array* positionSrc = static_cast<osg::Vec3Array*>(mSourceGeometry->getVertexArray());
     osg::Vec3Array* positionDst = static_cast<osg::Vec3Array*>(geom.getVertexArray());
     assert(positionSrc->size() == positionDst->size());
@@ -181,10 +190,6 @@ void MorphGeometry::cull(osg::NodeVisitor *nv)
 #if OSG_MIN_VERSION_REQUIRED(3, 5, 6)
     geom.dirtyGLObjects();
 #endif
-
-    nv->pushOntoNodePath(&geom);
-    nv->apply(geom);
-    nv->popFromNodePath();
 }
 
 osg::Geometry* MorphGeometry::getGeometry(unsigned int frame) const
@@ -3,13 +3,16 @@
 
 #include <osg/Geometry>
 
+#include "geometryupdatequeue.hpp"
+
 namespace SceneUtil
 {
 
     /// @brief Vertex morphing implementation.
     /// @note The internal Geometry used for rendering is double buffered, this allows updates to be done in a thread safe way while
     /// not compromising rendering performance. This is crucial when using osg's default threading model of DrawThreadPerContext.
-    class MorphGeometry : public osg::Drawable
+    /// The vertices are morphed through the GeometryUpdateQueue, if there is one.
+    class MorphGeometry : public osg::Drawable, public GeometryUpdater
     {
     public:
         MorphGeometry();
@@ -68,6 +71,8 @@ namespace SceneUtil
     private:
         void cull(osg::NodeVisitor* nv);
 
+        virtual void updateGeometry(osg::Geometry& geom) override;
+
         MorphTargetList mMorphTargets;
 
         osg::ref_ptr<osg::Geometry> mSourceGeometry;
@@ -9,26 +9,10 @@
 
 namespace
 {
-    inline void accumulateMatrix(const osg::Matrixf& invBindMatrix, const osg::Matrixf& matrix, const float weight, osg::Matrixf& result)
+    void append(std::vector<float> (&components)[3], const osg::Vec3f& value)
     {
-        osg::Matrixf m = invBindMatrix * matrix;
-        float* ptr = m.ptr();
-        float* ptrresult = result.ptr();
-        ptrresult[0] += ptr[0] * weight;
-        ptrresult[1] += ptr[1] * weight;
-        ptrresult[2] += ptr[2] * weight;
-
-        ptrresult[4] += ptr[4] * weight;
-        ptrresult[5] += ptr[5] * weight;
-        ptrresult[6] += ptr[6] * weight;
-
-        ptrresult[8] += ptr[8] * weight;
-        ptrresult[9] += ptr[9] * weight;
-        ptrresult[10] += ptr[10] * weight;
-
-        ptrresult[12] += ptr[12] * weight;
-        ptrresult[13] += ptr[13] * weight;
-        ptrresult[14] += ptr[14] * weight;
+        for (int i = 0; i < 3; ++i)
+            components[i].push_back(value[i]);
     }
 }
 
@@ -46,10 +30,12 @@ RigGeometry::RigGeometry()
 
 RigGeometry::RigGeometry(const RigGeometry &copy, const osg::CopyOp &copyop)
     : Drawable(copy, copyop)
+    , mSourceGeometry(copy.mSourceGeometry)
     , mSkeleton(nullptr)
     , mInfluenceMap(copy.mInfluenceMap)
     , mBone2VertexVector(copy.mBone2VertexVector)
     , mBoneSphereVector(copy.mBoneSphereVector)
+    , mSkinningSource(copy.mSkinningSource)
     , mLastFrameNumber(0)
     , mBoundsFirstFrame(true)
 {
@@ -58,6 +44,8 @@ RigGeometry::RigGeometry(const RigGeometry &copy, const osg::CopyOp &copyop)
 
 void RigGeometry::setSourceGeometry(osg::ref_ptr<osg::Geometry> sourceGeometry)
 {
+    // Copies share the source data of the original
+    const bool sameSource = mSourceGeometry == sourceGeometry && mSkinningSource;
     mSourceGeometry = sourceGeometry;
 
     for (unsigned int i=0; i<2; ++i)
@@ -103,6 +91,9 @@ void RigGeometry::setSourceGeometry(osg::ref_ptr<osg::Geometry> sourceGeometry)
         else
             mSourceTangents = nullptr;
     }
+
+    if (!sameSource)
+        createSkinningSource();
 }
 
 osg::ref_ptr<osg::Geometry> RigGeometry::getSourceGeometry()
@@ -150,23 +141,6 @@ bool RigGeometry::initFromParentSkeleton(osg::NodeVisitor* nv)
         mBoneNodesVector.push_back(bone);
     }
 
-    for (auto& pair : mBone2VertexVector->mData)
-    {
-        for (auto &weight : pair.first)
-        {
-            const std::string& boneName = weight.first.first;
-            Bone* bone = mSkeleton->getBone(boneName);
-            if (!bone)
-            {
-                mBoneNodesVector.push_back(nullptr);
-                Log(Debug::Error) << "Error: RigGeometry did not find bone " << boneName;
-                continue;
-            }
-
-            mBoneNodesVector.push_back(bone);
-        }
-    }
-
     return true;
 }
 
@@ -194,49 +168,59 @@ void RigGeometry::cull(osg::NodeVisitor* nv)
 
     mSkeleton->updateBoneMatrices(traversalNumber);
 
-    // skinning
-    const osg::Vec3Array* positionSrc = static_cast<osg::Vec3Array*>(mSourceGeometry->getVertexArray());
-    const osg::Vec3Array* normalSrc = static_cast<osg::Vec3Array*>(mSourceGeometry->getNormalArray());
-    const osg::Vec4Array* tangentSrc = mSourceTangents;
-
-    osg::Vec3Array* positionDst = static_cast<osg::Vec3Array*>(geom.getVertexArray());
-    osg::Vec3Array* normalDst = static_cast<osg::Vec3Array*>(geom.getNormalArray());
-    osg::Vec4Array* tangentDst = static_cast<osg::Vec4Array*>(geom.getTexCoordArray(7));
-
-    int index = mBoneSphereVector->mData.size();
-    for (auto &pair : mBone2VertexVector->mData)
+    // Blend matrices per bone rather than per group of vertices, since many groups share bones
+    const std::vector<std::pair<std::string, BoneInfluence>>& influences = mInfluenceMap->mData;
+    mBoneMatrices.resize(influences.size());
+    for (std::size_t i = 0; i < influences.size(); ++i)
     {
-        osg::Matrixf resultMat (0, 0, 0, 0,
-                                0, 0, 0, 0,
-                                0, 0, 0, 0,
-                                0, 0, 0, 1);
-
-        for (auto &weight : pair.first)
+        Bone* bone = mBoneNodesVector[i];
+        if (bone == nullptr)
         {
-            Bone* bone = mBoneNodesVector[index];
-            if (bone == nullptr)
-                continue;
-
-            accumulateMatrix(weight.first.second, bone->mMatrixInSkeletonSpace, weight.second, resultMat);
-            index++;
+            mBoneMatrices[i].setZero();
+            continue;
         }
 
+        osg::Matrixf matrix = influences[i].second.mInvBindMatrix * bone->mMatrixInSkeletonSpace;
         if (mGeomToSkelMatrix)
-            resultMat *= (*mGeomToSkelMatrix);
+            matrix *= (*mGeomToSkelMatrix);
+        mBoneMatrices[i].set(matrix);
+    }
 
-        for (auto &vertex : pair.second)
-        {
-            (*positionDst)[vertex] = resultMat.preMult((*positionSrc)[vertex]);
-            if (normalDst)
-                (*normalDst)[vertex] = osg::Matrixf::transform3x3((*normalSrc)[vertex], resultMat);
+    nv->pushOntoNodePath(&geom);
+    nv->apply(geom);
+    nv->popFromNodePath();
 
-            if (tangentDst)
-            {
-                const osg::Vec4f& srcTangent = (*tangentSrc)[vertex];
-                osg::Vec3f transformedTangent = osg::Matrixf::transform3x3(osg::Vec3f(srcTangent.x(), srcTangent.y(), srcTangent.z()), resultMat);
-                (*tangentDst)[vertex] = osg::Vec4f(transformedTangent, srcTangent.w());
-            }
-        }
+    // Skin with the matrices computed above, the skeleton is only accessed on the cull thread
+    scheduleGeometryUpdate(*this, geom);
+}
+
+void RigGeometry::updateGeometry(osg::Geometry& geom)
+{
+    osg::Vec3Array* positionDst = static_cast<osg::Vec3Array*>(geom.getVertexArray());
+    osg::Vec3Array* normalDst = static_cast<osg::Vec3Array*>(geom.getNormalArray());
+    osg::Vec4Array* tangentDst = static_cast<osg::Vec4Array*>(geom.getTexCoordArray(7));
+
+    const SkinningKernel kernel = getSkinningKernel();
+    const SkinningSource& source = *mSkinningSource;
+    for (std::size_t i = 0; i < source.mGroups.size(); ++i)
+    {
+        const SkinningSource::Group& group = source.mGroups[i];
+        const VertexList& vertices = mBone2VertexVector->mData[i].second;
+
+        SkinningMatrix matrix;
+        matrix.setZero();
+        for (const auto& boneWeight : group.mBoneWeights)
+            matrix.accumulate(mBoneMatrices[boneWeight.first], boneWeight.second);
+
+        skinPositions(kernel, matrix, source.mPositions[0].data() + group.mOffset, source.mPositions[1].data() + group.mOffset,
+            source.mPositions[2].data() + group.mOffset, vertices.size(), vertices.data(), positionDst->front().ptr(), 3);
+        if (normalDst)
+            skinDirections(kernel, matrix, source.mNormals[0].data() + group.mOffset, source.mNormals[1].data() + group.mOffset,
+                source.mNormals[2].data() + group.mOffset, vertices.size(), vertices.data(), normalDst->front().ptr(), 3);
+        // The w component of the tangents does not change
+        if (tangentDst)
+            skinDirections(kernel, matrix, source.mTangents[0].data() + group.mOffset, source.mTangents[1].data() + group.mOffset,
+                source.mTangents[2].data() + group.mOffset, vertices.size(), vertices.data(), tangentDst->front().ptr(), 4);
     }
 
     positionDst->dirty();
@@ -248,10 +232,6 @@ void RigGeometry::cull(osg::NodeVisitor* nv)
 #if OSG_MIN_VERSION_REQUIRED(3, 5, 6)
     geom.dirtyGLObjects();
 #endif
-
-    nv->pushOntoNodePath(&geom);
-    nv->apply(geom);
-    nv->popFromNodePath();
 }
 
 void RigGeometry::updateBounds(osg::NodeVisitor *nv)
@@ -363,6 +343,48 @@ void RigGeometry::setInfluenceMap(osg::ref_ptr<InfluenceMap> influenceMap)
 
     mBone2VertexVector->mData.reserve(bone2VertexMap.size());
     mBone2VertexVector->mData.assign(bone2VertexMap.begin(), bone2VertexMap.end());
+
+    createSkinningSource();
+}
+
+void RigGeometry::createSkinningSource()
+{
+    mSkinningSource = nullptr;
+    if (!mSourceGeometry || !mBone2VertexVector)
+        return;
+
+    const osg::Vec3Array* positions = static_cast<const osg::Vec3Array*>(mSourceGeometry->getVertexArray());
+    const osg::Vec3Array* normals = static_cast<const osg::Vec3Array*>(mSourceGeometry->getNormalArray());
+    const osg::Vec4Array* tangents = mSourceTangents;
+
+    std::map<std::string, std::size_t> boneIndices;
+    for (std::size_t i = 0; i < mInfluenceMap->mData.size(); ++i)
+        boneIndices.emplace(mInfluenceMap->mData[i].first, i);
+
+    osg::ref_ptr<SkinningSource> source = new SkinningSource;
+    source->mGroups.reserve(mBone2VertexVector->mData.size());
+    for (auto& pair : mBone2VertexVector->mData)
+    {
+        SkinningSource::Group group;
+        group.mOffset = source->mPositions[0].size();
+        for (auto& weight : pair.first)
+            group.mBoneWeights.emplace_back(boneIndices[weight.first.first], weight.second);
+        source->mGroups.push_back(group);
+
+        for (unsigned short vertex : pair.second)
+        {
+            append(source->mPositions, (*positions)[vertex]);
+            if (normals)
+                append(source->mNormals, (*normals)[vertex]);
+            if (tangents)
+            {
+                const osg::Vec4f& tangent = (*tangents)[vertex];
+                append(source->mTangents, osg::Vec3f(tangent.x(), tangent.y(), tangent.z()));
+            }
+        }
+    }
+
+    mSkinningSource = source;
 }
 
 void RigGeometry::accept(osg::NodeVisitor &nv)
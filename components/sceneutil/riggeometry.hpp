@@ -4,6 +4,9 @@
 #include <osg/Geometry>
 #include <osg/Matrixf>
 
+#include "geometryupdatequeue.hpp"
+#include "skinning.hpp"
+
 namespace SceneUtil
 {
     class Skeleton;
@@ -14,7 +17,8 @@ namespace SceneUtil
     /// Note though that the RigGeometry ignores any transforms below the Skeleton, so the attachment point is not that important.
     /// @note The internal Geometry used for rendering is double buffered, this allows updates to be done in a thread safe way while
     /// not compromising rendering performance. This is crucial when using osg's default threading model of DrawThreadPerContext.
-    class RigGeometry : public osg::Drawable
+    /// The vertices are skinned through the GeometryUpdateQueue, if there is one.
+    class RigGeometry : public osg::Drawable, public GeometryUpdater
     {
     public:
         RigGeometry();
@@ -68,6 +72,8 @@ namespace SceneUtil
         void cull(osg::NodeVisitor* nv);
         void updateBounds(osg::NodeVisitor* nv);
 
+        virtual void updateGeometry(osg::Geometry& geom) override;
+
         osg::ref_ptr<osg::Geometry> mGeometry[2];
         osg::Geometry* getGeometry(unsigned int frame) const;
 
@@ -100,12 +106,33 @@ namespace SceneUtil
         osg::ref_ptr<BoneSphereVector> mBoneSphereVector;
         std::vector<Bone*> mBoneNodesVector;
 
+        /// Source vertex data in the order of mBone2VertexVector, with separate arrays per component for the skinning kernels.
+        struct SkinningSource : public osg::Referenced
+        {
+            struct Group
+            {
+                std::size_t mOffset;
+                // <index into InfluenceMap::mData, weight>
+                std::vector<std::pair<std::size_t, float>> mBoneWeights;
+            };
+            std::vector<Group> mGroups;
+            std::vector<float> mPositions[3];
+            std::vector<float> mNormals[3];
+            std::vector<float> mTangents[3];
+        };
+        osg::ref_ptr<SkinningSource> mSkinningSource;
+
+        // Skinning matrix of every bone in the InfluenceMap, updated each frame
+        std::vector<SkinningMatrix> mBoneMatrices;
+
         unsigned int mLastFrameNumber;
         bool mBoundsFirstFrame;
 
         bool initFromParentSkeleton(osg::NodeVisitor* nv);
 
         void updateGeomToSkelMatrix(const osg::NodePath& nodePath);
+
+        void createSkinningSource();
     };
 
 }
@@ -8,6 +8,8 @@
 #include <components/sceneutil/riggeometry.hpp>
 #include <components/sceneutil/morphgeometry.hpp>
 
+#include <components/nifosg/userdata.hpp>
+
 namespace SceneUtil
 {
 
@@ -74,6 +76,41 @@ public:
     }
 };
 
+static bool checkNodeUserData(const NifOsg::NodeUserData&)
+{
+    return true;
+}
+
+static bool readNodeUserData(osgDB::InputStream& is, NifOsg::NodeUserData& data)
+{
+    is >> data.mIndex >> data.mScale;
+    for (int i=0; i<3; ++i)
+        for (int j=0; j<3; ++j)
+            is >> data.mRotationScale.mValues[i][j];
+    return true;
+}
+
+static bool writeNodeUserData(osgDB::OutputStream& os, const NifOsg::NodeUserData& data)
+{
+    os << data.mIndex << data.mScale;
+    for (int i=0; i<3; ++i)
+        for (int j=0; j<3; ++j)
+            os << data.mRotationScale.mValues[i][j];
+    os << std::endl;
+    return true;
+}
+
+class NodeUserDataSerializer : public osgDB::ObjectWrapper
+{
+public:
+    NodeUserDataSerializer()
+        : osgDB::ObjectWrapper(createInstanceFunc<NifOsg::NodeUserData>, "NifOsg::NodeUserData", "osg::Object NifOsg::NodeUserData")
+    {
+        addSerializer( new osgDB::UserSerializer<NifOsg::NodeUserData>(
+            "data", &checkNodeUserData, &readNodeUserData, &writeNodeUserData), osgDB::BaseSerializer::RW_USER );
+    }
+};
+
 osgDB::ObjectWrapper* makeDummySerializer(const std::string& classname)
 {
     return new osgDB::ObjectWrapper(createInstanceFunc<osg::DummyObject>, classname, "osg::Object");
@@ -88,8 +125,23 @@ public:
     }
 };
 
+static bool sOmitGeometryData = false;
+
+void registerCompleteSerializers()
+{
+    static bool done = false;
+    if (!done)
+    {
+        osgDB::ObjectWrapperManager* mgr = osgDB::Registry::instance()->getObjectWrapperManager();
+        mgr->addWrapper(new NodeUserDataSerializer);
+        done = true;
+    }
+}
+
 void registerSerializers()
 {
+    registerCompleteSerializers();
+
     static bool done = false;
     if (!done)
     {
@@ -104,6 +156,7 @@ void registerSerializers()
         // Don't serialize Geometry data as we are more interested in the overall structure rather than tons of vertex data that would make the file large and hard to read.
         mgr->removeWrapper(mgr->findWrapper("osg::Geometry"));
         mgr->addWrapper(new GeometrySerializer);
+        sOmitGeometryData = true;
 
         // ignore the below for now to avoid warning spam
         const char* ignore[] = {
@@ -115,7 +168,6 @@ void registerSerializers()
             "SceneUtil::UpdateRigGeometry",
             "SceneUtil::LightSource",
             "SceneUtil::StateSetUpdater",
-            "NifOsg::NodeUserData",
             "NifOsg::FlipController",
             "NifOsg::KeyframeController",
             "NifOsg::TextKeyMapHolder",
@@ -142,4 +194,9 @@ void registerSerializers()
     }
 }
 
+bool serializersOmitGeometryData()
+{
+    return sOmitGeometryData;
+}
+
 }
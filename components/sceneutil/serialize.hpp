@@ -7,6 +7,13 @@ namespace SceneUtil
     /// Register osg node serializers for certain SceneUtil classes if not already done so
     void registerSerializers();
 
+    /// Register osg object serializers for the classes that can be written and read back without losing data,
+    /// so that scene graphs using only these and osg classes can be cached on disk.
+    void registerCompleteSerializers();
+
+    /// @return Has registerSerializers() replaced the osg::Geometry serializer with one that leaves out the vertex data?
+    bool serializersOmitGeometryData();
+
 }
 
 #endif
@@ -0,0 +1,297 @@
+#include "skinning.hpp"
+
+#include <components/debug/debuglog.hpp>
+#include <components/misc/stringops.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define OPENMW_SKINNING_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// The SSE and AVX kernels are compiled for their instruction set no matter the compiler flags and only called
+// when the CPU supports it
+#if defined(__GNUC__) || defined(__clang__)
+#define OPENMW_SKINNING_TARGET(instructionSet) __attribute__((target(instructionSet)))
+#else
+#define OPENMW_SKINNING_TARGET(instructionSet)
+#endif
+
+namespace
+{
+    using SceneUtil::SkinningKernel;
+    using SceneUtil::SkinningMatrix;
+
+    template <bool translate>
+    void skinScalar(const SkinningMatrix& matrix, const float* x, const float* y, const float* z,
+        std::size_t count, const unsigned short* indices, float* dst, std::size_t dstStride)
+    {
+        // Copy the matrix, so it is not read again after every write to dst
+        const SkinningMatrix m = matrix;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const float vx = x[i];
+            const float vy = y[i];
+            const float vz = z[i];
+            float* out = dst + indices[i] * dstStride;
+            out[0] = m.mValues[0][0] * vx + m.mValues[0][1] * vy + m.mValues[0][2] * vz + (translate ? m.mValues[0][3] : 0.f);
+            out[1] = m.mValues[1][0] * vx + m.mValues[1][1] * vy + m.mValues[1][2] * vz + (translate ? m.mValues[1][3] : 0.f);
+            out[2] = m.mValues[2][0] * vx + m.mValues[2][1] * vy + m.mValues[2][2] * vz + (translate ? m.mValues[2][3] : 0.f);
+        }
+    }
+
+#ifdef OPENMW_SKINNING_X86
+    // The kernels are written out per component with named registers rather than loops over arrays,
+    // which the compiler would keep on the stack.
+
+    /// Write the x, y and z components of four vertices, given as one register per component.
+    /// Vertices are scattered over the destination array, so they are transposed and written one at a time.
+#define OPENMW_SKINNING_STORE_VERTICES(resultX, resultY, resultZ, indices, dst, dstStride) \
+    do { \
+        __m128 v0 = resultX, v1 = resultY, v2 = resultZ, v3 = _mm_setzero_ps(); \
+        _MM_TRANSPOSE4_PS(v0, v1, v2, v3); \
+        float* out0 = dst + (indices)[0] * dstStride; \
+        float* out1 = dst + (indices)[1] * dstStride; \
+        float* out2 = dst + (indices)[2] * dstStride; \
+        float* out3 = dst + (indices)[3] * dstStride; \
+        _mm_storel_pi(reinterpret_cast<__m64*>(out0), v0); \
+        _mm_store_ss(out0 + 2, _mm_movehl_ps(v0, v0)); \
+        _mm_storel_pi(reinterpret_cast<__m64*>(out1), v1); \
+        _mm_store_ss(out1 + 2, _mm_movehl_ps(v1, v1)); \
+        _mm_storel_pi(reinterpret_cast<__m64*>(out2), v2); \
+        _mm_store_ss(out2 + 2, _mm_movehl_ps(v2, v2)); \
+        _mm_storel_pi(reinterpret_cast<__m64*>(out3), v3); \
+        _mm_store_ss(out3 + 2, _mm_movehl_ps(v3, v3)); \
+    } while (false)
+
+    template <bool translate>
+    OPENMW_SKINNING_TARGET("sse2")
+    void skinSSE(const SkinningMatrix& matrix, const float* x, const float* y, const float* z,
+        std::size_t count, const unsigned short* indices, float* dst, std::size_t dstStride)
+    {
+        const float (&m)[3][4] = matrix.mValues;
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 vx = _mm_loadu_ps(x + i);
+            const __m128 vy = _mm_loadu_ps(y + i);
+            const __m128 vz = _mm_loadu_ps(z + i);
+
+            __m128 resultX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[0][0]), vx), _mm_mul_ps(_mm_set1_ps(m[0][1]), vy)), _mm_mul_ps(_mm_set1_ps(m[0][2]), vz));
+            __m128 resultY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[1][0]), vx), _mm_mul_ps(_mm_set1_ps(m[1][1]), vy)), _mm_mul_ps(_mm_set1_ps(m[1][2]), vz));
+            __m128 resultZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[2][0]), vx), _mm_mul_ps(_mm_set1_ps(m[2][1]), vy)), _mm_mul_ps(_mm_set1_ps(m[2][2]), vz));
+            if (translate)
+            {
+                resultX = _mm_add_ps(resultX, _mm_set1_ps(m[0][3]));
+                resultY = _mm_add_ps(resultY, _mm_set1_ps(m[1][3]));
+                resultZ = _mm_add_ps(resultZ, _mm_set1_ps(m[2][3]));
+            }
+
+            OPENMW_SKINNING_STORE_VERTICES(resultX, resultY, resultZ, indices + i, dst, dstStride);
+        }
+
+        skinScalar<translate>(matrix, x + i, y + i, z + i, count - i, indices + i, dst, dstStride);
+    }
+
+    template <bool translate>
+    OPENMW_SKINNING_TARGET("avx")
+    void skinAVX(const SkinningMatrix& matrix, const float* x, const float* y, const float* z,
+        std::size_t count, const unsigned short* indices, float* dst, std::size_t dstStride)
+    {
+        const float (&m)[3][4] = matrix.mValues;
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 vx = _mm256_loadu_ps(x + i);
+            const __m256 vy = _mm256_loadu_ps(y + i);
+            const __m256 vz = _mm256_loadu_ps(z + i);
+
+            __m256 resultX = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_broadcast_ss(&m[0][0]), vx), _mm256_mul_ps(_mm256_broadcast_ss(&m[0][1]), vy)), _mm256_mul_ps(_mm256_broadcast_ss(&m[0][2]), vz));
+            __m256 resultY = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_broadcast_ss(&m[1][0]), vx), _mm256_mul_ps(_mm256_broadcast_ss(&m[1][1]), vy)), _mm256_mul_ps(_mm256_broadcast_ss(&m[1][2]), vz));
+            __m256 resultZ = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_broadcast_ss(&m[2][0]), vx), _mm256_mul_ps(_mm256_broadcast_ss(&m[2][1]), vy)), _mm256_mul_ps(_mm256_broadcast_ss(&m[2][2]), vz));
+            if (translate)
+            {
+                resultX = _mm256_add_ps(resultX, _mm256_broadcast_ss(&m[0][3]));
+                resultY = _mm256_add_ps(resultY, _mm256_broadcast_ss(&m[1][3]));
+                resultZ = _mm256_add_ps(resultZ, _mm256_broadcast_ss(&m[2][3]));
+            }
+
+            OPENMW_SKINNING_STORE_VERTICES(_mm256_castps256_ps128(resultX), _mm256_castps256_ps128(resultY),
+                _mm256_castps256_ps128(resultZ), indices + i, dst, dstStride);
+            OPENMW_SKINNING_STORE_VERTICES(_mm256_extractf128_ps(resultX, 1), _mm256_extractf128_ps(resultY, 1),
+                _mm256_extractf128_ps(resultZ, 1), indices + i + 4, dst, dstStride);
+        }
+
+        skinScalar<translate>(matrix, x + i, y + i, z + i, count - i, indices + i, dst, dstStride);
+    }
+
+#undef OPENMW_SKINNING_STORE_VERTICES
+
+    bool cpuSupportsSSE2()
+    {
+#if defined(__x86_64__) || defined(_M_X64)
+        return true;
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+#endif
+    }
+
+    bool cpuSupportsAVX()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        const bool osUsesXSave = (info[2] & (1 << 27)) != 0;
+        const bool hasAVX = (info[2] & (1 << 28)) != 0;
+        // The OS has to save the AVX registers on context switches
+        return osUsesXSave && hasAVX && (_xgetbv(0) & 6) == 6;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx");
+#endif
+    }
+#endif
+
+    SkinningKernel getDefaultKernel()
+    {
+        // Writing the scattered vertices takes most of the time, so the AVX kernel is not faster than the SSE one
+        if (SceneUtil::isSkinningKernelSupported(SkinningKernel::SSE))
+            return SkinningKernel::SSE;
+        return SkinningKernel::Scalar;
+    }
+
+    SkinningKernel sKernel = getDefaultKernel();
+
+    template <bool translate>
+    void skin(SkinningKernel kernel, const SkinningMatrix& matrix, const float* x, const float* y, const float* z,
+        std::size_t count, const unsigned short* indices, float* dst, std::size_t dstStride)
+    {
+        switch (kernel)
+        {
+#ifdef OPENMW_SKINNING_X86
+            case SkinningKernel::AVX:
+                return skinAVX<translate>(matrix, x, y, z, count, indices, dst, dstStride);
+            case SkinningKernel::SSE:
+                return skinSSE<translate>(matrix, x, y, z, count, indices, dst, dstStride);
+#endif
+            default:
+                return skinScalar<translate>(matrix, x, y, z, count, indices, dst, dstStride);
+        }
+    }
+}
+
+namespace SceneUtil
+{
+
+    void SkinningMatrix::setZero()
+    {
+        for (int row = 0; row < 3; ++row)
+            for (int column = 0; column < 4; ++column)
+                mValues[row][column] = 0.f;
+    }
+
+    void SkinningMatrix::set(const osg::Matrixf& matrix)
+    {
+        for (int row = 0; row < 3; ++row)
+            for (int column = 0; column < 4; ++column)
+                mValues[row][column] = matrix(column, row);
+    }
+
+    void SkinningMatrix::accumulate(const SkinningMatrix& matrix, float weight)
+    {
+        for (int row = 0; row < 3; ++row)
+            for (int column = 0; column < 4; ++column)
+                mValues[row][column] += matrix.mValues[row][column] * weight;
+    }
+
+    const char* getSkinningKernelName(SkinningKernel kernel)
+    {
+        switch (kernel)
+        {
+            case SkinningKernel::Scalar:
+                return "scalar";
+            case SkinningKernel::SSE:
+                return "sse";
+            case SkinningKernel::AVX:
+                return "avx";
+        }
+        return "unknown";
+    }
+
+    bool isSkinningKernelSupported(SkinningKernel kernel)
+    {
+        switch (kernel)
+        {
+            case SkinningKernel::Scalar:
+                return true;
+#ifdef OPENMW_SKINNING_X86
+            case SkinningKernel::SSE:
+            {
+                static const bool supported = cpuSupportsSSE2();
+                return supported;
+            }
+            case SkinningKernel::AVX:
+            {
+                static const bool supported = cpuSupportsAVX();
+                return supported;
+            }
+#endif
+            default:
+                return false;
+        }
+    }
+
+    SkinningKernel selectSkinningKernel(const std::string& name)
+    {
+        const std::string lowerCaseName = Misc::StringUtils::lowerCase(name);
+        const SkinningKernel kernels[] = {SkinningKernel::Scalar, SkinningKernel::SSE, SkinningKernel::AVX};
+
+        sKernel = getDefaultKernel();
+        if (lowerCaseName != "auto")
+        {
+            bool found = false;
+            for (SkinningKernel kernel : kernels)
+            {
+                if (lowerCaseName != getSkinningKernelName(kernel))
+                    continue;
+                found = true;
+                if (isSkinningKernelSupported(kernel))
+                    sKernel = kernel;
+                else
+                    Log(Debug::Warning) << "Warning: skinning kernel '" << name << "' is not supported by this CPU";
+            }
+            if (!found)
+                Log(Debug::Warning) << "Warning: unknown skinning kernel '" << name << "'";
+        }
+
+        Log(Debug::Info) << "Using " << getSkinningKernelName(sKernel) << " skinning kernel";
+        return sKernel;
+    }
+
+    SkinningKernel getSkinningKernel()
+    {
+        return sKernel;
+    }
+
+    void skinPositions(SkinningKernel kernel, const SkinningMatrix& matrix, const float* x, const float* y, const float* z,
+        std::size_t count, const unsigned short* indices, float* dst, std::size_t dstStride)
+    {
+        skin<true>(kernel, matrix, x, y, z, count, indices, dst, dstStride);
+    }
+
+    void skinDirections(SkinningKernel kernel, const SkinningMatrix& matrix, const float* x, const float* y, const float* z,
+        std::size_t count, const unsigned short* indices, float* dst, std::size_t dstStride)
+    {
+        skin<false>(kernel, matrix, x, y, z, count, indices, dst, dstStride);
+    }
+
+}
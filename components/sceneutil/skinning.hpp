@@ -0,0 +1,59 @@
+#ifndef OPENMW_COMPONENTS_SCENEUTIL_SKINNING_H
+#define OPENMW_COMPONENTS_SCENEUTIL_SKINNING_H
+
+#include <cstddef>
+#include <string>
+
+#include <osg/Matrixf>
+
+namespace SceneUtil
+{
+
+    /// Affine transform as the top three rows of a column-major 4x4 matrix: x' = mValues[0][0]*x + mValues[0][1]*y + mValues[0][2]*z + mValues[0][3].
+    /// @note Unlike osg::Matrixf this transforms column vectors, so that every output component is one row.
+    struct SkinningMatrix
+    {
+        float mValues[3][4];
+
+        void setZero();
+
+        /// Set from an osg::Matrixf transforming row vectors (v' = v * matrix).
+        void set(const osg::Matrixf& matrix);
+
+        /// Add \a matrix multiplied with \a weight.
+        void accumulate(const SkinningMatrix& matrix, float weight);
+    };
+
+    /// Implementations of the vertex transforms.
+    enum class SkinningKernel
+    {
+        Scalar,
+        SSE,
+        AVX
+    };
+
+    const char* getSkinningKernelName(SkinningKernel kernel);
+
+    /// Can the CPU we are running on use \a kernel?
+    bool isSkinningKernelSupported(SkinningKernel kernel);
+
+    /// Select the kernel RigGeometry uses by name, or the default one for "auto": SSE if the CPU supports it, scalar otherwise.
+    /// Unknown or unsupported names select the default kernel as well.
+    /// @return The selected kernel.
+    /// @note Not thread safe, call before skinning anything.
+    SkinningKernel selectSkinningKernel(const std::string& name);
+
+    SkinningKernel getSkinningKernel();
+
+    /// Transform \a count points given as separate arrays of \a x, \a y and \a z coordinates with \a matrix,
+    /// writing the first three components of dst[indices[i] * dstStride].
+    void skinPositions(SkinningKernel kernel, const SkinningMatrix& matrix, const float* x, const float* y, const float* z,
+        std::size_t count, const unsigned short* indices, float* dst, std::size_t dstStride);
+
+    /// Like skinPositions(), but ignores the translation of \a matrix, for normals and tangents.
+    void skinDirections(SkinningKernel kernel, const SkinningMatrix& matrix, const float* x, const float* y, const float* z,
+        std::size_t count, const unsigned short* indices, float* dst, std::size_t dstStride);
+
+}
+
+#endif
@@ -27,6 +27,8 @@ namespace ToUTF8
         public:
             Utf8Encoder(FromType sourceEncoding);
 
+            FromType getEncoding() const { return mEncoding; }
+
             // Convert to UTF8 from the previously given code page.
             std::string getUtf8(const char *input, size_t size);
             inline std::string getUtf8(const std::string &str)
@@ -47,6 +49,7 @@ namespace ToUTF8
             size_t getLength2(const char* input, bool &ascii);
             void copyFromArray2(const char*& chp, char* &out);
 
+            FromType mEncoding;
             std::vector<char> mOutput;
             signed char* translationArray;
     };
@@ -5,7 +5,7 @@
 namespace VFS
 {
 
-BsaArchive::BsaArchive(const std::string &filename)
+BsaArchive::BsaArchive(const std::string &filename, bool memoryMapped)
 {
     Bsa::BsaVersion bsaVersion = Bsa::CompressedBSAFile::detectVersion(filename);
 
@@ -16,7 +16,7 @@ BsaArchive::BsaArchive(const std::string &filename)
         mFile = std::unique_ptr<Bsa::BSAFile>(new Bsa::BSAFile());
     }
 
-    mFile->open(filename);
+    mFile->open(filename, memoryMapped);
 
     const Bsa::BSAFile::FileList &filelist = mFile->getList();
     for(Bsa::BSAFile::FileList::const_iterator it = filelist.begin();it != filelist.end();++it)
@@ -0,0 +1,101 @@
+#include "hashindex.hpp"
+
+#include <components/misc/stringops.hpp>
+
+namespace
+{
+
+    // 64-bit FNV-1a
+    const std::uint64_t sHashOffset = 14695981039346656037ull;
+    const std::uint64_t sHashPrime = 1099511628211ull;
+
+    inline char normalizeChar(char ch, bool strict)
+    {
+        if (ch == '\\')
+            return '/';
+        return strict ? ch : Misc::StringUtils::toLower(ch);
+    }
+
+}
+
+namespace VFS
+{
+
+    HashIndex::HashIndex()
+        : mMask(0)
+        , mSize(0)
+        , mStrict(false)
+    {
+    }
+
+    void HashIndex::build(const std::map<std::string, File*>& index, bool strict)
+    {
+        mStrict = strict;
+        mSize = index.size();
+
+        // Keep the load factor at or below 1/2 so probe sequences stay short
+        std::size_t capacity = 16;
+        while (capacity < 2 * mSize)
+            capacity *= 2;
+
+        const Entry empty = {0, nullptr, nullptr};
+        mEntries.assign(capacity, empty);
+        mMask = capacity - 1;
+
+        for (std::map<std::string, File*>::const_iterator it = index.begin(); it != index.end(); ++it)
+        {
+            const std::uint64_t entryHash = hash(it->first.data(), it->first.size());
+            std::size_t slot = static_cast<std::size_t>(entryHash) & mMask;
+            while (mEntries[slot].mName != nullptr)
+                slot = (slot + 1) & mMask;
+            mEntries[slot].mHash = entryHash;
+            mEntries[slot].mName = &it->first;
+            mEntries[slot].mFile = it->second;
+        }
+    }
+
+    void HashIndex::clear()
+    {
+        mEntries.clear();
+        mMask = 0;
+        mSize = 0;
+    }
+
+    File* HashIndex::find(const char* name, std::size_t size) const
+    {
+        if (mEntries.empty())
+            return nullptr;
+
+        const std::uint64_t nameHash = hash(name, size);
+        for (std::size_t slot = static_cast<std::size_t>(nameHash) & mMask; mEntries[slot].mName != nullptr; slot = (slot + 1) & mMask)
+        {
+            const Entry& entry = mEntries[slot];
+            if (entry.mHash == nameHash && equal(*entry.mName, name, size))
+                return entry.mFile;
+        }
+
+        return nullptr;
+    }
+
+    std::uint64_t HashIndex::hash(const char* name, std::size_t size) const
+    {
+        std::uint64_t result = sHashOffset;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            result ^= static_cast<unsigned char>(normalizeChar(name[i], mStrict));
+            result *= sHashPrime;
+        }
+        return result;
+    }
+
+    bool HashIndex::equal(const std::string& normalized, const char* name, std::size_t size) const
+    {
+        if (normalized.size() != size)
+            return false;
+        for (std::size_t i = 0; i < size; ++i)
+            if (normalized[i] != normalizeChar(name[i], mStrict))
+                return false;
+        return true;
+    }
+
+}
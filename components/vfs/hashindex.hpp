@@ -0,0 +1,60 @@
+#ifndef OPENMW_COMPONENTS_VFS_HASHINDEX_H
+#define OPENMW_COMPONENTS_VFS_HASHINDEX_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace VFS
+{
+
+    class File;
+
+    /// @brief Open addressing hash table over the file index of VFS::Manager.
+    /// @par Names are normalized character by character while hashing and comparing, so a lookup
+    /// never has to allocate a normalized copy of the name it was given.
+    /// @note Refers to the keys of the map it was built from, which must outlive the table.
+    class HashIndex
+    {
+    public:
+        HashIndex();
+
+        /// @param strict Use strict path handling? If enabled, no case folding will
+        /// be done, but slash/backslash conversions are always done.
+        void build(const std::map<std::string, File*>& index, bool strict);
+
+        void clear();
+
+        /// Find a file by a name that may or may not be normalized yet.
+        /// @return nullptr if there is no such file.
+        File* find(const char* name, std::size_t size) const;
+
+        File* find(const std::string& name) const
+        {
+            return find(name.data(), name.size());
+        }
+
+        std::size_t size() const { return mSize; }
+
+    private:
+        struct Entry
+        {
+            std::uint64_t mHash;
+            const std::string* mName;
+            File* mFile;
+        };
+
+        std::vector<Entry> mEntries;
+        std::size_t mMask;
+        std::size_t mSize;
+        bool mStrict;
+
+        std::uint64_t hash(const char* name, std::size_t size) const;
+
+        bool equal(const std::string& normalized, const char* name, std::size_t size) const;
+    };
+
+}
+
+#endif
@@ -43,6 +43,7 @@ namespace VFS
 
     void Manager::reset()
     {
+        mHashIndex.clear();
         mIndex.clear();
         for (std::vector<Archive*>::iterator it = mArchives.begin(); it != mArchives.end(); ++it)
             delete *it;
@@ -56,34 +57,39 @@ namespace VFS
 
     void Manager::buildIndex()
     {
+        mHashIndex.clear();
         mIndex.clear();
 
         for (std::vector<Archive*>::const_iterator it = mArchives.begin(); it != mArchives.end(); ++it)
             (*it)->listResources(mIndex, mStrict ? &strict_normalize_char : &nonstrict_normalize_char);
+
+        mHashIndex.build(mIndex, mStrict);
     }
 
     Files::IStreamPtr Manager::get(const std::string &name) const
     {
-        std::string normalized = name;
-        normalize_path(normalized, mStrict);
-
-        return getNormalized(normalized);
+        // The hash index normalizes while it looks up, so there is no need for a normalized copy here
+        File* file = mHashIndex.find(name);
+        if (!file)
+        {
+            std::string normalized = name;
+            normalize_path(normalized, mStrict);
+            throw std::runtime_error("Resource '" + normalized + "' not found");
+        }
+        return file->open();
     }
 
     Files::IStreamPtr Manager::getNormalized(const std::string &normalizedName) const
     {
-        std::map<std::string, File*>::const_iterator found = mIndex.find(normalizedName);
-        if (found == mIndex.end())
+        File* file = mHashIndex.find(normalizedName);
+        if (!file)
             throw std::runtime_error("Resource '" + normalizedName + "' not found");
-        return found->second->open();
+        return file->open();
     }
 
     bool Manager::exists(const std::string &name) const
     {
-        std::string normalized = name;
-        normalize_path(normalized, mStrict);
-
-        return mIndex.find(normalized) != mIndex.end();
+        return mHashIndex.find(name) != nullptr;
     }
 
     const std::map<std::string, File*>& Manager::getIndex() const
@@ -6,6 +6,8 @@
 #include <vector>
 #include <map>
 
+#include "hashindex.hpp"
+
 namespace VFS
 {
 
@@ -64,6 +66,9 @@ namespace VFS
         std::vector<Archive*> mArchives;
 
         std::map<std::string, File*> mIndex;
+
+        /// Hashed view of mIndex used for lookups by name
+        HashIndex mHashIndex;
     };
 
 }